@@ -0,0 +1,247 @@
+package main
+
+import (
+	"bufio"
+	"bytes"
+	"encoding/binary"
+	"encoding/json"
+	"fmt"
+	"io"
+	"os"
+	"path/filepath"
+	"strings"
+	"sync"
+	"unicode/utf16"
+)
+
+// 词库文件头大小，所有可编辑字段都在其中
+const headerSize = 0x1540
+
+// 官方词库的标识字节（写在 0x004 处）
+var officialMagic = []byte("DCS")
+
+// 一个文件要修改的全部字段，也是批量清单中每一行的格式（JSON）
+type headerEdit struct {
+	File     string `json:"file"`
+	ID       string `json:"id,omitempty"`
+	Name     string `json:"name,omitempty"`
+	Category string `json:"category,omitempty"`
+	Remark   string `json:"remark,omitempty"`
+	Official bool   `json:"official,omitempty"`
+}
+
+// 在内存中的文件头上应用修改，返回跳过的字段说明
+func (e headerEdit) apply(header []byte) (warnings []string) {
+	if e.Official {
+		copy(header[magicBytesStart:magicBytesEnd+1], officialMagic)
+	}
+
+	fields := []struct {
+		name       string
+		start, end int
+		value      string
+	}{
+		{"id", idStart, idEnd, e.ID},
+		{"name", nameStart, nameEnd, e.Name},
+		{"category", categoryStart, categoryEnd, e.Category},
+		{"remark", remarkStart, remarkEnd, e.Remark},
+	}
+	for _, f := range fields {
+		if !isValidString(f.value) {
+			continue
+		}
+		if w := putString(header[f.start:f.end], strings.TrimSpace(f.value)); w != "" {
+			warnings = append(warnings, fmt.Sprintf("跳过写入 %s：%s", f.name, w))
+		}
+	}
+	return warnings
+}
+
+// 把字符串按 UTF-16LE 写入字段（BMP 以外的字符编码为代理对），其余部分清零；超长时不修改并返回原因
+func putString(field []byte, input string) string {
+	units := utf16.Encode([]rune(input))
+	if len(units)*2 > len(field) {
+		return fmt.Sprintf("内容超出限制（%d > %d 字节）", len(units)*2, len(field))
+	}
+	clear(field)
+	for i, u := range units {
+		binary.LittleEndian.PutUint16(field[i*2:], u)
+	}
+	return ""
+}
+
+// 找出两份文件头不同的区间 [lo, hi)，没有不同时 lo 为 -1
+func changedRange(before, after []byte) (lo, hi int) {
+	lo, hi = -1, -1
+	for i := range after {
+		if before[i] != after[i] {
+			if lo < 0 {
+				lo = i
+			}
+			hi = i + 1
+		}
+	}
+	return lo, hi
+}
+
+/**
+ * 修改一个词库文件的头部：只读一次文件头，在内存中按顺序应用 edits 中的全部修改后一次提交。
+ *
+ * 默认用一次 pwrite 写回变化的区间并 fsync；atomic 为 true 时写出完整的新文件再改名替换，
+ * 中途崩溃时原文件保持不变（代价是复制整个文件）。
+ */
+func patchFile(path string, edits []headerEdit, atomic bool) (warnings []string, err error) {
+	f, err := os.OpenFile(path, os.O_RDWR, 0)
+	if err != nil {
+		return nil, err
+	}
+	defer f.Close()
+
+	header := make([]byte, headerSize)
+	if _, err := f.ReadAt(header, 0); err != nil {
+		if err == io.EOF {
+			return nil, fmt.Errorf("文件太短，不是有效的词库文件")
+		}
+		return nil, err
+	}
+	before := bytes.Clone(header)
+
+	for _, e := range edits {
+		warnings = append(warnings, e.apply(header)...)
+	}
+	lo, hi := changedRange(before, header)
+	if lo < 0 {
+		return warnings, nil
+	}
+
+	if atomic {
+		return warnings, replaceFile(f, path, header)
+	}
+	if _, err := f.WriteAt(header[lo:hi], int64(lo)); err != nil {
+		return warnings, err
+	}
+	return warnings, f.Sync()
+}
+
+// 写出新文件头 + 原文件其余部分到同目录的临时文件，再改名替换原文件
+func replaceFile(src *os.File, path string, header []byte) error {
+	st, err := src.Stat()
+	if err != nil {
+		return err
+	}
+	tmp, err := os.CreateTemp(filepath.Dir(path), "."+filepath.Base(path)+".*.tmp")
+	if err != nil {
+		return err
+	}
+	tmpPath := tmp.Name()
+	fail := func(err error) error {
+		tmp.Close()
+		os.Remove(tmpPath)
+		return err
+	}
+
+	if _, err := tmp.Write(header); err != nil {
+		return fail(err)
+	}
+	if _, err := io.Copy(tmp, io.NewSectionReader(src, headerSize, st.Size()-headerSize)); err != nil {
+		return fail(err)
+	}
+	if err := tmp.Chmod(st.Mode().Perm()); err != nil {
+		return fail(err)
+	}
+	if err := tmp.Sync(); err != nil {
+		return fail(err)
+	}
+	if err := tmp.Close(); err != nil {
+		os.Remove(tmpPath)
+		return err
+	}
+	if err := os.Rename(tmpPath, path); err != nil {
+		os.Remove(tmpPath)
+		return err
+	}
+	return nil
+}
+
+// 批量修改：清单每行一个 JSON 对象（格式见 headerEdit），空行和 # 开头的行忽略；
+// 同一文件（按清理后的绝对路径）的多行按清单顺序合并，交给同一个 goroutine 一次改完，
+// 不会有两个 goroutine 同时改一个文件。jobs 个 goroutine 并行处理，结果按文件在清单中
+// 第一次出现的顺序输出。返回失败的文件数
+func runBatch(manifest io.Reader, jobs int, atomic bool) (failed int, err error) {
+	type result struct {
+		file     string
+		edits    []headerEdit
+		warnings []string
+		err      error
+	}
+
+	var results []result
+	byPath := make(map[string]int) // 清理后的绝对路径 -> results 下标
+	scanner := bufio.NewScanner(manifest)
+	scanner.Buffer(make([]byte, 0, 64*1024), 1024*1024)
+	lineNo := 0
+	for scanner.Scan() {
+		lineNo++
+		line := strings.TrimSpace(scanner.Text())
+		if line == "" || strings.HasPrefix(line, "#") {
+			continue
+		}
+		var e headerEdit
+		if err := json.Unmarshal([]byte(line), &e); err != nil || e.File == "" {
+			if err == nil {
+				err = fmt.Errorf("缺少 file 字段")
+			}
+			results = append(results, result{file: fmt.Sprintf("清单第 %d 行", lineNo), err: err})
+			continue
+		}
+		key, err := filepath.Abs(e.File)
+		if err != nil {
+			results = append(results, result{file: e.File, err: err})
+			continue
+		}
+		if i, ok := byPath[key]; ok {
+			results[i].edits = append(results[i].edits, e)
+			continue
+		}
+		byPath[key] = len(results)
+		results = append(results, result{file: e.File, edits: []headerEdit{e}})
+	}
+	if err := scanner.Err(); err != nil {
+		return 0, err
+	}
+
+	if jobs < 1 {
+		jobs = 1
+	}
+	next := make(chan int)
+	var wg sync.WaitGroup
+	for w := 0; w < jobs; w++ {
+		wg.Add(1)
+		go func() {
+			defer wg.Done()
+			for i := range next {
+				r := &results[i]
+				r.warnings, r.err = patchFile(r.file, r.edits, atomic)
+			}
+		}()
+	}
+	for i := range results {
+		if results[i].err == nil {
+			next <- i
+		}
+	}
+	close(next)
+	wg.Wait()
+
+	for _, r := range results {
+		for _, w := range r.warnings {
+			fmt.Printf("%s: %s\n", r.file, w)
+		}
+		if r.err != nil {
+			fmt.Printf("%s: 修改失败：%v\n", r.file, r.err)
+			failed++
+		}
+	}
+	fmt.Printf("共处理 %d 个文件，失败 %d 个\n", len(results), failed)
+	return failed, nil
+}
@@ -0,0 +1,73 @@
+package main
+
+import (
+	"bytes"
+	"encoding/binary"
+	"fmt"
+	"os"
+	"path/filepath"
+	"strings"
+	"testing"
+	"unicode/utf16"
+)
+
+// 读出字段中的 UTF-16LE 字符串（到第一个 0 为止）
+func readField(t *testing.T, path string, start, end int) string {
+	t.Helper()
+	data, err := os.ReadFile(path)
+	if err != nil {
+		t.Fatal(err)
+	}
+	var units []uint16
+	for i := start; i+1 <= end; i += 2 {
+		u := binary.LittleEndian.Uint16(data[i:])
+		if u == 0 {
+			break
+		}
+		units = append(units, u)
+	}
+	return string(utf16.Decode(units))
+}
+
+// 清单中同一文件出现多次（路径写法不同）时按清单顺序合并，各行的修改都不丢，后面的行覆盖前面的
+func TestRunBatchSameFile(t *testing.T) {
+	dir := t.TempDir()
+	tail := []byte("词条数据")
+	var files []string
+	for i := 0; i < 8; i++ {
+		path := filepath.Join(dir, fmt.Sprintf("%d.scel", i))
+		if err := os.WriteFile(path, append(make([]byte, headerSize), tail...), 0644); err != nil {
+			t.Fatal(err)
+		}
+		files = append(files, path)
+	}
+
+	var manifest strings.Builder
+	for _, path := range files {
+		other := filepath.Join(dir, "x", "..", filepath.Base(path))
+		fmt.Fprintf(&manifest, "{\"file\":%q,\"name\":\"旧名称\",\"category\":\"分类\"}\n", path)
+		fmt.Fprintf(&manifest, "{\"file\":%q,\"remark\":\"说明\"}\n", other)
+		fmt.Fprintf(&manifest, "{\"file\":%q,\"name\":\"新名称\",\"official\":true}\n", path)
+	}
+
+	for _, atomic := range []bool{false, true} {
+		failed, err := runBatch(strings.NewReader(manifest.String()), 4, atomic)
+		if err != nil || failed != 0 {
+			t.Fatalf("atomic=%v: 失败 %d 个, %v", atomic, failed, err)
+		}
+		for _, path := range files {
+			got := []string{
+				readField(t, path, nameStart, nameEnd),
+				readField(t, path, categoryStart, categoryEnd),
+				readField(t, path, remarkStart, remarkEnd),
+			}
+			if want := []string{"新名称", "分类", "说明"}; strings.Join(got, "|") != strings.Join(want, "|") {
+				t.Errorf("atomic=%v %s: %q", atomic, path, got)
+			}
+			data, _ := os.ReadFile(path)
+			if !bytes.Equal(data[magicBytesStart:magicBytesEnd+1], officialMagic) || !bytes.Equal(data[headerSize:], tail) {
+				t.Errorf("atomic=%v %s: 标识或文件头以外的内容不对", atomic, path)
+			}
+		}
+	}
+}
@@ -1,10 +1,10 @@
 package main
 
 import (
-	"encoding/binary"
 	"flag"
 	"fmt"
 	"os"
+	"runtime"
 	"strings"
 )
 
@@ -22,70 +22,6 @@ const (
 	remarkEnd       = 0xD3F
 )
 
-// 写 magic bytes
-func writeMagicBytes(filePath string, checkedOfficial bool) {
-	if !checkedOfficial {
-		return
-	}
-	f, err := os.OpenFile(filePath, os.O_RDWR, 0644)
-	if err != nil {
-		fmt.Printf("无法打开文件: %s, 错误: %v\n", filePath, err)
-		return
-	}
-	defer f.Close()
-
-	_, err = f.Seek(magicBytesStart, 0)
-	if err != nil {
-		fmt.Printf("写入 magic bytes 失败：%v\n", err)
-		return
-	}
-
-	_, err = f.Write([]byte("DCS"))
-	if err != nil {
-		fmt.Printf("写入 magic bytes 失败：%v\n", err)
-	}
-}
-
-// 写字符串
-func writeString(filePath string, offsetStart, offsetEnd int, input string, fieldName string) {
-	size := offsetEnd - offsetStart
-	if size <= 0 {
-		fmt.Printf("跳过写入 %s：无效偏移区间（0x%X - 0x%X）\n", fieldName, offsetStart, offsetEnd)
-		return
-	}
-
-	// 转换为 UTF-16LE 编码
-	utf16Data := []byte{}
-	for _, r := range input {
-		buf := make([]byte, 2)
-		binary.LittleEndian.PutUint16(buf, uint16(r))
-		utf16Data = append(utf16Data, buf...)
-	}
-
-	if len(utf16Data) > size {
-		fmt.Printf("跳过写入 %s：内容超出限制（%d > %d 字节）\n", fieldName, len(utf16Data), size)
-		return
-	}
-
-	f, err := os.OpenFile(filePath, os.O_RDWR, 0644)
-	if err != nil {
-		fmt.Printf("写入 %s 失败：%v\n", fieldName, err)
-		return
-	}
-	defer f.Close()
-
-	// 清空该区域
-	_, _ = f.Seek(int64(offsetStart), 0)
-	_, _ = f.Write(make([]byte, size))
-
-	// 再写入实际数据
-	_, _ = f.Seek(int64(offsetStart), 0)
-	_, err = f.Write(utf16Data)
-	if err != nil {
-		fmt.Printf("写入 %s 失败：%v\n", fieldName, err)
-	}
-}
-
 func isValidString(s string) bool {
 	return strings.TrimSpace(s) != ""
 }
@@ -98,6 +34,9 @@ func main() {
 	category := flag.String("category", "", "词库类别")
 	remark := flag.String("remark", "", "词库备注")
 	official := flag.Bool("official", false, "标记为官方词库")
+	batch := flag.String("batch", "", "批量修改清单（每行一个 JSON 对象，- 表示标准输入）")
+	jobs := flag.Int("j", runtime.NumCPU(), "批量修改时的并发数")
+	atomic := flag.Bool("atomic", false, "写出完整新文件后改名替换（默认只写回文件头中变化的部分）")
 
 	// 手动处理短参数映射
 	for i, arg := range os.Args {
@@ -114,6 +53,8 @@ func main() {
 			os.Args[i] = "--remark"
 		case "-o":
 			os.Args[i] = "--official"
+		case "-b":
+			os.Args[i] = "--batch"
 		}
 	}
 
@@ -127,6 +68,11 @@ func main() {
 		fmt.Println("  -c, --category <字符串>  词库类别")
 		fmt.Println("  -r, --remark <字符串>    词库备注")
 		fmt.Println("  -o, --official           标记为官方词库")
+		fmt.Println("  -b, --batch <清单>       批量修改，清单每行一个 JSON 对象，例如")
+		fmt.Println("                           {\"file\":\"a.scel\",\"name\":\"名称\",\"official\":true}")
+		fmt.Println("                           - 表示从标准输入读取")
+		fmt.Println("  -j <数量>                批量修改时的并发数（默认为核心数）")
+		fmt.Println("      --atomic             写出完整新文件后改名替换，中途中断时原文件不变")
 		fmt.Println("  -h, --help               显示帮助信息")
 	}
 
@@ -138,6 +84,28 @@ func main() {
 		os.Exit(0)
 	}
 
+	if *batch != "" {
+		manifest := os.Stdin
+		if *batch != "-" {
+			f, err := os.Open(*batch)
+			if err != nil {
+				fmt.Printf("无法打开清单：%v\n", err)
+				os.Exit(1)
+			}
+			defer f.Close()
+			manifest = f
+		}
+		failed, err := runBatch(manifest, *jobs, *atomic)
+		if err != nil {
+			fmt.Printf("读取清单失败：%v\n", err)
+			os.Exit(1)
+		}
+		if failed > 0 {
+			os.Exit(1)
+		}
+		return
+	}
+
 	if *filePath == "" {
 		flag.Usage()
 		os.Exit(1)
@@ -148,22 +116,21 @@ func main() {
 		os.Exit(1)
 	}
 
-	// 写入数据
-	writeMagicBytes(*filePath, *official)
-
-	if isValidString(*id) {
-		writeString(*filePath, idStart, idEnd, strings.TrimSpace(*id), "id")
+	// 读一次文件头，全部字段改完后一次写回
+	edit := headerEdit{
+		File:     *filePath,
+		ID:       *id,
+		Name:     *name,
+		Category: *category,
+		Remark:   *remark,
+		Official: *official,
 	}
-
-	if isValidString(*name) {
-		writeString(*filePath, nameStart, nameEnd, strings.TrimSpace(*name), "name")
+	warnings, err := patchFile(edit.File, []headerEdit{edit}, *atomic)
+	for _, w := range warnings {
+		fmt.Println(w)
 	}
-
-	if isValidString(*category) {
-		writeString(*filePath, categoryStart, categoryEnd, strings.TrimSpace(*category), "category")
-	}
-
-	if isValidString(*remark) {
-		writeString(*filePath, remarkStart, remarkEnd, strings.TrimSpace(*remark), "remark")
+	if err != nil {
+		fmt.Printf("修改失败：%v\n", err)
+		os.Exit(1)
 	}
-}
\ No newline at end of file
+}
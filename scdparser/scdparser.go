@@ -21,20 +21,45 @@ func checkFileHeader(fpath string) (string, string, error) {
 	}
 	defer f.Close()
 
-	headerBytes := make([]byte, 9)
-	if _, err := f.Read(headerBytes); err != nil {
+	headerBytes := make([]byte, 12)
+	if _, err := io.ReadFull(f, headerBytes); err != nil {
 		return "", "", err
 	}
-	headerHex := hex.EncodeToString(headerBytes)
+	headerHex := hex.EncodeToString(headerBytes[:9])
 
-	switch headerHex {
-	case "40150000d26d530101":
+	// 与 scdviewer 相同，签名的 12 字节全部比较
+	switch hex.EncodeToString(headerBytes) {
+	case "40150000d26d530101000000":
 		return "用户自定义词库", headerHex, nil
-	case "401500004443530101":
+	case "401500004443530101000000":
 		return "官方词库", headerHex, nil
-	default:
-		return "", "", fmt.Errorf("%s 似乎不是搜狗细胞词库，请检查。", fpath)
 	}
+
+	// QQ 拼音词库（.qcel）：12 字节签名整体比较，之后的布局与细胞词库一致；其余签名（包括损坏的 .scel）一律不认
+	if bytes.Equal(headerBytes, qqMagic) && isQQHeader(f) {
+		return "QQ 拼音词库", headerHex, nil
+	}
+	return "", "", fmt.Errorf("%s 似乎不是搜狗细胞词库或 QQ 拼音词库，请检查。", fpath)
+}
+
+// QQ 拼音 .qcel 的签名，首 4 字节与细胞词库相同，都是拼音表偏移 0x1540
+var qqMagic = []byte{0x40, 0x15, 0x00, 0x00, 0x44, 0x43, 0x51, 0x01, 0x01, 0x00, 0x00, 0x00}
+
+// 检查文件头中的拼音组数不超过词条数，且 0x1540 处拼音表的音节数在 1 到 65535 之间
+func isQQHeader(f *os.File) bool {
+	counts := make([]byte, 8)
+	if _, err := f.ReadAt(counts, 0x120); err != nil {
+		return false
+	}
+	if binary.LittleEndian.Uint32(counts[0:4]) > binary.LittleEndian.Uint32(counts[4:8]) {
+		return false
+	}
+	syllables := make([]byte, 4)
+	if _, err := f.ReadAt(syllables, 0x1540); err != nil {
+		return false
+	}
+	n := binary.LittleEndian.Uint32(syllables)
+	return n > 0 && n <= 0xFFFF
 }
 
 func decodeUTF16LE(buf []byte) string {
@@ -119,7 +144,7 @@ func extractTimestamp(fpath string) (string, uint32) {
 
 func main() {
 	if len(os.Args) != 2 {
-		fmt.Printf("用法: %s <搜狗细胞词库路径>\n", os.Args[0])
+		fmt.Printf("用法: %s <搜狗细胞词库或 QQ 拼音词库路径>\n", os.Args[0])
 		os.Exit(1)
 	}
 	filePath := os.Args[1]
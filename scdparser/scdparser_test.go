@@ -0,0 +1,57 @@
+package main
+
+import (
+	"os"
+	"path/filepath"
+	"testing"
+)
+
+// testdata/sample.qcel：3 个词条的小词库，只有前 12 字节签名与 .scel 不同
+const sampleQcel = "testdata/sample.qcel"
+
+// 把 sample.qcel 的签名换成 magic 后写到临时文件
+func withMagic(t *testing.T, magic []byte) string {
+	t.Helper()
+	data, err := os.ReadFile(sampleQcel)
+	if err != nil {
+		t.Fatal(err)
+	}
+	copy(data, magic)
+	path := filepath.Join(t.TempDir(), "sample.scel")
+	if err := os.WriteFile(path, data, 0644); err != nil {
+		t.Fatal(err)
+	}
+	return path
+}
+
+func TestCheckFileHeaderQcel(t *testing.T) {
+	source, _, err := checkFileHeader(sampleQcel)
+	if err != nil || source != "QQ 拼音词库" {
+		t.Fatalf("sample.qcel 识别为 %q, %v", source, err)
+	}
+
+	// 换成搜狗签名后按 .scel 识别，其余字段读出的内容相同
+	scel := withMagic(t, []byte{0x40, 0x15, 0x00, 0x00, 0xD2, 0x6D, 0x53, 0x01, 0x01, 0x00, 0x00, 0x00})
+	if source, _, err := checkFileHeader(scel); err != nil || source != "用户自定义词库" {
+		t.Fatalf("换签名后识别为 %q, %v", source, err)
+	}
+	if a, b := extractUTF16LEString(sampleQcel, 0x130, 0x337), extractUTF16LEString(scel, 0x130, 0x337); a != b || a == "" {
+		t.Errorf("词库名称 %q / %q", a, b)
+	}
+	if a, b := extractEntryCount(sampleQcel), extractEntryCount(scel); a != b || a != 3 {
+		t.Errorf("词条数 %d / %d", a, b)
+	}
+}
+
+// 签名第 4~11 字节中任何一个不对都不认，不会被当作 QQ 拼音词库放过
+func TestCheckFileHeaderCorruptSignature(t *testing.T) {
+	for i := 4; i < len(qqMagic); i++ {
+		for _, base := range [][]byte{qqMagic, {0x40, 0x15, 0x00, 0x00, 0x44, 0x43, 0x53, 0x01, 0x01, 0x00, 0x00, 0x00}} {
+			magic := append([]byte(nil), base...)
+			magic[i] ^= 0x5A
+			if source, _, err := checkFileHeader(withMagic(t, magic)); err == nil {
+				t.Errorf("签名 % x 被识别为 %q", magic, source)
+			}
+		}
+	}
+}
@@ -1,14 +1,17 @@
 #include "FileHandler.h"
+#include "TaskMonitor.h"
 #include <QFileDialog>
 #include <QStandardPaths>
 #include <QProcess>
 #include <QFile>
 #include <QFileInfo>
+#include <QPointer>
 #include <QTextEdit>
 #include <QTextCursor>
 #include <QTextCharFormat>
 #include <QColor>
 #include <QUrl>
+#include <memory>
 
 QUrl FileHandler::chooseTxtFile(QWidget *parent) {
     QUrl url = QFileDialog::getOpenFileUrl(
@@ -62,112 +65,105 @@ void FileHandler::jumpToFile(const QUrl &fileUrl) {
     }
 }
 
-std::pair<bool,bool> FileHandler::checkSogouHeader(const QString &filePath) {
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qDebug() << "无法打开文件:" << filePath;
-        return {false, false};
-    }
-
-    QByteArray header = file.read(12);  // 读取前12字节
-    file.close();
-
-    if (header.size() < 12) {
-        qDebug() << "文件太短，无法读取完整文件头";
-        return {false, false};
-    }
-
-    QByteArray prefix = header.left(4);       // 前4字节
-    QByteArray middle = header.mid(4, 2);     // 第5-6字节
-    QByteArray suffix = header.mid(6, 6);     // 第7-12字节
-
-    QByteArray expectedPrefix = QByteArray::fromHex("40150000");
-    QByteArray expectedSuffix = QByteArray::fromHex("530101000000");  // 6字节
-
-    if (prefix != expectedPrefix || suffix != expectedSuffix) {
-        return {false, false};
-    }
-
-    bool isOfficial = (middle == QByteArray::fromHex("4443"));
-    return {true, isOfficial};
+// 以指定颜色追加到末尾并滚动到末尾
+void FileHandler::appendText(QTextEdit *outputWidget, const QString &text, const QColor &color) {
+    QTextCharFormat fmt;
+    fmt.setForeground(color);
+    QTextCursor cursor(outputWidget->document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.setCharFormat(fmt);
+    cursor.insertText(text);
+    outputWidget->moveCursor(QTextCursor::End);
 }
 
-
 // 异步执行 CLI 并输出到 QTextEdit
-void FileHandler::runCliTool(const QString &toolPath, const QStringList &arguments, QTextEdit *outputWidget, QWidget *parent) {
-    if (toolPath.isEmpty()) {
-        outputWidget->append("错误: 工具路径为空");
-        return;
-    }
-    if (!QFile::exists(toolPath)) {
-        outputWidget->append("错误: 工具不存在：" + toolPath);
+void FileHandler::runCliTool(const QString &toolPath, const QStringList &arguments, QTextEdit *outputWidget, QWidget *parent,
+                             const std::function<void(const SCDStats &)> &statsHandler, TaskMonitor *monitor) {
+    if (toolPath.isEmpty() || !QFile::exists(toolPath)) {
+        outputWidget->append(toolPath.isEmpty() ? "错误: 工具路径为空" : "错误: 工具不存在：" + toolPath);
+        if (monitor) {
+            monitor->finish(false);
+        }
         return;
     }
 
     auto process = new QProcess(parent);
+    QPointer<TaskMonitor> task(monitor);
 
-    auto appendText = [outputWidget](const QString &text, const QColor &color = Qt::black) {
-        QTextCharFormat fmt;
-        fmt.setForeground(color);
-        QTextCursor cursor(outputWidget->document());
-        cursor.movePosition(QTextCursor::End);
-        cursor.setCharFormat(fmt);
-        cursor.insertText(text);
-        outputWidget->moveCursor(QTextCursor::End);
+    // 有 monitor 时由它按帧写入，否则每块数据直接插入
+    auto appendText = [outputWidget, task](const QString &text, const QColor &color = Qt::black) {
+        if (task) {
+            task->append(text, color);
+        } else {
+            FileHandler::appendText(outputWidget, text, color);
+        }
     };
+    if (monitor) {
+        // txtmaker 和 scdviewer 收到 SIGTERM 时删除写了一半的输出文件后退出
+        monitor->setCancelHandler([process]() { process->terminate(); });
+    }
 
     QObject::connect(process, &QProcess::readyReadStandardOutput, [=]() {
         QByteArray data = process->readAllStandardOutput();
         appendText(QString::fromLocal8Bit(data), Qt::black);
     });
 
+    // 标准错误显示为红色；有 statsHandler 或 monitor 时按行处理，统计行和进度行不显示，不完整的行留到下次
+    const bool lineMode = statsHandler || monitor;
+    auto pendingError = std::make_shared<QByteArray>();
+    auto handleError = [=](bool flushAll) {
+        qsizetype lineEnd;
+        while ((lineEnd = pendingError->indexOf('\n')) >= 0 || (flushAll && !pendingError->isEmpty())) {
+            const QByteArray line = lineEnd >= 0 ? pendingError->left(lineEnd + 1) : *pendingError;
+            pendingError->remove(0, line.size());
+            SCDStats stats;
+            if (task && task->progress() && SCDProgress::fromJson(line, task->progress())) {
+                continue;
+            }
+            if (statsHandler && SCDStats::fromJson(line, &stats)) {
+                statsHandler(stats);
+            } else {
+                appendText(QString::fromLocal8Bit(line), Qt::red);
+            }
+        }
+    };
+
     QObject::connect(process, &QProcess::readyReadStandardError, [=]() {
         QByteArray data = process->readAllStandardError();
-        appendText(QString::fromLocal8Bit(data), Qt::red);
+        if (!lineMode) {
+            appendText(QString::fromLocal8Bit(data), Qt::red);
+            return;
+        }
+        pendingError->append(data);
+        handleError(false);
     });
 
     QObject::connect(process, QOverload<int, QProcess::ExitStatus>::of(&QProcess::finished),
                      [=](int exitCode, QProcess::ExitStatus exitStatus) {
-        if (exitStatus == QProcess::NormalExit && exitCode == 0) {
+        if (lineMode) {
+            pendingError->append(process->readAllStandardError());
+            handleError(true);
+        }
+        const bool success = exitStatus == QProcess::NormalExit && exitCode == 0;
+        if (success) {
             appendText("\n命令执行完成。\n", Qt::darkGreen);
+        } else if (task && task->progress() && task->progress()->isCanceled()) {
+            appendText("\n任务已取消。\n", Qt::red);
         } else {
             appendText(QString("\n命令异常退出，退出码：%1\n").arg(exitCode), Qt::red);
         }
+        if (task) {
+            task->finish(success);
+        }
         process->deleteLater();
     });
 
     process->start(toolPath, arguments);
     if (!process->waitForStarted()) {
         appendText("错误: 无法启动命令\n", Qt::red);
+        if (task) {
+            task->finish(false);
+        }
         process->deleteLater();
     }
 }
-
-// 同步执行 CLI 并返回输出
-QString FileHandler::runCliToolSync(const QString &toolPath, const QStringList &arguments) {
-    if (toolPath.isEmpty() || !QFile::exists(toolPath)) {
-        return QString("错误: 工具不存在或路径为空: %1").arg(toolPath);
-    }
-
-    QProcess process;
-    process.start(toolPath, arguments);
-    if (!process.waitForStarted()) {
-        return QString("错误: 无法启动命令 %1").arg(toolPath);
-    }
-
-    if (!process.waitForFinished(-1)) {
-        return QString("错误: 命令执行超时或异常退出: %1").arg(toolPath);
-    }
-
-    QByteArray stdOut = process.readAllStandardOutput();
-    QByteArray stdErr = process.readAllStandardError();
-
-    QString output = QString::fromLocal8Bit(stdOut);
-    QString error = QString::fromLocal8Bit(stdErr);
-
-    if (!error.isEmpty()) {
-        output += "\n[ERROR]: " + error;
-    }
-
-    return output;
-}
@@ -3,8 +3,13 @@
 
 #include <QWidget>
 #include <QTextEdit>
+#include <QColor>
 #include <QStringList>
 #include <QUrl>
+#include <functional>
+#include "SCDStats.h"
+
+class TaskMonitor;
 
 namespace FileHandler {
 
@@ -20,19 +25,19 @@ namespace FileHandler {
     // 跳转到文件所在目录（QUrl 或 QString 均可）
     void jumpToFile(const QUrl &fileUrl);
 
-    // 验证搜狗词库文件头
-    // 返回 pair：{是否有效词库, 是否官方词库}
-    std::pair<bool, bool> checkSogouHeader(const QString &filePath);
+    // 以指定颜色把文本追加到 QTextEdit 末尾
+    void appendText(QTextEdit *outputWidget, const QString &text, const QColor &color = Qt::black);
 
-    // 异步运行 CLI 工具并输出到 QTextEdit
+    // 异步运行 CLI 工具并输出到 QTextEdit；
+    // 给出 statsHandler 时，标准错误中的统计行（--stats=json）交给它处理，不显示在输出中；
+    // 给出 monitor 时（调用方已 begin()），输出经它按帧写入，进度行（-progress）更新它的进度对象，
+    // 取消时结束子进程，进程退出后调用 finish()
     void runCliTool(const QString &toolPath,
                     const QStringList &arguments,
                     QTextEdit *outputWidget,
-                    QWidget *parent = nullptr);
-
-    // 同步运行 CLI 工具，返回输出字符串
-    QString runCliToolSync(const QString &toolPath,
-                           const QStringList &arguments);
+                    QWidget *parent = nullptr,
+                    const std::function<void(const SCDStats &)> &statsHandler = nullptr,
+                    TaskMonitor *monitor = nullptr);
 
 }
 
@@ -0,0 +1,245 @@
+#include "JobServer.h"
+#include "FileHandler.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QLocalSocket>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <memory>
+#include <utility>
+
+namespace {
+
+// 与 txtmaker/server.go 一致
+constexpr quint8 opConvert = 1;
+constexpr quint8 flagProgress = 1 << 1;
+constexpr int requestHeaderSize = 12;
+
+constexpr quint8 frameOutput = 1;
+constexpr quint8 frameError = 2;
+constexpr quint8 frameStats = 3;
+constexpr quint8 frameDone = 4;
+constexpr quint8 frameProgress = 5;
+
+QByteArray convertRequest(const QString &inputPath) {
+    const QByteArray path = inputPath.toUtf8();
+    QByteArray request(4 + requestHeaderSize, '\0');
+    uchar *p = reinterpret_cast<uchar *>(request.data());
+    qToLittleEndian<quint32>(static_cast<quint32>(requestHeaderSize + path.size()), p);
+    p[4] = opConvert;
+    p[5] = flagProgress;
+    // 内存预算为 0（不排序），并发数为 0（由服务取核心数）
+    request.append(path);
+    return request;
+}
+
+} // namespace
+
+JobServer::JobServer(const QString &toolPath, QObject *parent)
+    : QObject(parent), m_toolPath(toolPath) {
+    m_socketPath = QStandardPaths::writableLocation(QStandardPaths::RuntimeLocation)
+                   + QString("/scdtool-%1.sock").arg(QCoreApplication::applicationPid());
+}
+
+JobServer::~JobServer() {
+    if (m_process) {
+        // 关闭标准输入，服务删除套接字后退出
+        m_process->disconnect(this);
+        m_process->closeWriteChannel();
+        if (!m_process->waitForFinished(1000)) {
+            m_process->kill();
+        }
+    }
+}
+
+void JobServer::convert(const QString &inputPath, TaskMonitor *monitor,
+                        const std::function<void(const SCDStats &)> &statsHandler) {
+    const Job job{inputPath, monitor, statsHandler};
+    switch (m_state) {
+    case State::Ready:
+        send(job);
+        break;
+    case State::Starting:
+        m_pending.append(job);
+        break;
+    case State::Stopped:
+        m_pending.append(job);
+        start();
+        break;
+    }
+}
+
+void JobServer::start() {
+    if (!QFile::exists(m_toolPath)) {
+        stopped();
+        return;
+    }
+
+    m_state = State::Starting;
+    m_process = new QProcess(this);
+    m_process->setProcessChannelMode(QProcess::ForwardedErrorChannel);
+
+    // 服务开始监听后输出一行 ready
+    connect(m_process, &QProcess::readyReadStandardOutput, this, [this]() {
+        if (m_state == State::Starting && m_process->readAllStandardOutput().contains("ready")) {
+            m_state = State::Ready;
+            const QList<Job> pending = std::exchange(m_pending, {});
+            for (const Job &job : pending) {
+                send(job);
+            }
+        }
+    });
+    connect(m_process, &QProcess::finished, this, &JobServer::stopped);
+    connect(m_process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart) {
+            stopped();
+        }
+    });
+
+    m_process->start(m_toolPath, QStringList() << "-serve" << m_socketPath);
+}
+
+// 服务没有启动或已经退出：等待中的任务改为直接运行，下次提交时重新启动服务
+void JobServer::stopped() {
+    if (m_process) {
+        m_process->disconnect(this);
+        m_process->deleteLater();
+        m_process = nullptr;
+    }
+    m_state = State::Stopped;
+    const QList<Job> pending = std::exchange(m_pending, {});
+    for (const Job &job : pending) {
+        runDirect(job);
+    }
+}
+
+// 服务启动期间点了取消：不再发出，直接结束
+bool JobServer::canceledBeforeStart(const Job &job) {
+    if (!job.monitor) {
+        return true;
+    }
+    if (job.monitor->progress() && job.monitor->progress()->isCanceled()) {
+        job.monitor->append("\n任务已取消。\n", Qt::red);
+        job.monitor->finish(false);
+        return true;
+    }
+    return false;
+}
+
+void JobServer::send(const Job &job) {
+    if (canceledBeforeStart(job)) {
+        return;
+    }
+
+    // 连接上的状态：未处理完的数据、是否收到过响应、是否已收到结束帧
+    struct Connection {
+        QByteArray buffer;
+        bool answered = false;
+        bool done = false;
+    };
+    auto socket = new QLocalSocket(this);
+    auto connection = std::make_shared<Connection>();
+
+    // 连接建立之前取消的，在请求之后紧接着发
+    QPointer<QLocalSocket> target(socket);
+    job.monitor->setCancelHandler([target]() {
+        if (target && target->state() == QLocalSocket::ConnectedState) {
+            target->write(QByteArray(1, '\0'));
+        }
+    });
+
+    connect(socket, &QLocalSocket::connected, socket, [socket, job]() {
+        socket->write(convertRequest(job.inputPath));
+        if (job.monitor && job.monitor->progress() && job.monitor->progress()->isCanceled()) {
+            socket->write(QByteArray(1, '\0'));
+        }
+    });
+
+    // 按帧处理，不完整的帧留到下次
+    connect(socket, &QLocalSocket::readyRead, socket, [socket, connection, job]() {
+        QByteArray &buffer = connection->buffer;
+        buffer.append(socket->readAll());
+        connection->answered = true;
+        while (!connection->done && buffer.size() >= 4) {
+            const quint32 size = qFromLittleEndian<quint32>(buffer.constData());
+            if (buffer.size() < 4 + static_cast<qsizetype>(size)) {
+                break;
+            }
+            const QByteArray frame = buffer.mid(4, size);
+            buffer.remove(0, 4 + size);
+            connection->done = handleFrame(job, frame);
+        }
+        if (connection->done) {
+            socket->disconnectFromServer();
+        }
+    });
+
+    // 还没收到任何响应就失败：服务已不可用，这个任务改为直接运行
+    connect(socket, &QLocalSocket::errorOccurred, this, [this, socket, connection, job](QLocalSocket::LocalSocketError) {
+        // 收到结束帧后服务关闭连接，不算错误
+        if (!connection->done && !connection->answered) {
+            runDirect(job);
+            if (m_state == State::Ready) {
+                stopped();
+            }
+        } else if (!connection->done && job.monitor) {
+            job.monitor->append("\n与任务服务的连接中断\n", Qt::red);
+            job.monitor->finish(false);
+        }
+        socket->deleteLater();
+    });
+    connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+
+    socket->connectToServer(m_socketPath);
+}
+
+bool JobServer::handleFrame(const Job &job, const QByteArray &frame) {
+    if (frame.isEmpty() || !job.monitor) {
+        return !frame.isEmpty() && static_cast<quint8>(frame[0]) == frameDone;
+    }
+    TaskMonitor *monitor = job.monitor;
+    const QByteArray payload = frame.mid(1);
+    switch (static_cast<quint8>(frame[0])) {
+    case frameOutput:
+        monitor->append(QString::fromUtf8(payload), Qt::black);
+        return false;
+    case frameError:
+        monitor->append(QString::fromUtf8(payload), Qt::red);
+        return false;
+    case frameProgress:
+        if (monitor->progress()) {
+            SCDProgress::fromJson(payload, monitor->progress());
+        }
+        return false;
+    case frameStats: {
+        SCDStats stats;
+        if (job.statsHandler && SCDStats::fromJson(payload, &stats)) {
+            job.statsHandler(stats);
+        }
+        return false;
+    }
+    case frameDone: {
+        const qint32 exitCode = payload.size() >= 4 ? qFromLittleEndian<qint32>(payload.constData()) : -1;
+        if (exitCode == 0) {
+            monitor->append("\n命令执行完成。\n", Qt::darkGreen);
+        } else if (monitor->progress() && monitor->progress()->isCanceled()) {
+            monitor->append("\n任务已取消。\n", Qt::red);
+        } else {
+            monitor->append(QString("\n命令异常退出，退出码：%1\n").arg(exitCode), Qt::red);
+        }
+        monitor->finish(exitCode == 0);
+        return true;
+    }
+    default:
+        return false;
+    }
+}
+
+void JobServer::runDirect(const Job &job) {
+    if (canceledBeforeStart(job) || !job.monitor->output()) {
+        return;
+    }
+    QTextEdit *output = job.monitor->output();
+    FileHandler::runCliTool(m_toolPath, QStringList() << "-stats=json" << "-progress" << job.inputPath, output,
+                            output->window(), job.statsHandler, job.monitor);
+}
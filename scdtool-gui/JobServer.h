@@ -0,0 +1,61 @@
+#ifndef JOBSERVER_H
+#define JOBSERVER_H
+
+#include <QObject>
+#include <QPointer>
+#include <QProcess>
+#include <QString>
+#include <QList>
+#include <functional>
+#include "SCDStats.h"
+#include "TaskMonitor.h"
+
+/**
+ * 常驻 txtmaker 任务服务（txtmaker -serve）的客户端
+ *
+ * 第一次提交任务时启动服务进程，之后的转换都通过 Unix 域套接字发给同一个进程，
+ * 拼音库和覆盖规则不再每次点击都重新加载。每个任务一个连接，可同时进行多个。
+ * 服务进程的标准输入由本对象持有，界面退出时管道关闭，服务随之退出。
+ * 服务无法启动或连接失败时退回到每次启动一个 txtmaker 进程（FileHandler::runCliTool）。
+ * 输出和进度帧交给任务的 TaskMonitor；取消时在连接上再发一个字节，服务删除临时文件后回复结束帧。
+ * 帧格式见 txtmaker/server.go。
+ */
+class JobServer : public QObject {
+    Q_OBJECT
+
+public:
+    explicit JobServer(const QString &toolPath, QObject *parent = nullptr);
+    ~JobServer() override;
+
+    // 转换中文文本为搜狗文本词库：monitor 须已 begin()，输出和进度交给它，统计交给 statsHandler，结束时调用 monitor->finish()
+    void convert(const QString &inputPath, TaskMonitor *monitor,
+                 const std::function<void(const SCDStats &)> &statsHandler);
+
+private:
+    struct Job {
+        QString inputPath;
+        QPointer<TaskMonitor> monitor;
+        std::function<void(const SCDStats &)> statsHandler;
+    };
+
+    enum class State { Stopped, Starting, Ready };
+
+    void start();
+    void stopped();
+    void send(const Job &job);
+    void runDirect(const Job &job);
+
+    // 任务在发出之前已被取消
+    static bool canceledBeforeStart(const Job &job);
+
+    // 处理一个响应帧，收到结束帧时返回 true
+    static bool handleFrame(const Job &job, const QByteArray &frame);
+
+    QString m_toolPath;
+    QString m_socketPath;
+    QProcess *m_process = nullptr;
+    State m_state = State::Stopped;
+    QList<Job> m_pending; // 服务启动期间提交的任务
+};
+
+#endif // JOBSERVER_H
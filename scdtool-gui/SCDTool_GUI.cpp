@@ -1,10 +1,17 @@
 #include "SCDTool_GUI.h"
 #include "ui_SCDTool_GUI.h"
 #include "FileHandler.h"
+#include "JobServer.h"
+#include "TaskMonitor.h"
+#include "SCDInfoRead.h"
+#include "SCDWriter.h"
+#include "SCDSearchIndex.h"
 #include <QMessageBox>
-#include <QJsonDocument>
-#include <QJsonObject>
+#include <QElapsedTimer>
 #include <QCoreApplication>
+#include <QFileInfo>
+#include <QFontDatabase>
+#include <QtConcurrent>
 
 SCDTool_GUI::SCDTool_GUI(QWidget *parent)
     : QMainWindow(parent), ui(new Ui::SCDTool_GUI) {
@@ -18,11 +25,45 @@ SCDTool_GUI::SCDTool_GUI(QWidget *parent)
     ui->infoRadioOther->setEnabled(false);
     ui->infoResult->setReadOnly(true);
 
+    // 统计面板按列对齐，用等宽字体
+    const QFont fixedFont = QFontDatabase::systemFont(QFontDatabase::FixedFont);
+    ui->txtStats->setFont(fixedFont);
+    ui->scdStats->setFont(fixedFont);
+
+    txtMonitor = new TaskMonitor(ui->txtResult, ui->txtProgress, ui->txtButtonCancel, this);
+    scdMonitor = new TaskMonitor(ui->scdResult, ui->scdProgress, ui->scdButtonCancel, this);
+
     // 设置 tabTXTMake 为默认显示的 tab
     ui->tabGroup->setCurrentWidget(ui->tabTXTMake);
 
     setAcceptDrops(true);
     initToolPaths();
+
+    // 词库信息在线程池中解析，结果通过信号回到界面线程
+    infoWatcher = new QFutureWatcher<SCDInfo>(this);
+    connect(infoWatcher, &QFutureWatcher<SCDInfo>::finished, this, [this]() {
+        emit scdInfoParsed(parsingFilePath, infoWatcher->result());
+    });
+    connect(this, &SCDTool_GUI::scdInfoParsed, this, &SCDTool_GUI::onScdInfoParsed);
+
+    // 细胞词库在进程内生成，不再调用 scdmaker
+    makeWatcher = new QFutureWatcher<MakeResult>(this);
+    connect(makeWatcher, &QFutureWatcher<MakeResult>::finished, this, [this]() {
+        const MakeResult result = makeWatcher->result();
+        scdMonitor->append("\n" + result.message, result.success ? Qt::black : Qt::red);
+        scdMonitor->finish(result.success);
+        ui->scdStats->setPlainText(result.stats.toText());
+        ui->scdButtonMake->setEnabled(true);
+    });
+
+    // 词库查找：首次查找时建立或载入索引，之后的查找只查索引
+    searchIndex = std::make_shared<SCDSearchIndex>();
+    searchWatcher = new QFutureWatcher<QString>(this);
+    connect(searchWatcher, &QFutureWatcher<QString>::finished, this, [this]() {
+        ui->searchResult->setPlainText(searchWatcher->result());
+        ui->searchButtonSearch->setEnabled(true);
+    });
+    connect(ui->searchLineQuery, &QLineEdit::returnPressed, this, &SCDTool_GUI::on_searchButtonSearch_clicked);
 }
 
 SCDTool_GUI::~SCDTool_GUI() {
@@ -35,9 +76,9 @@ void SCDTool_GUI::initToolPaths() {
 
     // 使用相对路径初始化工具路径
     toolTxtMaker  = appDir + "/txtmaker";
-    toolScdMaker  = appDir + "/scdmaker";
-    toolScdParser = appDir + "/scdparser";
     toolScdEditor = appDir + "/scdeditor";
+
+    txtJobServer = new JobServer(toolTxtMaker, this);
 }
 
 void SCDTool_GUI::dragEnterEvent(QDragEnterEvent *event) {
@@ -59,8 +100,14 @@ void SCDTool_GUI::on_txtButtonChooseFile_clicked() {
 
 void SCDTool_GUI::on_txtButtonConvert_clicked() {
     QString txtFilePath = ui->txtLineChooseFile->text();
+    if (txtMonitor->isRunning()) {
+        return;
+    }
     ui->txtResult->clear();
-    FileHandler::runCliTool(toolTxtMaker, QStringList() << txtFilePath, ui->txtResult, this);
+    ui->txtStats->clear();
+    txtMonitor->begin();
+    txtJobServer->convert(txtFilePath, txtMonitor,
+                          [this](const SCDStats &stats) { ui->txtStats->setPlainText(stats.toText()); });
 }
 
 void SCDTool_GUI::on_txtButtonOpenDir_clicked() {
@@ -76,8 +123,43 @@ void SCDTool_GUI::on_scdButtonChooseFile_clicked() {
 
 void SCDTool_GUI::on_scdButtonMake_clicked() {
     QString sgTextFilePath = ui->scdLineChooseFile->text();
+    if (sgTextFilePath.isEmpty()) {
+        QMessageBox::warning(this, tr("警告"), tr("请选择搜狗文本词库"));
+        return;
+    }
+    if (makeWatcher->isRunning()) {
+        return;
+    }
+
     ui->scdResult->clear();
-    FileHandler::runCliTool(toolScdMaker, QStringList() << sgTextFilePath, ui->scdResult, this);
+    ui->scdStats->clear();
+    ui->scdResult->append(tr("开始生成细胞词库..."));
+    ui->scdButtonMake->setEnabled(false);
+
+    // 进度对象由工作线程和界面共同持有，取消按钮只设置其中的标志
+    std::shared_ptr<SCDProgress> progress = scdMonitor->begin();
+
+    QFileInfo txtInfo(sgTextFilePath);
+    QString scelPath = txtInfo.path() + "/" + txtInfo.completeBaseName() + ".scel";
+    makeWatcher->setFuture(QtConcurrent::run([sgTextFilePath, scelPath, progress]() {
+        QElapsedTimer timer;
+        timer.start();
+        SCDWriter writer;
+        writer.setProgress(progress.get());
+        if (writer.addTextFile(sgTextFilePath) < 0 || !writer.write(scelPath)) {
+            return MakeResult{QString("生成失败：%1").arg(writer.errorString()), writer.stats(), false};
+        }
+        QString message = QString("生成细胞词库：%1\n拼音组数量：%2，词条数量：%3")
+                              .arg(QFileInfo(scelPath).absoluteFilePath())
+                              .arg(writer.groupCount())
+                              .arg(writer.phraseCount());
+        if (writer.skippedCount() > 0) {
+            message += QString("\n跳过无法识别的行：%1").arg(writer.skippedCount());
+        }
+        SCDStats stats = writer.stats();
+        stats.setTotal(timer.nsecsElapsed());
+        return MakeResult{message, stats, true};
+    }));
 }
 
 void SCDTool_GUI::on_scdButtonOpenDir_clicked() {
@@ -100,25 +182,47 @@ void SCDTool_GUI::on_infoButtonParse_clicked() {
         return;
     }
 
-    // 使用新函数，返回 pair<bool,bool>
-    auto [isValidFile, isOfficialFile] = FileHandler::checkSogouHeader(scelPath);
+    // 上一次解析尚未结束
+    if (infoWatcher->isRunning()) {
+        return;
+    }
+
+    ui->infoResult->clear();
+    ui->infoResult->append(tr("开始解析词库..."));
+    ui->infoButtonParse->setEnabled(false);
+
+    // 文件读取全部放到后台，界面线程不做任何 I/O
+    parsingFilePath = scelPath;
+    infoWatcher->setFuture(QtConcurrent::run([scelPath]() {
+        return SCDInfoRead::readSCDInfo(scelPath);
+    }));
+}
 
-    if (!isValidFile) {
+void SCDTool_GUI::onScdInfoParsed(const QString &filePath, const SCDInfo &info) {
+    ui->infoButtonParse->setEnabled(true);
+
+    // 解析期间用户已切换了文件
+    if (filePath != ui->infoLineChooseFile->text()) {
+        ui->infoResult->append(tr("文件已更换，忽略上一次解析结果"));
+        return;
+    }
+
+    if (!info.isValid) {
+        ui->infoResult->append(info.allInformation);
         QMessageBox::warning(this, tr("错误"), tr("文件头不正确，这似乎不是有效的搜狗细胞词库文件"));
         return;
     }
 
-    ui->infoResult->clear();
-    ui->infoResult->append(tr("文件头检测通过，开始解析词库..."));
+    ui->infoResult->append(tr("文件头检测通过"));
 
     // Radiobutton 只读
-    ui->infoRadioOfficial->setChecked(isOfficialFile);
+    ui->infoRadioOfficial->setChecked(info.isOfficial);
     ui->infoRadioOfficial->setEnabled(false);
-    ui->infoRadioOther->setChecked(!isOfficialFile);
+    ui->infoRadioOther->setChecked(!info.isOfficial);
     ui->infoRadioOther->setEnabled(false);
 
     // Checkbox
-    if (isOfficialFile) {
+    if (info.isOfficial) {
         ui->infoCheckBoxOfficial->setChecked(false);  // 不勾选
         ui->infoCheckBoxOfficial->setEnabled(false);  // 禁用
     } else {
@@ -126,23 +230,11 @@ void SCDTool_GUI::on_infoButtonParse_clicked() {
         ui->infoCheckBoxOfficial->setEnabled(true);   // 可编辑
     }
 
-    // 执行 CLI 工具同步解析
-    QString output = FileHandler::runCliToolSync(toolScdParser, QStringList() << scelPath);
-
-    QJsonParseError jsonError;
-    QJsonDocument doc = QJsonDocument::fromJson(output.toUtf8(), &jsonError);
-    if (jsonError.error != QJsonParseError::NoError) {
-        ui->infoResult->append(tr("解析失败: %1").arg(jsonError.errorString()));
-        return;
-    }
-
-    QJsonObject obj = doc.object();
-
     // 填充 UI
-    ui->infoLineDictId->setText(obj.value("id").toString());
-    ui->infoLineDictName->setText(obj.value("name").toString());
-    ui->infoLineCategory->setText(obj.value("category").toString());
-    ui->infoLineDictRemark->setText(obj.value("remark").toString());
+    ui->infoLineDictId->setText(info.id);
+    ui->infoLineDictName->setText(info.name);
+    ui->infoLineCategory->setText(info.category);
+    ui->infoLineDictRemark->setText(info.remark);
 
     // 保存原始值
     originalDictId = ui->infoLineDictId->text();
@@ -156,6 +248,60 @@ void SCDTool_GUI::on_infoButtonParse_clicked() {
 
 
 
+// 词库查找按钮
+void SCDTool_GUI::on_searchButtonChooseFile_clicked() {
+    QUrl fileUrl = FileHandler::chooseSCDFile(this);
+    ui->searchLineChooseFile->setText(fileUrl.toLocalFile());
+}
+
+void SCDTool_GUI::on_searchButtonSearch_clicked() {
+    QString scelPath = ui->searchLineChooseFile->text();
+    QString query = ui->searchLineQuery->text().trimmed();
+    if (scelPath.isEmpty()) {
+        QMessageBox::warning(this, tr("警告"), tr("请选择词库文件"));
+        return;
+    }
+    if (query.isEmpty() || searchWatcher->isRunning()) {
+        return;
+    }
+
+    ui->searchButtonSearch->setEnabled(false);
+    if (searchIndex->scelPath() != scelPath) {
+        ui->searchResult->setPlainText(tr("正在载入词库索引..."));
+    }
+
+    // 同一时间只有一个查找在运行，索引对象不会被并发访问
+    std::shared_ptr<SCDSearchIndex> index = searchIndex;
+    searchWatcher->setFuture(QtConcurrent::run([index, scelPath, query]() {
+        QElapsedTimer timer;
+        timer.start();
+        QString message;
+        if (index->scelPath() != scelPath) {
+            bool rebuilt = false;
+            if (!index->open(scelPath, &rebuilt)) {
+                return QString("打开词库失败：%1").arg(index->errorString());
+            }
+            message += QString("%1 %2 ms，共 %3 条\n")
+                           .arg(rebuilt ? "建立索引" : "载入索引")
+                           .arg(timer.restart())
+                           .arg(index->entryCount());
+        }
+
+        const int limit = 500;
+        qint64 total = 0;
+        const QList<QByteArray> lines = index->search(query, limit, &total);
+        message += QString("匹配 %1 条，查找 %2 ms").arg(total).arg(timer.elapsed());
+        if (total > lines.size()) {
+            message += QString("，显示前 %1 条").arg(lines.size());
+        }
+        message += "\n";
+        for (const QByteArray &line : lines) {
+            message += "\n" + QString::fromUtf8(line);
+        }
+        return message;
+    }));
+}
+
 // 修改词库信息
 void SCDTool_GUI::on_infoButtonModify_clicked() {
     QString scdFilePath = ui->infoLineChooseFile->text();
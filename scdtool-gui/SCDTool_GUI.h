@@ -12,20 +12,19 @@
 #include <QMimeData>
 #include <QDragEnterEvent>
 #include <QUrl>
-#include <QByteArray>
-#include <QFile>
+#include <QFutureWatcher>
+#include <memory>
+#include "SCDInfoRead.h"
+#include "SCDStats.h"
+
+class SCDSearchIndex;
+class JobServer;
+class TaskMonitor;
 
 namespace Ui {
     class SCDTool_GUI;
 }
 
-// 文件头三段结构
-struct FileHeaderSegment {
-    QByteArray prefix;   // 前段固定字节
-    QByteArray variable; // 中段可变字节
-    QByteArray suffix;   // 后段固定字节
-};
-
 class SCDTool_GUI : public QMainWindow {
     Q_OBJECT
 
@@ -33,6 +32,10 @@ public:
     explicit SCDTool_GUI(QWidget *parent = nullptr);
     ~SCDTool_GUI() override;
 
+signals:
+    // 后台解析完成，在界面线程中发出
+    void scdInfoParsed(const QString &filePath, const SCDInfo &info);
+
 protected:
     void dragEnterEvent(QDragEnterEvent *event) override;
     void dropEvent(QDropEvent *event) override;
@@ -50,15 +53,25 @@ private slots:
     void on_infoButtonParse_clicked();
     void on_infoButtonModify_clicked();
 
+    void on_searchButtonChooseFile_clicked();
+    void on_searchButtonSearch_clicked();
+
+    void onScdInfoParsed(const QString &filePath, const SCDInfo &info);
+
 private:
     Ui::SCDTool_GUI *ui{nullptr};
 
     // CLI 工具路径
     QString toolTxtMaker;
-    QString toolScdMaker;
-    QString toolScdParser;
     QString toolScdEditor;
 
+    // 常驻 txtmaker 任务服务，第一次转换时启动
+    JobServer *txtJobServer{nullptr};
+
+    // 两个转换标签页的输出、进度条和取消按钮
+    TaskMonitor *txtMonitor{nullptr};
+    TaskMonitor *scdMonitor{nullptr};
+
     // 原始词库信息，用于检测是否修改
     QString originalDictId;
     QString originalDictName;
@@ -66,33 +79,23 @@ private:
     QString originalRemark;
     bool originalOfficial = false;
 
-    void initToolPaths(); // 初始化工具路径
+    // 后台解析词库信息
+    QFutureWatcher<SCDInfo> *infoWatcher{nullptr};
+    QString parsingFilePath;
 
-    // 文件头三段常量（官方词库）
-    static inline const FileHeaderSegment OFFICIAL_HEADER_SEGMENT = {
-        QByteArray::fromHex("40150000"),   // 前4字节固定
-        QByteArray::fromHex("4443"),       // 中段可变
-        QByteArray::fromHex("5301010000")  // 后6字节固定
+    // 后台生成细胞词库，结果为输出信息、各阶段统计和是否成功
+    struct MakeResult {
+        QString message;
+        SCDStats stats;
+        bool success = false;
     };
+    QFutureWatcher<MakeResult> *makeWatcher{nullptr};
 
-    // 判断文件是否为合法搜狗细胞词库
-    static bool isValidSogouHeader(const QString &filePath) {
-        QFile file(filePath);
-        if (!file.open(QIODevice::ReadOnly)) return false;
-        QByteArray header = file.read(12);
-        file.close();
-        if (header.size() < 12) return false;
-
-        return (header.left(4) == OFFICIAL_HEADER_SEGMENT.prefix &&
-                header.right(6) == OFFICIAL_HEADER_SEGMENT.suffix);
-    }
-
-    // 判断文件头是否官方（中段可变，不比对中段）
-    static bool isOfficialHeader(const QByteArray &header) {
-        if (header.size() < 12) return false;
-        return (header.left(4) == OFFICIAL_HEADER_SEGMENT.prefix &&
-                header.right(6) == OFFICIAL_HEADER_SEGMENT.suffix);
-    }
+    // 后台查找词库，结果为输出文本；索引在两次查找之间保留，换文件时才重新打开
+    QFutureWatcher<QString> *searchWatcher{nullptr};
+    std::shared_ptr<SCDSearchIndex> searchIndex;
+
+    void initToolPaths(); // 初始化工具路径
 };
 
 #endif // SCDTOOL_GUI_H
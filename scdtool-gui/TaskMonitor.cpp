@@ -0,0 +1,112 @@
+#include "TaskMonitor.h"
+#include <QTextCharFormat>
+#include <QTextCursor>
+
+namespace {
+
+// 界面刷新间隔（毫秒），约 30 帧每秒
+constexpr int frameInterval = 33;
+
+} // namespace
+
+TaskMonitor::TaskMonitor(QTextEdit *output, QProgressBar *progressBar, QPushButton *cancelButton, QObject *parent)
+    : QObject(parent), m_output(output), m_progressBar(progressBar), m_cancelButton(cancelButton) {
+    m_timer.setInterval(frameInterval);
+    connect(&m_timer, &QTimer::timeout, this, &TaskMonitor::flush);
+    connect(cancelButton, &QPushButton::clicked, this, &TaskMonitor::cancel);
+    cancelButton->setEnabled(false);
+    progressBar->setRange(0, 1000);
+    progressBar->setValue(0);
+    progressBar->setFormat(QString());
+}
+
+std::shared_ptr<SCDProgress> TaskMonitor::begin() {
+    m_progress = std::make_shared<SCDProgress>();
+    m_cancelHandler = nullptr;
+    m_running = true;
+    m_shownText.clear();
+    m_progressBar->setRange(0, 1000);
+    m_progressBar->setValue(0);
+    m_progressBar->setFormat(QString());
+    m_cancelButton->setEnabled(true);
+    m_timer.start();
+    return m_progress;
+}
+
+void TaskMonitor::finish(bool success) {
+    flush();
+    m_timer.stop();
+    m_running = false;
+    m_cancelHandler = nullptr;
+    m_cancelButton->setEnabled(false);
+
+    const bool canceled = m_progress && m_progress->isCanceled();
+    m_progressBar->setRange(0, 1000);
+    if (success && !canceled) {
+        m_progressBar->setValue(1000);
+        m_progressBar->setFormat("完成");
+    } else {
+        m_progressBar->setFormat(canceled ? "已取消" : "失败");
+    }
+}
+
+void TaskMonitor::append(const QString &text, const QColor &color) {
+    if (text.isEmpty()) {
+        return;
+    }
+    if (!m_pending.isEmpty() && m_pending.last().color == color) {
+        m_pending.last().text += text;
+    } else {
+        m_pending.append(Chunk{text, color});
+    }
+    // 任务结束之后到达的输出（如结束帧之后的提示）也要写出
+    if (!m_timer.isActive()) {
+        m_timer.start();
+    }
+}
+
+void TaskMonitor::cancel() {
+    if (!m_running) {
+        return;
+    }
+    m_cancelButton->setEnabled(false);
+    m_progress->cancel();
+    if (m_cancelHandler) {
+        m_cancelHandler();
+    }
+}
+
+// 每帧一次：把攒下的输出插入文本框并滚到末尾，再按进度对象更新进度条
+void TaskMonitor::flush() {
+    if (!m_pending.isEmpty() && m_output) {
+        QTextCursor cursor(m_output->document());
+        cursor.movePosition(QTextCursor::End);
+        for (const Chunk &chunk : std::as_const(m_pending)) {
+            QTextCharFormat format;
+            format.setForeground(chunk.color);
+            cursor.insertText(chunk.text, format);
+        }
+        m_output->moveCursor(QTextCursor::End);
+    }
+    m_pending.clear();
+
+    if (!m_running) {
+        m_timer.stop();
+        return;
+    }
+    if (!m_progress || !m_progressBar) {
+        return;
+    }
+    const int permille = m_progress->permille();
+    if (permille < 0) {
+        m_progressBar->setRange(0, 0); // 总量未知时显示忙碌状态
+    } else {
+        m_progressBar->setRange(0, 1000);
+        m_progressBar->setValue(permille);
+    }
+    const QString text = m_progress->toText();
+    if (text != m_shownText) {
+        m_shownText = text;
+        m_progressBar->setFormat(text);
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef TASKMONITOR_H
+#define TASKMONITOR_H
+
+#include <QObject>
+#include <QColor>
+#include <QList>
+#include <QPointer>
+#include <QProgressBar>
+#include <QPushButton>
+#include <QString>
+#include <QTextEdit>
+#include <QTimer>
+#include <functional>
+#include <memory>
+#include "SCDProgress.h"
+
+/**
+ * 一个标签页上长任务的输出、进度条和取消按钮
+ *
+ * 任务的输出先攒在缓冲区里，进度由工作线程或外部进度行写入 SCDProgress，
+ * 界面按固定帧率（约 30 帧每秒）统一刷新：每帧同色的文本合并为一次插入，进度条只读一次原子量。
+ * 输出再多也不会每块数据都插入一次文本、滚动一次，工作线程和子进程不必等待界面。
+ * 同一时间只有一个任务；取消按钮在任务期间可用，点击后标记 SCDProgress 并调用任务登记的取消操作。
+ */
+class TaskMonitor : public QObject {
+    Q_OBJECT
+
+public:
+    TaskMonitor(QTextEdit *output, QProgressBar *progressBar, QPushButton *cancelButton, QObject *parent = nullptr);
+
+    // 开始新任务：清空进度条、启用取消按钮，返回本任务的进度对象（工作线程可持有）
+    std::shared_ptr<SCDProgress> begin();
+
+    // 任务结束：写出剩余输出，进度条停在完成 / 失败 / 已取消，禁用取消按钮
+    void finish(bool success);
+
+    bool isRunning() const { return m_running; }
+
+    QTextEdit *output() const { return m_output; }
+
+    // 当前任务的进度对象，没有任务时为空
+    SCDProgress *progress() const { return m_progress.get(); }
+
+    // 取消时除了标记 SCDProgress 之外还要做的事（结束子进程、通知任务服务等）
+    void setCancelHandler(const std::function<void()> &handler) { m_cancelHandler = handler; }
+
+    // 追加输出，下一帧写入文本框
+    void append(const QString &text, const QColor &color = Qt::black);
+
+private:
+    void cancel();
+    void flush();
+
+    struct Chunk {
+        QString text;
+        QColor color;
+    };
+
+    QPointer<QTextEdit> m_output;
+    QPointer<QProgressBar> m_progressBar;
+    QPointer<QPushButton> m_cancelButton;
+    QTimer m_timer;
+    QList<Chunk> m_pending;
+    std::shared_ptr<SCDProgress> m_progress;
+    std::function<void()> m_cancelHandler;
+    QString m_shownText; // 进度条上当前显示的文本，相同时不重设
+    bool m_running = false;
+};
+
+#endif // TASKMONITOR_H
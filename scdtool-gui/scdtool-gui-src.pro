@@ -1,16 +1,47 @@
 TEMPLATE = app
 TARGET = scdtool
-QT += core gui widgets
+QT += core gui widgets concurrent network
 CONFIG += c++17
 
+# 与 scdviewer 共用的词库读取代码
+INCLUDEPATH += ../scdviewer
+
 SOURCES += main.cpp \
            FileHandler.cpp \
-           SCDTool_GUI.cpp
+           JobServer.cpp \
+           TaskMonitor.cpp \
+           SCDTool_GUI.cpp \
+           ../scdviewer/SCDInfoRead.cpp \
+           ../scdviewer/SCDHeader.cpp \
+           ../scdviewer/SCDInfoCache.cpp \
+           ../scdviewer/SCDEntryReader.cpp \
+           ../scdviewer/SCDChecksum.cpp \
+           ../scdviewer/SCDWriter.cpp \
+           ../scdviewer/SCDDictionary.cpp \
+           ../scdviewer/SCDSearchIndex.cpp \
+           ../scdviewer/SCDText.cpp \
+           ../scdviewer/SCDStats.cpp \
+           ../scdviewer/SCDProgress.cpp
 
 HEADERS += FileHandler.h \
-           SCDTool_GUI.h
+           JobServer.h \
+           TaskMonitor.h \
+           SCDTool_GUI.h \
+           ../scdviewer/SCDInfoRead.h \
+           ../scdviewer/SCDHeader.h \
+           ../scdviewer/SCDInfoCache.h \
+           ../scdviewer/SCDEntryReader.h \
+           ../scdviewer/SCDChecksum.h \
+           ../scdviewer/SCDWriter.h \
+           ../scdviewer/SCDDictionary.h \
+           ../scdviewer/SCDSearchIndex.h \
+           ../scdviewer/SCDText.h \
+           ../scdviewer/SCDStats.h \
+           ../scdviewer/SCDProgress.h
 
 FORMS += SCDTool_GUI.ui
 
+RESOURCES += ../scdviewer/SCDResources.qrc
+
 # 可选：生成目录
 DESTDIR = build
@@ -0,0 +1,95 @@
+#include "SCDBatch.h"
+#include <QDirIterator>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSemaphore>
+#include <QThread>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+QStringList SCDBatch::collectFiles(const QString &path)
+{
+    QFileInfo info(path);
+    if (info.isFile()) {
+        return QStringList() << path;
+    }
+
+    QStringList files;
+    QDirIterator it(path, QStringList() << "*.scel" << "*.qcel", QDir::Files,
+                    QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        files.append(it.next());
+    }
+
+    // 输出顺序与目录遍历顺序无关
+    std::sort(files.begin(), files.end());
+    return files;
+}
+
+int SCDBatch::defaultJobs()
+{
+    return qMax(4, QThread::idealThreadCount() * 2);
+}
+
+void SCDBatch::run(const QStringList &files, int jobs,
+                   const std::function<QByteArray(const QString &)> &work,
+                   const std::function<void(qsizetype, const QByteArray &)> &output)
+{
+    const qsizetype total = files.size();
+    if (total == 0) {
+        return;
+    }
+    jobs = static_cast<int>(qBound<qsizetype>(1, jobs, total));
+
+    // 领先输出位置的结果最多保留 window 个
+    QSemaphore window(jobs * 64);
+    std::atomic<qsizetype> nextIndex{0};
+
+    QMutex mutex;
+    QWaitCondition resultReady;
+    std::vector<QByteArray> results(total);
+    std::vector<char> ready(total, 0);
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(jobs);
+    for (int i = 0; i < jobs; ++i) {
+        pool.start([&]() {
+            for (;;) {
+                window.acquire();
+                const qsizetype index = nextIndex.fetch_add(1);
+                if (index >= total) {
+                    window.release();
+                    return;
+                }
+
+                QByteArray result = work(files.at(index));
+
+                QMutexLocker locker(&mutex);
+                results[index] = std::move(result);
+                ready[index] = 1;
+                resultReady.wakeAll();
+            }
+        });
+    }
+
+    // 按顺序输出，输出后立即释放结果
+    for (qsizetype index = 0; index < total; ++index) {
+        QByteArray result;
+        {
+            QMutexLocker locker(&mutex);
+            while (!ready[index]) {
+                resultReady.wait(&mutex);
+            }
+            result = std::move(results[index]);
+            results[index] = QByteArray();
+        }
+        output(index, result);
+        window.release();
+    }
+
+    pool.waitForDone();
+}
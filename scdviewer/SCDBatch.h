@@ -0,0 +1,26 @@
+#ifndef SCDBATCH_H
+#define SCDBATCH_H
+
+#include <QByteArray>
+#include <QStringList>
+#include <functional>
+
+// 批量处理词库集合（目录树）
+namespace SCDBatch {
+    // 收集目录树下所有 .scel / .qcel 文件（按路径排序）；传入单个文件时直接返回该文件
+    QStringList collectFiles(const QString &path);
+
+    // 默认并发数：读文件头以 I/O 为主，线程数取核心数的两倍
+    int defaultJobs();
+
+    /**
+     * 在线程池中对每个文件执行 work，并按 files 的顺序在调用线程中把结果交给 output。
+     * 工作线程从共享计数器领取下一个文件，慢文件不会拖住其他线程；
+     * 已完成但尚未输出的结果数量有上限，输出是流式的，内存不随文件数增长。
+     */
+    void run(const QStringList &files, int jobs,
+             const std::function<QByteArray(const QString &filePath)> &work,
+             const std::function<void(qsizetype index, const QByteArray &result)> &output);
+}
+
+#endif // SCDBATCH_H
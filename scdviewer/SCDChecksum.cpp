@@ -0,0 +1,309 @@
+#include "SCDChecksum.h"
+#include <QElapsedTimer>
+#include <QtEndian>
+#include <cstring>
+
+// 每次从设备读取的字节数（64 的整数倍）
+static constexpr qint64 readChunkSize = 64 * 1024;
+
+static inline quint32 rotl(quint32 x, int n)
+{
+    return (x << n) | (x >> (32 - n));
+}
+
+// 内部函数：处理一个 64 字节分块
+static void processBlock(SCDChecksum::Digest &state, const uchar *block)
+{
+    quint32 x[16];
+    for (int i = 0; i < 16; ++i) {
+        x[i] = qFromLittleEndian<quint32>(block + i * 4);
+    }
+
+    quint32 a = state[0], b = state[1], c = state[2], d = state[3];
+
+    // 第 1 轮
+    a = ((~b & d) | (c & b)) + x[0] + 0xD76AA478 + a;
+    a = rotl(a, 7) + b;
+    d = ((~a & c) | (b & a)) + x[1] + 0xE8C7B756 + d;
+    d = rotl(d, 12) + a;
+    c = ((~d & b) | (d & a)) + x[2] + 0x242070DB + c;
+    c = rotl(c, 17) + d;
+    b = ((~c & a) | (d & c)) + x[3] + 0xC1BDCEEE + b;
+    b = rotl(b, 22) + c;
+    a = ((~b & d) | (c & b)) + x[4] + 0xF57C0FAF + a;
+    a = rotl(a, 7) + b;
+    d = ((~a & c) | (b & a)) + x[5] + 0x4787C62A + d;
+    d = rotl(d, 12) + a;
+    c = ((~d & b) | (d & a)) + x[6] + 0xA8304613 + c;
+    c = rotl(c, 17) + d;
+    b = ((~c & a) | (d & c)) + x[7] + 0xFD469501 + b;
+    b = rotl(b, 22) + c;
+    a = ((~b & d) | (c & b)) + x[8] + 0x698098D8 + a;
+    a = rotl(a, 7) + b;
+    d = ((~a & c) | (b & a)) + x[9] + 0x8B44F7AF + d;
+    d = rotl(d, 12) + a;
+    c = ((~d & b) | (d & a)) + x[10] + 0xFFFF5BB1 + c;
+    c = rotl(c, 17) + d;
+    b = ((~c & a) | (d & c)) + x[11] + 0x895CD7BE + b;
+    b = rotl(b, 22) + c;
+    a = ((~b & d) | (c & b)) + x[12] + 0x6B901122 + a;
+    a = rotl(a, 7) + b;
+    d = ((~a & c) | (b & a)) + x[13] + 0xFD987193 + d;
+    d = rotl(d, 12) + a;
+    c = ((~d & b) | (d & a)) + x[14] + 0xA679438E + c;
+    c = rotl(c, 17) + d;
+    b = ((~c & a) | (d & c)) + x[15] + 0x49B40821 + b;
+    b = rotl(b, 22) + c;
+
+    // 第 2 轮
+    a = ((~d & c) | (d & b)) + x[1] + 0xF61E2562 + a;
+    a = rotl(a, 5) + b;
+    d = ((~c & b) | (c & a)) + x[6] + 0xC040B340 + d;
+    d = rotl(d, 9) + a;
+    c = ((~b & a) | (d & b)) + x[11] + 0x265E5A51 + c;
+    c = rotl(c, 14) + d;
+    b = ((~a & d) | (c & a)) + x[0] + 0xE9B6C7AA + b;
+    b = rotl(b, 20) + c;
+    a = ((~d & c) | (d & b)) + x[5] + 0xD62F105D + a;
+    a = rotl(a, 5) + b;
+    d = ((~c & b) | (c & a)) + x[10] + 0x02441453 + d;
+    d = rotl(d, 9) + a;
+    c = ((~b & a) | (d & b)) + x[15] + 0xD8A1E681 + c;
+    c = rotl(c, 14) + d;
+    b = ((~a & d) | (c & a)) + x[4] + 0xE7D3FBC8 + b;
+    b = rotl(b, 20) + c;
+    a = ((~d & c) | (d & b)) + x[9] + 0x21E1CDE6 + a;
+    a = rotl(a, 5) + b;
+    d = ((~c & b) | (c & a)) + x[14] + 0xC33707D6 + d;
+    d = rotl(d, 9) + a;
+    c = ((~b & a) | (d & b)) + x[3] + 0xF4D50D87 + c;
+    c = rotl(c, 14) + d;
+    b = ((~a & d) | (c & a)) + x[8] + 0x455A14ED + b;
+    b = rotl(b, 20) + c;
+    a = ((~d & c) | (d & b)) + x[13] + 0xA9E3E905 + a;
+    a = rotl(a, 5) + b;
+    d = ((~c & b) | (c & a)) + x[2] + 0xFCEFA3F8 + d;
+    d = rotl(d, 9) + a;
+    c = ((~b & a) | (d & b)) + x[7] + 0x676F02D9 + c;
+    c = rotl(c, 14) + d;
+    b = ((~a & d) | (c & a)) + x[12] + 0x8D2A4C8A + b;
+    b = rotl(b, 20) + c;
+
+    // 第 3 轮
+    a = (d ^ c ^ b) + x[5] + 0xFFFA3942 + a;
+    a = rotl(a, 4) + b;
+    d = (c ^ b ^ a) + x[8] + 0x8771F681 + d;
+    d = rotl(d, 11) + a;
+    c = (d ^ b ^ a) + x[11] + 0x6D9D6122 + c;
+    c = rotl(c, 16) + d;
+    b = (d ^ c ^ a) + x[14] + 0xFDE5380C + b;
+    quint32 magic = rotl(b, 23) + c;
+    a = a + 0xA4BEEA44 + (d ^ c ^ magic) + x[1];
+    b = rotl(a, 4) + magic;
+    d = (c ^ magic ^ b) + x[4] + 0x4BDECFA9 + d;
+    d = rotl(d, 11) + b;
+    c = (d ^ magic ^ b) + x[7] + 0xF6BB4B60 + c;
+    c = rotl(c, 16) + d;
+    a = magic + 0xBEBFBC70 + (d ^ c ^ b) + x[10];
+    a = rotl(a, 23) + c;
+    b = (d ^ c ^ a) + x[13] + 0x289B7EC6 + b;
+    b = rotl(b, 4) + a;
+    d = (c ^ a ^ b) + x[0] + 0xEAA127FA + d;
+    d = rotl(d, 11) + b;
+    c = (d ^ a ^ b) + x[3] + 0xD4EF3085 + c;
+    c = rotl(c, 16) + d;
+    a = a + 0x04881D05 + (d ^ c ^ b) + x[6];
+    a = rotl(a, 23) + c;
+    b = (d ^ c ^ a) + x[9] + 0xD9D4D039 + b;
+    b = rotl(b, 4) + a;
+    d = (c ^ a ^ b) + x[12] + 0xE6DB99E5 + d;
+    d = rotl(d, 11) + b;
+    c = (d ^ a ^ b) + x[15] + 0x1FA27CF8 + c;
+    c = rotl(c, 16) + d;
+    a = (d ^ c ^ b) + x[2] + 0xC4AC5665 + a;
+    a = rotl(a, 23) + c;
+
+    // 第 4 轮
+    b = ((~d | a) ^ c) + x[0] + 0xF4292244 + b;
+    b = rotl(b, 6) + a;
+    d = ((~c | b) ^ a) + x[7] + 0x432AFF97 + d;
+    d = rotl(d, 10) + b;
+    c = ((~a | d) ^ b) + x[14] + 0xAB9423A7 + c;
+    c = rotl(c, 15) + d;
+    a = ((~b | c) ^ d) + x[5] + 0xFC93A039 + a;
+    a = rotl(a, 21) + c;
+    b = ((~d | a) ^ c) + x[12] + 0x655B59C3 + b;
+    b = rotl(b, 6) + a;
+    d = ((~c | b) ^ a) + x[3] + 0x8F0CCC92 + d;
+    d = rotl(d, 10) + b;
+    c = ((~a | d) ^ b) + x[10] + 0xFFEFF47D + c;
+    c = rotl(c, 15) + d;
+    a = ((~b | c) ^ d) + x[1] + 0x85845DD1 + a;
+    a = rotl(a, 21) + c;
+    b = ((~d | a) ^ c) + x[8] + 0x6FA87E4F + b;
+    b = rotl(b, 6) + a;
+    d = ((~c | b) ^ a) + x[15] + 0xFE2CE6E0 + d;
+    d = rotl(d, 10) + b;
+    c = ((~a | d) ^ b) + x[6] + 0xA3014314 + c;
+    c = rotl(c, 15) + d;
+    a = ((~b | c) ^ d) + x[13] + 0x4E0811A1 + a;
+    a = rotl(a, 21) + c;
+    b = ((~d | a) ^ c) + x[4] + 0xF7537E82 + b;
+    b = rotl(b, 6) + a;
+    d = ((~c | b) ^ a) + x[11] + 0xBD3AF235 + d;
+    d = rotl(d, 10) + b;
+    c = ((~a | d) ^ b) + x[2] + 0x2AD7D2BB + c;
+    c = rotl(c, 15) + d;
+    a = ((~b | c) ^ d) + x[9] + 0xEB86D391 + a;
+    a = rotl(a, 21) + c;
+
+    state[0] += b;
+    state[1] += a;
+    state[2] += c;
+    state[3] += d;
+}
+
+SCDChecksum::SCDChecksum()
+{
+    reset();
+}
+
+void SCDChecksum::reset()
+{
+    m_state = {0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476};
+    m_pending = 0;
+    m_length = 0;
+}
+
+void SCDChecksum::addData(const char *data, qint64 length)
+{
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    m_length += static_cast<quint64>(length);
+
+    // 先补满上次剩下的分块
+    if (m_pending > 0) {
+        const qint64 take = qMin<qint64>(64 - m_pending, length);
+        std::memcpy(m_block + m_pending, p, take);
+        m_pending += static_cast<int>(take);
+        p += take;
+        length -= take;
+        if (m_pending < 64) {
+            return;
+        }
+        processBlock(m_state, m_block);
+        m_pending = 0;
+    }
+
+    // 整块直接在输入上处理，不复制
+    for (; length >= 64; p += 64, length -= 64) {
+        processBlock(m_state, p);
+    }
+
+    std::memcpy(m_block, p, length);
+    m_pending = static_cast<int>(length);
+}
+
+SCDChecksum::Digest SCDChecksum::result() const
+{
+    // 填充 0x80、若干 0x00 和 64 位小端的位长度，补齐到 64 的倍数
+    Digest state = m_state;
+    uchar tail[128] = {};
+    std::memcpy(tail, m_block, m_pending);
+    tail[m_pending] = 0x80;
+    const int tailSize = (m_pending + 1 + 8 <= 64) ? 64 : 128;
+    qToLittleEndian<quint64>(m_length << 3, tail + tailSize - 8);
+    for (int i = 0; i < tailSize; i += 64) {
+        processBlock(state, tail + i);
+    }
+    return state;
+}
+
+SCDChecksum::Digest SCDChecksum::compute(QIODevice *device, bool *ok)
+{
+    SCDChecksum checksum;
+    QByteArray buffer(readChunkSize, Qt::Uninitialized);
+
+    for (;;) {
+        const qint64 n = device->read(buffer.data(), readChunkSize);
+        if (n < 0) {
+            if (ok) *ok = false;
+            return checksum.result();
+        }
+        if (n == 0) {
+            break;
+        }
+        checksum.addData(buffer.constData(), n);
+    }
+
+    if (ok) *ok = true;
+    return checksum.result();
+}
+
+QByteArray SCDChecksum::toBytes(const Digest &digest)
+{
+    QByteArray bytes(Size, Qt::Uninitialized);
+    for (int i = 0; i < 4; ++i) {
+        qToLittleEndian<quint32>(digest[i], bytes.data() + i * 4);
+    }
+    return bytes;
+}
+
+SCDChecksum::Digest SCDChecksum::fromBytes(const uchar *bytes)
+{
+    Digest digest;
+    for (int i = 0; i < 4; ++i) {
+        digest[i] = qFromLittleEndian<quint32>(bytes + i * 4);
+    }
+    return digest;
+}
+
+SCDChecksumWriter::SCDChecksumWriter(QIODevice *device)
+    : m_device(device)
+{
+    m_buffer.reserve(BufferSize + 64 * 1024);
+}
+
+void SCDChecksumWriter::append(const char *data, qint64 size)
+{
+    m_buffer.append(data, size);
+    flushIfFull();
+}
+
+void SCDChecksumWriter::appendU16(quint16 value)
+{
+    char bytes[2];
+    qToLittleEndian<quint16>(value, bytes);
+    m_buffer.append(bytes, 2);
+}
+
+void SCDChecksumWriter::appendRaw(const char *data, qint64 size)
+{
+    if (size <= 0) {
+        return;
+    }
+    flush();
+    addChecksum(data, size);
+    if (m_device->write(data, size) != size) {
+        m_ok = false;
+    }
+}
+
+void SCDChecksumWriter::addChecksum(const char *data, qint64 size)
+{
+    QElapsedTimer timer;
+    timer.start();
+    m_checksum.addData(data, size);
+    m_checksumNanoseconds += timer.nsecsElapsed();
+}
+
+bool SCDChecksumWriter::flush()
+{
+    if (!m_buffer.isEmpty()) {
+        addChecksum(m_buffer.constData(), m_buffer.size());
+        if (m_device->write(m_buffer) != m_buffer.size()) {
+            m_ok = false;
+        }
+        m_buffer.resize(0);
+    }
+    return m_ok;
+}
@@ -0,0 +1,89 @@
+#ifndef SCDCHECKSUM_H
+#define SCDCHECKSUM_H
+
+#include <QByteArray>
+#include <QIODevice>
+#include <QtGlobal>
+#include <array>
+
+/**
+ * 细胞词库校验和（搜狗变种 MD5）
+ *
+ * 对 0x1540 之后的全部数据计算，结果按小端存放在文件头 0x00C-0x01B。
+ * 与标准 MD5 的填充方式相同，但第 3 轮的寄存器顺序和最终累加顺序不同，
+ * 实现与 scel-maker/sogou_md5.go 逐行对应。
+ *
+ * 用法与 QCryptographicHash 相同：多次 addData() 后取 result()。
+ * 生成词库时边写边算，不需要回读文件。
+ */
+class SCDChecksum
+{
+public:
+    using Digest = std::array<quint32, 4>;
+
+    // 文件头中校验和的偏移与长度
+    static constexpr qint64 Offset = 0x00C;
+    static constexpr int Size = 16;
+
+    SCDChecksum();
+
+    void reset();
+    void addData(const char *data, qint64 length);
+    void addData(const QByteArray &data) { addData(data.constData(), data.size()); }
+
+    // 补齐填充后的结果，不影响当前状态（可以继续 addData）
+    Digest result() const;
+
+    // 从设备当前位置读到结尾并计算校验和，读取失败时 ok 置为 false
+    static Digest compute(QIODevice *device, bool *ok = nullptr);
+
+    // 按文件头存放格式（4 个小端 uint32）输出 / 读取
+    static QByteArray toBytes(const Digest &digest);
+    static Digest fromBytes(const uchar *bytes);
+
+private:
+    Digest m_state;
+    uchar m_block[64];   // 不足一个分块的剩余数据
+    int m_pending = 0;
+    quint64 m_length = 0;
+};
+
+/**
+ * 写出 0x1540 之后的数据并同时计算校验和
+ *
+ * 小段数据先攒进缓冲区（可以直接向 buffer() 追加，再调用 flushIfFull()），
+ * 原样复制的大段数据经 appendRaw() 直接写出。写完后调用 flush()，再把 result() 回填到文件头。
+ */
+class SCDChecksumWriter
+{
+public:
+    static constexpr qint64 BufferSize = 1 << 20;
+
+    explicit SCDChecksumWriter(QIODevice *device);
+
+    QByteArray &buffer() { return m_buffer; }
+    void append(const char *data, qint64 size);
+    void appendU16(quint16 value);
+    void appendRaw(const char *data, qint64 size);
+
+    // 缓冲区超过 BufferSize 时写出
+    bool flushIfFull() { return m_buffer.size() < BufferSize || flush(); }
+    // 写出缓冲区，之前任何一次写入失败都返回 false
+    bool flush();
+
+    SCDChecksum::Digest result() const { return m_checksum.result(); }
+
+    // 计算校验和累计花费的时间（不含写出），用于 --stats
+    qint64 checksumNanoseconds() const { return m_checksumNanoseconds; }
+
+private:
+    void addChecksum(const char *data, qint64 size);
+
+    QIODevice *m_device;
+    QByteArray m_buffer;
+    SCDChecksum m_checksum;
+    qint64 m_checksumNanoseconds = 0;
+    bool m_ok = true;
+};
+
+#endif // SCDCHECKSUM_H
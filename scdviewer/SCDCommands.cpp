@@ -0,0 +1,552 @@
+#include "SCDCommands.h"
+#include "SCDEntryReader.h"
+#include "SCDInfoRead.h"
+#include "SCDInfoCache.h"
+#include "SCDBatch.h"
+#include "SCDVerify.h"
+#include "SCDWriter.h"
+#include "SCDUpdater.h"
+#include "SCDMerger.h"
+#include "SCDDiff.h"
+#include "SCDSearchIndex.h"
+#include "SCDTrieWriter.h"
+#include "SCDStats.h"
+#include "SCDProgress.h"
+#include <QCommandLineParser>
+#include <QCommandLineOption>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <chrono>
+#include <condition_variable>
+#include <csignal>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+// 内部函数：CSV 字段转义
+static QByteArray csvField(const QString &value)
+{
+    QByteArray bytes = value.toUtf8();
+    if (bytes.contains(',') || bytes.contains('"') || bytes.contains('\n') || bytes.contains('\r')) {
+        bytes.replace("\"", "\"\"");
+        return '"' + bytes + '"';
+    }
+    return bytes;
+}
+
+// 内部类：--progress 时定时输出进度行，并让 SIGINT / SIGTERM 取消任务而不是直接结束进程
+class ProgressReporter
+{
+public:
+    ProgressReporter(SCDProgress *progress, bool enabled)
+    {
+        if (!enabled) {
+            return;
+        }
+        s_progress = progress;
+        std::signal(SIGINT, cancelHandler);
+        std::signal(SIGTERM, cancelHandler);
+        m_thread = std::thread([this, progress]() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            while (!m_cv.wait_for(lock, std::chrono::milliseconds(200), [this]() { return m_stop; })) {
+                const QByteArray line = progress->toJson() + '\n';
+                std::fputs(line.constData(), stderr);
+                std::fflush(stderr);
+            }
+        });
+    }
+
+    ~ProgressReporter()
+    {
+        if (!m_thread.joinable()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_cv.notify_one();
+        m_thread.join();
+        std::signal(SIGINT, SIG_DFL);
+        std::signal(SIGTERM, SIG_DFL);
+        s_progress = nullptr;
+    }
+
+private:
+    // 只做一次无锁的原子写，可在信号处理函数中调用
+    static void cancelHandler(int)
+    {
+        if (s_progress) {
+            s_progress->cancel();
+        }
+    }
+
+    static inline SCDProgress *volatile s_progress = nullptr;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    bool m_stop = false;
+};
+
+// 内部函数：把一条词库信息格式化为一行目录记录，非法文件返回空
+static QByteArray catalogLine(const QString &filePath, bool jsonLines)
+{
+    SCDInfo info = SCDInfoRead::readSCDInfo(filePath);
+    if (!info.isValid) {
+        return {};
+    }
+
+    if (jsonLines) {
+        QJsonObject obj;
+        obj.insert("path", filePath);
+        obj.insert("id", info.id);
+        obj.insert("name", info.name);
+        obj.insert("category", info.category);
+        obj.insert("phraseCount", info.phraseCount);
+        obj.insert("timestamp", static_cast<qint64>(info.timestamp));
+        obj.insert("isOfficial", info.isOfficial);
+        obj.insert("format", SCDHeader::formatName(info.format));
+        return QJsonDocument(obj).toJson(QJsonDocument::Compact) + '\n';
+    }
+
+    QByteArray line;
+    line += csvField(filePath) + ',';
+    line += csvField(info.id) + ',';
+    line += csvField(info.name) + ',';
+    line += csvField(info.category) + ',';
+    line += QByteArray::number(info.phraseCount) + ',';
+    line += QByteArray::number(info.timestamp) + ',';
+    line += (info.isOfficial ? "true" : "false");
+    line += ',' + SCDHeader::formatName(info.format).toLatin1();
+    line += '\n';
+    return line;
+}
+
+int SCDCommands::run(const QStringList &arguments)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("细胞词库查看器\n不带选项时：scdviewer <词库文件> 打开信息窗口");
+    parser.addHelpOption();
+
+    QCommandLineOption decompileOption(QStringList() << "d" << "decompile",
+                                       "把细胞词库反编译为搜狗文本词库", "词库文件");
+    QCommandLineOption makeOption(QStringList() << "m" << "make",
+                                  "由搜狗文本词库生成细胞词库", "文本文件");
+    QCommandLineOption addOption("add", "把文本文件中的词条加入词库（与词库文件一起使用，不重新生成整个词库）", "文本文件");
+    QCommandLineOption removeOption("remove", "从词库中删除文本文件中的词条（与词库文件一起使用）", "文本文件");
+    QCommandLineOption mergeOption("merge", "把多个细胞词库合并为一个（输入为词库文件参数，需要 -o 指定输出）");
+    QCommandLineOption diffOption("diff", "比较旧词库与新词库（词库文件参数），输出新增和删除的词条", "旧词库");
+    QCommandLineOption searchOption(QStringList() << "s" << "search",
+                                    "在词库（词库文件参数）中查找：拼音 bei'jing、拼音前缀 bei'jing* 或中文子串", "查询");
+    QCommandLineOption trieOption(QStringList() << "t" << "trie",
+                                  "导出为静态拼音 trie（.sdt），供输入法引擎映射后直接查询（格式见 SCDTrie.h）", "词库文件");
+    QCommandLineOption limitOption("limit", "查找时最多输出的词条数（默认 100，0 为不限）", "数量", "100");
+    QCommandLineOption outputOption(QStringList() << "o" << "output",
+                                    "输出文件路径（默认与输入同目录，反编译后缀 _sg.txt，生成后缀 .scel，trie 后缀 .sdt；比较时为输出文件名前缀）", "路径");
+    QCommandLineOption catalogOption(QStringList() << "c" << "catalog",
+                                     "并行扫描目录树，输出所有词库的信息目录", "目录");
+    QCommandLineOption verifyOption(QStringList() << "V" << "verify",
+                                    "并行检查词库（文件或目录树）的校验和与文件头计数", "路径");
+    QCommandLineOption formatOption(QStringList() << "f" << "format",
+                                    "目录输出格式：csv 或 jsonl（默认 csv）", "格式", "csv");
+    QCommandLineOption jobsOption(QStringList() << "j" << "jobs",
+                                  "并发线程数（默认为核心数的两倍）", "数量");
+    QCommandLineOption noCacheOption("no-cache", "不读取也不更新词库信息缓存");
+    QCommandLineOption statsOption("stats", "生成 / 反编译后在标准错误输出一行各阶段耗时和计数（格式目前只有 json）", "格式");
+    QCommandLineOption progressOption("progress", "生成 / 反编译时每 200 毫秒在标准错误输出一行进度 JSON，Ctrl+C 取消");
+    parser.addOption(decompileOption);
+    parser.addOption(makeOption);
+    parser.addOption(addOption);
+    parser.addOption(removeOption);
+    parser.addOption(mergeOption);
+    parser.addOption(diffOption);
+    parser.addOption(searchOption);
+    parser.addOption(limitOption);
+    parser.addOption(trieOption);
+    parser.addOption(catalogOption);
+    parser.addOption(verifyOption);
+    parser.addOption(formatOption);
+    parser.addOption(jobsOption);
+    parser.addOption(outputOption);
+    parser.addOption(noCacheOption);
+    parser.addOption(statsOption);
+    parser.addOption(progressOption);
+    parser.addPositionalArgument("词库文件", "--add / --remove 要更新的细胞词库（未指定 -o 时原地更新）；--merge 要合并的细胞词库；--diff 新词库；--search 要查找的词库");
+
+    parser.process(arguments);
+
+    if (parser.isSet(noCacheOption)) {
+        SCDInfoCache::setEnabled(false);
+    }
+
+    int jobs = parser.isSet(jobsOption) ? parser.value(jobsOption).toInt() : SCDBatch::defaultJobs();
+    if (jobs <= 0) {
+        jobs = SCDBatch::defaultJobs();
+    }
+
+    const bool printStats = parser.isSet(statsOption);
+    if (printStats && parser.value(statsOption) != "json") {
+        QTextStream(stderr) << "不支持的统计格式: " << parser.value(statsOption) << Qt::endl;
+        return 1;
+    }
+
+    if (parser.isSet(decompileOption)) {
+        return decompile(parser.value(decompileOption), parser.value(outputOption), printStats,
+                         parser.isSet(progressOption));
+    }
+    if (parser.isSet(makeOption)) {
+        return make(parser.value(makeOption), parser.value(outputOption), printStats, parser.isSet(progressOption));
+    }
+    if (parser.isSet(addOption) || parser.isSet(removeOption)) {
+        const QStringList files = parser.positionalArguments();
+        if (files.size() != 1) {
+            QTextStream(stderr) << "请指定一个要更新的词库文件" << Qt::endl;
+            return 1;
+        }
+        return update(files.first(), parser.value(addOption), parser.value(removeOption),
+                      parser.value(outputOption));
+    }
+    if (parser.isSet(mergeOption)) {
+        const QStringList files = parser.positionalArguments();
+        if (files.isEmpty() || !parser.isSet(outputOption)) {
+            QTextStream(stderr) << "请指定要合并的词库文件和输出路径（-o）" << Qt::endl;
+            return 1;
+        }
+        return merge(files, parser.value(outputOption));
+    }
+    if (parser.isSet(diffOption)) {
+        const QStringList files = parser.positionalArguments();
+        if (files.size() != 1) {
+            QTextStream(stderr) << "请指定一个要比较的新词库文件" << Qt::endl;
+            return 1;
+        }
+        return diff(parser.value(diffOption), files.first(), parser.value(outputOption));
+    }
+    if (parser.isSet(searchOption)) {
+        const QStringList files = parser.positionalArguments();
+        if (files.size() != 1) {
+            QTextStream(stderr) << "请指定一个要查找的词库文件" << Qt::endl;
+            return 1;
+        }
+        return search(files.first(), parser.value(searchOption), parser.value(limitOption).toInt());
+    }
+    if (parser.isSet(trieOption)) {
+        return trie(parser.value(trieOption), parser.value(outputOption));
+    }
+    if (parser.isSet(catalogOption)) {
+        return catalog(parser.value(catalogOption), parser.value(formatOption),
+                       parser.value(outputOption), jobs);
+    }
+    if (parser.isSet(verifyOption)) {
+        return verify(parser.value(verifyOption), jobs);
+    }
+
+    parser.showHelp(1);
+    return 1;
+}
+
+int SCDCommands::decompile(const QString &scelPath, const QString &txtPath, bool printStats, bool printProgress)
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QString outputPath = txtPath;
+    if (outputPath.isEmpty()) {
+        QFileInfo info(scelPath);
+        outputPath = info.path() + "/" + info.completeBaseName() + "_sg.txt";
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    SCDStats stats("scdviewer-decompile");
+    QString error;
+    SCDProgress progress;
+    qint64 count;
+    qint64 skipped = 0;
+    {
+        ProgressReporter reporter(&progress, printProgress);
+        count = SCDEntryText::exportFile(scelPath, outputPath, &error, &stats, &progress, &skipped);
+    }
+    if (count < 0) {
+        err << "反编译失败: " << error << Qt::endl;
+        return 1;
+    }
+    if (skipped > 0) {
+        err << "跳过音节下标非法的词条: " << skipped << Qt::endl;
+    }
+    if (printStats) {
+        stats.setTotal(timer.nsecsElapsed());
+        err << stats.toJson() << Qt::endl;
+    }
+
+    out << "反编译完成，输出文件：" << outputPath << Qt::endl;
+    out << "词条数量：" << count << Qt::endl;
+    return 0;
+}
+
+int SCDCommands::make(const QString &txtPath, const QString &scelPath, bool printStats, bool printProgress)
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QString outputPath = scelPath;
+    if (outputPath.isEmpty()) {
+        QFileInfo info(txtPath);
+        outputPath = info.path() + "/" + info.completeBaseName() + ".scel";
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    SCDWriter writer;
+    SCDProgress progress;
+    writer.setProgress(&progress);
+    bool ok;
+    {
+        ProgressReporter reporter(&progress, printProgress);
+        ok = writer.addTextFile(txtPath) >= 0 && writer.write(outputPath);
+    }
+    if (!ok) {
+        err << "生成失败: " << writer.errorString() << Qt::endl;
+        return 1;
+    }
+    if (writer.skippedCount() > 0) {
+        err << "跳过无法识别的行: " << writer.skippedCount() << Qt::endl;
+    }
+    if (printStats) {
+        SCDStats stats = writer.stats();
+        stats.setTotal(timer.nsecsElapsed());
+        err << stats.toJson() << Qt::endl;
+    }
+
+    out << "生成细胞词库：" << QFileInfo(outputPath).absoluteFilePath() << Qt::endl;
+    out << "拼音组数量：" << writer.groupCount() << "，词条数量：" << writer.phraseCount() << Qt::endl;
+    return 0;
+}
+
+int SCDCommands::update(const QString &scelPath, const QString &addPath, const QString &removePath,
+                        const QString &outputPath)
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    SCDUpdater updater;
+    if ((!removePath.isEmpty() && updater.removeTextFile(removePath) < 0)
+        || (!addPath.isEmpty() && updater.addTextFile(addPath) < 0)) {
+        err << "读取增量文件失败: " << updater.errorString() << Qt::endl;
+        return 1;
+    }
+
+    const QString target = outputPath.isEmpty() ? scelPath : outputPath;
+    if (!updater.apply(scelPath, target)) {
+        err << "更新失败: " << updater.errorString() << Qt::endl;
+        return 1;
+    }
+    if (updater.skippedCount() > 0) {
+        err << "跳过无法识别的行: " << updater.skippedCount() << Qt::endl;
+    }
+
+    out << "更新细胞词库：" << QFileInfo(target).absoluteFilePath() << Qt::endl;
+    out << "添加 " << updater.addedCount() << " 条，删除 " << updater.removedCount() << " 条" << Qt::endl;
+    out << "拼音组数量：" << updater.groupCount() << "，词条数量：" << updater.phraseCount() << Qt::endl;
+    return 0;
+}
+
+int SCDCommands::merge(const QStringList &scelPaths, const QString &outputPath)
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    SCDMerger merger;
+    for (const QString &path : scelPaths) {
+        merger.addInput(path);
+    }
+    if (!merger.write(outputPath)) {
+        err << "合并失败: " << merger.errorString() << Qt::endl;
+        return 1;
+    }
+    if (merger.skippedCount() > 0) {
+        err << "跳过音节不在拼音表中的词条: " << merger.skippedCount() << Qt::endl;
+    }
+    if (merger.unorderedCount() > 0) {
+        err << "输入词库未按拼音排序，部分同音词分散在多个拼音组: " << merger.unorderedCount() << Qt::endl;
+    }
+
+    out << "合并细胞词库：" << QFileInfo(outputPath).absoluteFilePath() << Qt::endl;
+    out << "输入 " << scelPaths.size() << " 个词库，去掉重复词条 " << merger.duplicateCount() << " 条" << Qt::endl;
+    out << "拼音组数量：" << merger.groupCount() << "，词条数量：" << merger.phraseCount() << Qt::endl;
+    return 0;
+}
+
+int SCDCommands::diff(const QString &oldPath, const QString &newPath, const QString &outputPrefix)
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    QString prefix = outputPrefix;
+    if (prefix.isEmpty()) {
+        QFileInfo info(newPath);
+        prefix = info.path() + "/" + info.completeBaseName();
+    }
+    const QString addedPath = prefix + "_added.txt";
+    const QString removedPath = prefix + "_removed.txt";
+
+    SCDDiff diff;
+    if (!diff.compare(oldPath, newPath, addedPath, removedPath)) {
+        err << "比较失败: " << diff.errorString() << Qt::endl;
+        return 1;
+    }
+
+    out << "新增 " << diff.addedCount() << " 条：" << QFileInfo(addedPath).absoluteFilePath() << Qt::endl;
+    out << "删除 " << diff.removedCount() << " 条：" << QFileInfo(removedPath).absoluteFilePath() << Qt::endl;
+    out << "未变 " << diff.unchangedCount() << " 条" << Qt::endl;
+    return 0;
+}
+
+int SCDCommands::search(const QString &scelPath, const QString &query, int limit)
+{
+    QTextStream err(stderr);
+
+    QElapsedTimer timer;
+    timer.start();
+    SCDSearchIndex index;
+    bool rebuilt = false;
+    if (!index.open(scelPath, &rebuilt)) {
+        err << "打开词库失败: " << index.errorString() << Qt::endl;
+        return 1;
+    }
+    const qint64 openMs = timer.restart();
+
+    qint64 total = 0;
+    const QList<QByteArray> lines = index.search(query, limit, &total);
+    const qint64 searchMs = timer.elapsed();
+
+    // 结果为搜狗文本格式，写到标准输出；统计写到标准错误，便于重定向
+    QFile out;
+    if (!out.open(stdout, QIODevice::WriteOnly)) {
+        return 1;
+    }
+    for (const QByteArray &line : lines) {
+        out.write(line);
+        out.write("\n");
+    }
+    out.flush();
+
+    err << (rebuilt ? "建立索引" : "载入索引") << " " << openMs << " ms，查找 " << searchMs << " ms；"
+        << "共 " << index.entryCount() << " 条，匹配 " << total << " 条";
+    if (total > lines.size()) {
+        err << "，显示前 " << lines.size() << " 条";
+    }
+    err << Qt::endl;
+    return 0;
+}
+
+int SCDCommands::trie(const QString &scelPath, const QString &outputPath)
+{
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const QString triePath = outputPath.isEmpty() ? SCDTrieWriter::defaultPath(scelPath) : outputPath;
+    QElapsedTimer timer;
+    timer.start();
+    SCDTrieWriter writer;
+    if (!writer.write(scelPath, triePath)) {
+        err << "导出失败: " << writer.errorString() << Qt::endl;
+        return 1;
+    }
+
+    out << "导出拼音 trie：" << QFileInfo(triePath).absoluteFilePath() << Qt::endl;
+    out << "节点数量：" << writer.nodeCount() << "，词条数量：" << writer.wordCount()
+        << "，文件大小：" << writer.fileSize() << " 字节（原词库 " << QFileInfo(scelPath).size() << " 字节），"
+        << "耗时 " << timer.elapsed() << " ms" << Qt::endl;
+    return 0;
+}
+
+int SCDCommands::catalog(const QString &dirPath, const QString &format, const QString &outputPath, int jobs)
+{
+    QTextStream err(stderr);
+
+    const bool jsonLines = (format == "jsonl");
+    if (!jsonLines && format != "csv") {
+        err << "不支持的输出格式: " << format << Qt::endl;
+        return 1;
+    }
+
+    const QStringList files = SCDBatch::collectFiles(dirPath);
+    if (files.isEmpty()) {
+        err << "未找到细胞词库: " << dirPath << Qt::endl;
+        return 1;
+    }
+
+    // 未指定输出文件时写到标准输出
+    QFile out;
+    bool opened = false;
+    if (outputPath.isEmpty()) {
+        opened = out.open(stdout, QIODevice::WriteOnly);
+    } else {
+        out.setFileName(outputPath);
+        opened = out.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    }
+    if (!opened) {
+        err << "无法写入文件: " << outputPath << Qt::endl;
+        return 1;
+    }
+
+    if (!jsonLines) {
+        out.write("path,id,name,category,phraseCount,timestamp,isOfficial,format\n");
+    }
+
+    qsizetype invalid = 0;
+    SCDBatch::run(files, jobs,
+                  [jsonLines](const QString &filePath) { return catalogLine(filePath, jsonLines); },
+                  [&](qsizetype index, const QByteArray &line) {
+                      if (line.isEmpty()) {
+                          err << "跳过非法的细胞词库: " << files.at(index) << Qt::endl;
+                          ++invalid;
+                          return;
+                      }
+                      out.write(line);
+                  });
+    out.flush();
+    SCDInfoCache::flush();
+
+    err << "共扫描 " << files.size() << " 个文件，非法 " << invalid << " 个" << Qt::endl;
+    return 0;
+}
+
+int SCDCommands::verify(const QString &path, int jobs)
+{
+    QTextStream err(stderr);
+
+    QFile out;
+    out.open(stdout, QIODevice::WriteOnly);
+
+    const QStringList files = SCDBatch::collectFiles(path);
+    if (files.isEmpty()) {
+        err << "未找到细胞词库: " << path << Qt::endl;
+        return 1;
+    }
+
+    qsizetype failed = 0;
+    SCDBatch::run(files, jobs,
+                  [](const QString &filePath) {
+                      const SCDVerifyResult result = SCDVerify::verifyFile(filePath);
+                      if (result.isOk()) {
+                          return QByteArray("OK\t") + filePath.toUtf8() + '\n';
+                      }
+                      return QByteArray("FAIL\t") + filePath.toUtf8() + '\t' + result.error.toUtf8() + '\n';
+                  },
+                  [&](qsizetype, const QByteArray &line) {
+                      if (line.startsWith("FAIL")) {
+                          ++failed;
+                      }
+                      out.write(line);
+                  });
+    out.flush();
+
+    err << "共检查 " << files.size() << " 个文件，损坏 " << failed << " 个" << Qt::endl;
+    return failed > 0 ? 1 : 0;
+}
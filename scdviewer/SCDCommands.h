@@ -0,0 +1,41 @@
+#ifndef SCDCOMMANDS_H
+#define SCDCOMMANDS_H
+
+#include <QStringList>
+
+// scdviewer 命令行模式（无界面）
+namespace SCDCommands {
+    // 解析命令行并执行，返回进程退出码
+    int run(const QStringList &arguments);
+
+    // 反编译细胞词库为搜狗文本词库；printStats 时在标准错误输出一行统计 JSON（SCDStats），
+    // printProgress 时每 200 毫秒在标准错误输出一行进度 JSON（SCDProgress），收到 SIGINT / SIGTERM 时取消并删除输出文件
+    int decompile(const QString &scelPath, const QString &txtPath, bool printStats = false, bool printProgress = false);
+
+    // 由搜狗文本词库生成细胞词库（同音词合并为一个拼音组）；printStats、printProgress 同上
+    int make(const QString &txtPath, const QString &scelPath, bool printStats = false, bool printProgress = false);
+
+    // 在已有细胞词库上增删文本文件中的词条，outputPath 为空时原地更新
+    int update(const QString &scelPath, const QString &addPath, const QString &removePath, const QString &outputPath);
+
+    // 按音节序列流式合并多个细胞词库，重复词条只保留一次
+    int merge(const QStringList &scelPaths, const QString &outputPath);
+
+    // 比较两个版本的细胞词库，新增和删除的词条写到 <前缀>_added.txt / <前缀>_removed.txt
+    // （前缀默认为新词库去掉扩展名的路径）
+    int diff(const QString &oldPath, const QString &newPath, const QString &outputPrefix);
+
+    // 在词库中查找拼音或中文（首次查找时建立索引文件，之后直接映射）
+    int search(const QString &scelPath, const QString &query, int limit);
+
+    // 导出为静态拼音 trie（.sdt，格式和加载器见 SCDTrie.h），outputPath 为空时与词库同目录
+    int trie(const QString &scelPath, const QString &outputPath);
+
+    // 并行读取目录树下所有词库的文件头，按路径顺序输出目录（format 为 csv 或 jsonl）
+    int catalog(const QString &dirPath, const QString &format, const QString &outputPath, int jobs);
+
+    // 并行检查文件或目录树下所有词库的校验和与文件头计数，有损坏的词库时返回非零
+    int verify(const QString &path, int jobs);
+}
+
+#endif // SCDCOMMANDS_H
@@ -0,0 +1,375 @@
+#include "SCDDictionary.h"
+#include <QHash>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// 排序键：前三个音节下标各加 1 占 21 位，不足三个音节的位置为 0，
+// 因此键的大小关系与前三个音节（含长度）的字典序一致。分成两个 32 位存放，每项 12 字节
+struct SortKey {
+    quint32 high;
+    quint32 low;
+    quint32 index;
+};
+
+quint64 sortKeyOf(const uchar *syllables, int count)
+{
+    quint64 key = 0;
+    for (int i = 0; i < 3; ++i) {
+        key <<= 21;
+        if (i < count) {
+            key |= quint64(qFromLittleEndian<quint16>(syllables + i * 2)) + 1;
+        }
+    }
+    return key;
+}
+
+} // namespace
+
+quint32 SCDDictionary::hashOf(const uchar *syllables, int syllableBytes, const uchar *word, int wordBytes)
+{
+    const size_t h = qHashBits(word, wordBytes, qHashBits(syllables, syllableBytes));
+    return static_cast<quint32>(quint64(h) ^ (quint64(h) >> 32));
+}
+
+SCDDictionary::SCDDictionary()
+    : m_syllableOffsets(1, 0)
+    , m_wordOffsets(1, 0)
+{
+}
+
+void SCDDictionary::reserve(size_t entries, size_t syllables, size_t wordBytes)
+{
+    m_syllableOffsets.reserve(entries + 1);
+    m_wordOffsets.reserve(entries + 1);
+    m_hashes.reserve(entries);
+    m_syllables.reserve(syllables * 2);
+    m_words.reserve(wordBytes);
+}
+
+void SCDDictionary::clear()
+{
+    // 索引远大于词条数时（之前装过大得多的一批）只清掉用到的槽：
+    // 先找出每个已登记词条所在的槽（借用即将清空的哈希列记下位置），再统一置零，
+    // 避免边找边清打断其他词条的探测链
+    if (m_slots.size() > 1024 && size_t(m_indexed) * 4 < m_slots.size()) {
+        const size_t mask = m_slots.size() - 1;
+        for (quint32 i = 0; i < size(); ++i) {
+            size_t pos = m_hashes[i] & mask;
+            while (m_slots[pos] != 0 && quint32(m_slots[pos]) != i + 1) {
+                pos = (pos + 1) & mask;
+            }
+            m_hashes[i] = m_slots[pos] != 0 ? static_cast<quint32>(pos) : NotFound;
+        }
+        for (quint32 pos : m_hashes) {
+            if (pos != NotFound) {
+                m_slots[pos] = 0;
+            }
+        }
+    } else {
+        std::fill(m_slots.begin(), m_slots.end(), quint64(0));
+    }
+    m_indexed = 0;
+
+    m_syllableOffsets.resize(1);
+    m_wordOffsets.resize(1);
+    m_hashes.clear();
+    m_syllables.clear();
+    m_words.clear();
+}
+
+quint32 SCDDictionary::commit(size_t syllableStart, size_t wordStart)
+{
+    m_syllableOffsets.push_back(static_cast<quint32>(m_syllables.size() / 2));
+    m_wordOffsets.push_back(static_cast<quint32>(m_words.size()));
+    m_hashes.push_back(hashOf(m_syllables.data() + syllableStart, static_cast<int>(m_syllables.size() - syllableStart),
+                              m_words.data() + wordStart, static_cast<int>(m_words.size() - wordStart)));
+    return size() - 1;
+}
+
+void SCDDictionary::removeLast()
+{
+    m_syllableOffsets.pop_back();
+    m_wordOffsets.pop_back();
+    m_hashes.pop_back();
+    m_syllables.resize(size_t(m_syllableOffsets.back()) * 2);
+    m_words.resize(m_wordOffsets.back());
+}
+
+quint32 SCDDictionary::append(const uchar *syllables, int syllableCount, const uchar *word, int wordBytes,
+                              const std::vector<int> *remap)
+{
+    const size_t syllableStart = m_syllables.size();
+    const size_t wordStart = m_words.size();
+    if (syllableCount < 0 || syllableCount > MaxSyllables || wordBytes < 0 || wordBytes > MaxWordBytes
+        || (syllableStart + syllableCount * 2) / 2 > 0xFFFFFFFFu || wordStart + wordBytes > 0xFFFFFFFFu) {
+        return NotFound;
+    }
+
+    m_syllables.resize(syllableStart + syllableCount * 2);
+    uchar *target = m_syllables.data() + syllableStart;
+    if (remap) {
+        for (int i = 0; i < syllableCount; ++i) {
+            const quint16 index = qFromLittleEndian<quint16>(syllables + i * 2);
+            const int mapped = index < remap->size() ? (*remap)[index] : -1;
+            if (mapped < 0) {
+                m_syllables.resize(syllableStart);
+                return NotFound;
+            }
+            qToLittleEndian<quint16>(static_cast<quint16>(mapped), target + i * 2);
+        }
+    } else if (syllableCount > 0) {
+        std::memcpy(target, syllables, syllableCount * 2);
+    }
+    m_words.insert(m_words.end(), word, word + wordBytes);
+    return commit(syllableStart, wordStart);
+}
+
+quint32 SCDDictionary::append(const quint16 *syllables, int syllableCount, const char16_t *word, int wordLength)
+{
+    const size_t syllableStart = m_syllables.size();
+    const size_t wordStart = m_words.size();
+    const int wordBytes = wordLength * 2;
+    if (syllableCount < 0 || syllableCount > MaxSyllables || wordLength < 0 || wordBytes > MaxWordBytes
+        || (syllableStart + syllableCount * 2) / 2 > 0xFFFFFFFFu || wordStart + wordBytes > 0xFFFFFFFFu) {
+        return NotFound;
+    }
+    m_syllables.resize(syllableStart + syllableCount * 2);
+    qToLittleEndian<quint16>(syllables, syllableCount, m_syllables.data() + syllableStart);
+    m_words.resize(wordStart + wordBytes);
+    qToLittleEndian<quint16>(word, wordLength, m_words.data() + wordStart);
+    return commit(syllableStart, wordStart);
+}
+
+bool SCDDictionary::matches(quint32 i, const uchar *syllables, int syllableCount, const uchar *word,
+                            int wordBytes) const
+{
+    return this->syllableCount(i) == syllableCount && this->wordBytes(i) == wordBytes
+           && (syllableCount == 0
+               || std::memcmp(m_syllables.data() + size_t(m_syllableOffsets[i]) * 2, syllables, syllableCount * 2) == 0)
+           && std::memcmp(m_words.data() + m_wordOffsets[i], word, wordBytes) == 0;
+}
+
+quint32 SCDDictionary::lookup(const uchar *syllables, int syllableCount, const uchar *word, int wordBytes,
+                              quint32 h, size_t *slot) const
+{
+    if (m_slots.empty()) {
+        return NotFound;
+    }
+    const size_t mask = m_slots.size() - 1;
+    for (size_t pos = h & mask;; pos = (pos + 1) & mask) {
+        const quint64 value = m_slots[pos];
+        if (value == 0) {
+            *slot = pos;
+            return NotFound;
+        }
+        const quint32 i = quint32(value) - 1;
+        if (quint32(value >> 32) == h && matches(i, syllables, syllableCount, word, wordBytes)) {
+            *slot = pos;
+            return i;
+        }
+    }
+}
+
+void SCDDictionary::growIndex()
+{
+    std::vector<quint64> old(qMax<size_t>(1024, m_slots.size() * 2), 0);
+    old.swap(m_slots);
+    const size_t mask = m_slots.size() - 1;
+    for (quint64 value : old) {
+        if (value == 0) {
+            continue;
+        }
+        size_t pos = (value >> 32) & mask;
+        while (m_slots[pos] != 0) {
+            pos = (pos + 1) & mask;
+        }
+        m_slots[pos] = value;
+    }
+}
+
+quint32 SCDDictionary::insert(const uchar *syllables, int syllableCount, const uchar *word, int wordBytes,
+                              const std::vector<int> *remap, bool *inserted)
+{
+    if (inserted) {
+        *inserted = false;
+    }
+    if ((size_t(m_indexed) + 1) * 2 > m_slots.size()) {
+        growIndex();
+    }
+
+    // 不需换算音节时直接查找；需要换算时先追加（换算后才能比较），已存在时再撤销
+    size_t slot = 0;
+    quint32 i = NotFound;
+    if (!remap) {
+        const quint32 h = hashOf(syllables, syllableCount * 2, word, wordBytes);
+        const quint32 existing = lookup(syllables, syllableCount, word, wordBytes, h, &slot);
+        if (existing != NotFound) {
+            return existing;
+        }
+        i = append(syllables, syllableCount, word, wordBytes);
+        if (i == NotFound) {
+            return NotFound;
+        }
+    } else {
+        i = append(syllables, syllableCount, word, wordBytes, remap);
+        if (i == NotFound) {
+            return NotFound;
+        }
+        const SCDEntryView entry = view(i);
+        const quint32 existing = lookup(entry.syllables, entry.syllableCount, entry.word, entry.wordBytes,
+                                        m_hashes[i], &slot);
+        if (existing != NotFound) {
+            removeLast();
+            return existing;
+        }
+    }
+    m_slots[slot] = quint64(m_hashes[i]) << 32 | (quint64(i) + 1);
+    ++m_indexed;
+    if (inserted) {
+        *inserted = true;
+    }
+    return i;
+}
+
+quint32 SCDDictionary::find(const uchar *syllables, int syllableCount, const uchar *word, int wordBytes) const
+{
+    size_t slot = 0;
+    return lookup(syllables, syllableCount, word, wordBytes,
+                  hashOf(syllables, syllableCount * 2, word, wordBytes), &slot);
+}
+
+SCDEntryView SCDDictionary::view(quint32 i) const
+{
+    SCDEntryView entry = {};
+    entry.syllables = m_syllables.data() + size_t(m_syllableOffsets[i]) * 2;
+    entry.syllableCount = syllableCount(i);
+    entry.word = m_words.data() + m_wordOffsets[i];
+    entry.wordBytes = wordBytes(i);
+    return entry;
+}
+
+int SCDDictionary::compareSyllables(quint32 a, quint32 b) const
+{
+    const uchar *x = m_syllables.data() + size_t(m_syllableOffsets[a]) * 2;
+    const uchar *y = m_syllables.data() + size_t(m_syllableOffsets[b]) * 2;
+    const int n = qMin(syllableCount(a), syllableCount(b));
+    for (int i = 0; i < n; ++i) {
+        const quint16 u = qFromLittleEndian<quint16>(x + i * 2);
+        const quint16 v = qFromLittleEndian<quint16>(y + i * 2);
+        if (u != v) {
+            return u < v ? -1 : 1;
+        }
+    }
+    return syllableCount(a) - syllableCount(b);
+}
+
+bool SCDDictionary::sameWord(quint32 a, quint32 b) const
+{
+    return wordBytes(a) == wordBytes(b)
+           && std::memcmp(m_words.data() + m_wordOffsets[a], m_words.data() + m_wordOffsets[b], wordBytes(a)) == 0;
+}
+
+std::vector<quint32> SCDDictionary::sortedOrder(bool dedup, qint64 *duplicates) const
+{
+    std::vector<SortKey> keys(size());
+    for (quint32 i = 0; i < size(); ++i) {
+        const quint64 key = sortKeyOf(m_syllables.data() + size_t(m_syllableOffsets[i]) * 2, syllableCount(i));
+        keys[i] = {static_cast<quint32>(key >> 32), static_cast<quint32>(key), i};
+    }
+    // 键不同即可判定；键相同且有一方超过三个音节时才比较完整的音节序列，最后按追加顺序
+    std::sort(keys.begin(), keys.end(), [this](const SortKey &a, const SortKey &b) {
+        if (a.high != b.high) {
+            return a.high < b.high;
+        }
+        if (a.low != b.low) {
+            return a.low < b.low;
+        }
+        if (syllableCount(a.index) > 3 || syllableCount(b.index) > 3) {
+            const int c = compareSyllables(a.index, b.index);
+            if (c != 0) {
+                return c < 0;
+            }
+        }
+        return a.index < b.index;
+    });
+
+    std::vector<quint32> order(keys.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        order[i] = keys[i].index;
+    }
+    if (duplicates) {
+        *duplicates = 0;
+    }
+    if (!dedup) {
+        return order;
+    }
+
+    // 组内去重：组小时两两比较哈希，组大时按（哈希, 位置）排序后只比较哈希相同的相邻项；
+    // 重复项先标记为 NotFound，最后统一移除
+    std::vector<std::pair<quint32, quint32>> scratch;
+    qint64 removed = 0;
+    for (size_t begin = 0; begin < order.size();) {
+        const size_t end = groupEnd(order, begin, order.size());
+        if (end - begin <= 16) {
+            for (size_t j = begin + 1; j < end; ++j) {
+                for (size_t k = begin; k < j; ++k) {
+                    if (order[k] != NotFound && m_hashes[order[k]] == m_hashes[order[j]]
+                        && sameWord(order[k], order[j])) {
+                        order[j] = NotFound;
+                        ++removed;
+                        break;
+                    }
+                }
+            }
+        } else {
+            scratch.clear();
+            for (size_t j = begin; j < end; ++j) {
+                scratch.emplace_back(m_hashes[order[j]], static_cast<quint32>(j));
+            }
+            std::sort(scratch.begin(), scratch.end());
+            for (size_t run = 0; run < scratch.size();) {
+                size_t runEnd = run + 1;
+                while (runEnd < scratch.size() && scratch[runEnd].first == scratch[run].first) {
+                    ++runEnd;
+                }
+                for (size_t j = run + 1; j < runEnd; ++j) {
+                    for (size_t k = run; k < j; ++k) {
+                        const quint32 kept = order[scratch[k].second];
+                        if (kept != NotFound && sameWord(kept, order[scratch[j].second])) {
+                            order[scratch[j].second] = NotFound;
+                            ++removed;
+                            break;
+                        }
+                    }
+                }
+                run = runEnd;
+            }
+        }
+        begin = end;
+    }
+    if (removed > 0) {
+        order.erase(std::remove(order.begin(), order.end(), NotFound), order.end());
+    }
+    if (duplicates) {
+        *duplicates = removed;
+    }
+    return order;
+}
+
+size_t SCDDictionary::groupEnd(const std::vector<quint32> &order, size_t begin, size_t maxWords) const
+{
+    size_t end = begin + 1;
+    while (end < order.size() && end - begin < maxWords && compareSyllables(order[begin], order[end]) == 0) {
+        ++end;
+    }
+    return end;
+}
+
+size_t SCDDictionary::memoryUsage() const
+{
+    return m_syllableOffsets.capacity() * sizeof(quint32) + m_wordOffsets.capacity() * sizeof(quint32)
+           + m_hashes.capacity() * sizeof(quint32) + m_syllables.capacity() + m_words.capacity();
+}
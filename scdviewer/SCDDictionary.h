@@ -0,0 +1,122 @@
+#ifndef SCDDICTIONARY_H
+#define SCDDICTIONARY_H
+
+#include "SCDEntryReader.h"
+#include <QByteArray>
+#include <QtGlobal>
+#include <vector>
+
+/**
+ * 列式内存词库：生成、合并、比较、trie 导出和词条表格共用的词条容器
+ *
+ * 每个词条不单独分配内存。音节下标（uint16 小端）和词（UTF-16LE，与文件中相同）分别首尾相接地
+ * 存在两块连续内存里，词条本身只是三列定长的数组：音节偏移、词偏移（长度由下一条的偏移相减得到）
+ * 和哈希，每条 12 字节。view() 直接给出指向存储区的 SCDEntryView，写文件、转文本都不必再转换。
+ *
+ * 排序先为每个词条取前三个音节拼成 63 位键，在一块连续的（键, 下标）数组上排序，
+ * 键相同时才比较完整的音节序列；去重只在同一拼音组内按哈希列进行。
+ * 需要按（音节序列, 词）查找时用 insert() / find()，哈希索引在第一次 insert() 时建立。
+ * clear() 保留已分配的容量，逐组复用时不会反复分配。
+ */
+class SCDDictionary
+{
+public:
+    static constexpr quint32 NotFound = 0xFFFFFFFFu;
+
+    // 细胞词库中音节下标字节数和词字节数都是 uint16
+    static constexpr int MaxSyllables = 0x7FFF;
+    static constexpr int MaxWordBytes = 0xFFFE;
+
+    SCDDictionary();
+
+    quint32 size() const { return static_cast<quint32>(m_hashes.size()); }
+    bool isEmpty() const { return m_hashes.empty(); }
+
+    // 预留词条数、音节数和词的总字节数
+    void reserve(size_t entries, size_t syllables, size_t wordBytes);
+
+    // 清空词条和索引，保留容量
+    void clear();
+
+    /**
+     * 追加一条词条（音节下标为 uint16 小端，词为 UTF-16LE），返回下标；
+     * 音节数或词长超出上限、存储区超过 4 GB 时返回 NotFound。
+     * remap 不为空时音节下标先经 remap 换算，遇到越界或 -1 时同样返回 NotFound
+     */
+    quint32 append(const uchar *syllables, int syllableCount, const uchar *word, int wordBytes,
+                   const std::vector<int> *remap = nullptr);
+    quint32 append(const SCDEntryView &entry, const std::vector<int> *remap = nullptr)
+    {
+        return append(entry.syllables, entry.syllableCount, entry.word, entry.wordBytes, remap);
+    }
+
+    // 追加主机字节序的音节下标和 UTF-16 词（由文本解析得到的词条）
+    quint32 append(const quint16 *syllables, int syllableCount, const char16_t *word, int wordLength);
+
+    /**
+     * 按（音节序列, 词）去重地追加：已有相同词条时不追加，返回已有词条的下标，*inserted 为 false；
+     * 无法追加时（同 append）返回 NotFound。只有经 insert() 加入的词条会被 find() / insert() 找到
+     */
+    quint32 insert(const uchar *syllables, int syllableCount, const uchar *word, int wordBytes,
+                   const std::vector<int> *remap = nullptr, bool *inserted = nullptr);
+    quint32 insert(const SCDEntryView &entry, const std::vector<int> *remap = nullptr, bool *inserted = nullptr)
+    {
+        return insert(entry.syllables, entry.syllableCount, entry.word, entry.wordBytes, remap, inserted);
+    }
+    quint32 find(const uchar *syllables, int syllableCount, const uchar *word, int wordBytes) const;
+    quint32 find(const SCDEntryView &entry) const
+    {
+        return find(entry.syllables, entry.syllableCount, entry.word, entry.wordBytes);
+    }
+
+    // 第 i 个词条
+    SCDEntryView view(quint32 i) const;
+    int syllableCount(quint32 i) const { return static_cast<int>(m_syllableOffsets[i + 1] - m_syllableOffsets[i]); }
+    quint16 syllableAt(quint32 i, int k) const
+    {
+        return qFromLittleEndian<quint16>(m_syllables.data() + (size_t(m_syllableOffsets[i]) + k) * 2);
+    }
+    const uchar *word(quint32 i) const { return m_words.data() + m_wordOffsets[i]; }
+    int wordBytes(quint32 i) const { return static_cast<int>(m_wordOffsets[i + 1] - m_wordOffsets[i]); }
+    quint32 hash(quint32 i) const { return m_hashes[i]; }
+
+    // 音节序列按下标逐个比较，前缀在前
+    int compareSyllables(quint32 a, quint32 b) const;
+    bool sameWord(quint32 a, quint32 b) const;
+
+    /**
+     * 按音节序列排序后的下标，音节序列相同的保持追加顺序（稳定）。
+     * dedup 为 true 时去掉音节序列和词都相同的词条，只保留最早追加的一条，去掉的条数记入 *duplicates
+     */
+    std::vector<quint32> sortedOrder(bool dedup, qint64 *duplicates = nullptr) const;
+
+    // order 中从 begin 开始的拼音组（音节序列相同）的结尾，最多 maxWords 个词
+    size_t groupEnd(const std::vector<quint32> &order, size_t begin, size_t maxWords) const;
+
+    // 词条列和存储区占用的字节数（不含哈希索引）
+    size_t memoryUsage() const;
+
+    static quint32 hashOf(const uchar *syllables, int syllableBytes, const uchar *word, int wordBytes);
+
+private:
+    quint32 commit(size_t syllableStart, size_t wordStart);
+    void removeLast();
+    quint32 lookup(const uchar *syllables, int syllableCount, const uchar *word, int wordBytes, quint32 h,
+                   size_t *slot) const;
+    bool matches(quint32 i, const uchar *syllables, int syllableCount, const uchar *word, int wordBytes) const;
+    void growIndex();
+
+    // 第 i 条位于 [offsets[i], offsets[i + 1])，两列都比词条数多一项
+    std::vector<quint32> m_syllableOffsets; // 以音节为单位
+    std::vector<quint32> m_wordOffsets;     // 以字节为单位
+    std::vector<quint32> m_hashes;
+    std::vector<uchar> m_syllables;         // uint16 小端
+    std::vector<uchar> m_words;             // UTF-16LE
+
+    // 开放寻址哈希索引（线性探测）：槽的高 32 位为哈希，低 32 位为词条下标 + 1，0 表示空槽。
+    // 哈希放在槽里，探测时不必访问哈希列
+    std::vector<quint64> m_slots;
+    quint32 m_indexed = 0;
+};
+
+#endif // SCDDICTIONARY_H
@@ -0,0 +1,149 @@
+#include "SCDDiff.h"
+#include "SCDDictionary.h"
+#include "SCDEntryReader.h"
+#include <QFile>
+#include <QHash>
+#include <vector>
+
+namespace {
+
+// 旧词库词条的状态，与 SCDDictionary 中的下标一一对应
+enum RecordState : uchar {
+    Unmatched = 0,   // 新词库中尚未出现
+    Matched = 1,     // 新词库中也有
+    Unmatchable = 2, // 音节不在新词库的拼音表中，一定是删除；音节下标保留旧词库的
+};
+
+// 把词条写成文本行，缓冲区攒满时写出
+bool appendLine(QFile &out, QByteArray &buffer, const SCDPinyinTable &pinyin, const SCDEntryView &entry)
+{
+    if (!SCDEntryText::appendEntry(buffer, pinyin, entry)) {
+        return true;
+    }
+    if (buffer.size() >= SCDEntryReader::BufferSize) {
+        if (out.write(buffer) != buffer.size()) {
+            return false;
+        }
+        buffer.resize(0);
+    }
+    return true;
+}
+
+} // namespace
+
+bool SCDDiff::compare(const QString &oldPath, const QString &newPath,
+                      const QString &addedPath, const QString &removedPath)
+{
+    m_added = m_removed = m_unchanged = 0;
+
+    SCDEntryReader oldReader;
+    SCDEntryReader newReader;
+    if (!oldReader.open(oldPath)) {
+        m_error = oldPath + ": " + oldReader.errorString();
+        return false;
+    }
+    if (!newReader.open(newPath)) {
+        m_error = newPath + ": " + newReader.errorString();
+        return false;
+    }
+
+    // 旧词库的音节下标 -> 新词库的音节下标（按音节文本对应），-1 表示新词库中没有
+    const SCDPinyinTable oldPinyin = oldReader.pinyinTable();
+    const SCDPinyinTable &newPinyin = newReader.pinyinTable();
+    const QHash<QByteArray, quint16> newIndex = newPinyin.syllableIndex();
+    std::vector<int> remap(oldPinyin.size(), -1);
+    for (int i = 0; i < oldPinyin.size(); ++i) {
+        int length = 0;
+        if (const char *text = oldPinyin.syllable(static_cast<quint16>(i), &length)) {
+            remap[i] = newIndex.value(QByteArray::fromRawData(text, length), -1);
+        }
+    }
+
+    // 1. 旧词库全部存入列式词库：能换成新词库音节下标的去重登记进索引，不能的原样追加
+    SCDDictionary entries;
+    std::vector<uchar> states;
+    entries.reserve(oldReader.phraseCount(), size_t(oldReader.phraseCount()) * 3,
+                    size_t(oldReader.phraseCount()) * 6);
+    states.reserve(oldReader.phraseCount());
+    SCDEntryView entry;
+    while (oldReader.next(entry)) {
+        bool inserted = false;
+        if (entries.insert(entry, &remap, &inserted) != SCDDictionary::NotFound) {
+            if (inserted) {
+                states.push_back(Unmatched);
+            }
+            continue; // 未插入即旧词库内的重复词条
+        }
+        if (entries.append(entry) != SCDDictionary::NotFound) {
+            states.push_back(Unmatchable);
+        }
+    }
+    if (oldReader.hasError()) {
+        m_error = oldPath + ": " + oldReader.errorString();
+        return false;
+    }
+    oldReader.close();
+    const quint32 oldCount = entries.size();
+
+    QFile added(addedPath);
+    QFile removed(removedPath);
+    if (!added.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_error = "无法写入文件: " + addedPath;
+        return false;
+    }
+    if (!removed.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_error = "无法写入文件: " + removedPath;
+        return false;
+    }
+
+    // 2. 顺序读新词库逐条查表：查不到的是新增，查到的标记为未变。
+    // 新增词条也登记进索引（状态为已匹配），新词库内重复的新增词条只输出一次
+    QByteArray buffer;
+    buffer.reserve(SCDEntryReader::BufferSize + 4096);
+    while (newReader.next(entry)) {
+        bool inserted = false;
+        const quint32 index = entries.insert(entry, nullptr, &inserted);
+        if (index != SCDDictionary::NotFound && !inserted) {
+            if (states[index] == Unmatched) {
+                states[index] = Matched;
+                ++m_unchanged;
+            }
+            continue;
+        }
+        if (inserted) {
+            states.push_back(Matched);
+        }
+        if (!appendLine(added, buffer, newPinyin, entry)) {
+            m_error = "写入文件失败: " + addedPath;
+            return false;
+        }
+        ++m_added;
+    }
+    if (newReader.hasError()) {
+        m_error = newPath + ": " + newReader.errorString();
+        return false;
+    }
+    if (added.write(buffer) != buffer.size()) {
+        m_error = "写入文件失败: " + addedPath;
+        return false;
+    }
+    buffer.resize(0);
+
+    // 3. 旧词库中没有被查到的是删除
+    for (quint32 i = 0; i < oldCount; ++i) {
+        if (states[i] == Matched) {
+            continue;
+        }
+        const SCDPinyinTable &pinyin = states[i] == Unmatchable ? oldPinyin : newPinyin;
+        if (!appendLine(removed, buffer, pinyin, entries.view(i))) {
+            m_error = "写入文件失败: " + removedPath;
+            return false;
+        }
+        ++m_removed;
+    }
+    if (removed.write(buffer) != buffer.size()) {
+        m_error = "写入文件失败: " + removedPath;
+        return false;
+    }
+    return true;
+}
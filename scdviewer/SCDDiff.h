@@ -0,0 +1,37 @@
+#ifndef SCDDIFF_H
+#define SCDDIFF_H
+
+#include <QString>
+#include <QtGlobal>
+
+/**
+ * 两个版本细胞词库的词条差异
+ *
+ * 旧词库的全部（音节序列, 词）先按新词库的拼音表换成音节下标，存进列式词库 SCDDictionary
+ * 并登记进其哈希索引；再顺序读一遍新词库逐条查表，查不到的即为新增，
+ * 最后旧词库中没有被查到的即为删除。两个文件各读一遍，时间与词条数成线性关系。
+ *
+ * 结果写成两个搜狗文本词库（'a'b 词），可以直接用作 --add / --remove 的输入；
+ * 新增按新词库中的顺序、删除按旧词库中的顺序输出。词库内重复的词条只算一次。
+ */
+class SCDDiff
+{
+public:
+    // 比较两个词库，把新增和删除的词条分别写到 addedPath / removedPath
+    bool compare(const QString &oldPath, const QString &newPath,
+                 const QString &addedPath, const QString &removedPath);
+
+    qint64 addedCount() const { return m_added; }
+    qint64 removedCount() const { return m_removed; }
+    qint64 unchangedCount() const { return m_unchanged; }
+
+    QString errorString() const { return m_error; }
+
+private:
+    qint64 m_added = 0;
+    qint64 m_removed = 0;
+    qint64 m_unchanged = 0;
+    QString m_error;
+};
+
+#endif // SCDDIFF_H
@@ -0,0 +1,245 @@
+#include "SCDEntryModel.h"
+#include "SCDChecksum.h"
+#include "SCDHeader.h"
+#include "SCDText.h"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+namespace {
+
+// 检查点文件：魔法字节, uint64 词库大小, 16 字节校验和, uint32 每段拼音组数, uint32 检查点数,
+// 之后每个检查点 uint64 偏移 + uint32 行号
+constexpr char checkpointMagic[8] = {'S', 'C', 'D', 'C', 'K', 'P', 'T', '1'};
+constexpr int checkpointHeaderSize = 8 + 8 + SCDChecksum::Size + 4 + 4;
+constexpr int checkpointRecordSize = 12;
+
+} // namespace
+
+SCDEntryModel::SCDEntryModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+QString SCDEntryModel::cachePath(const QString &scelPath)
+{
+    const QByteArray key = QCryptographicHash::hash(QFileInfo(scelPath).absoluteFilePath().toUtf8(),
+                                                    QCryptographicHash::Sha1).toHex();
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+           + "/scdtool/entries/" + QString::fromLatin1(key) + ".ckpt";
+}
+
+bool SCDEntryModel::open(const QString &scelPath)
+{
+    beginResetModel();
+    m_checkpoints.clear();
+    m_blocks.clear();
+    m_error.clear();
+
+    SCDHeader header;
+    bool ok = header.load(scelPath) && m_reader.open(scelPath);
+    if (!ok) {
+        m_error = m_reader.hasError() ? m_reader.errorString() : "非法的细胞词库文件头！";
+    } else {
+        const quint64 sourceSize = static_cast<quint64>(QFileInfo(scelPath).size());
+        const QByteArray checksum = header.data().mid(SCDChecksum::Offset, SCDChecksum::Size);
+        const QString path = cachePath(scelPath);
+        if (!loadCheckpoints(path, sourceSize, checksum)) {
+            ok = scan();
+            if (ok) {
+                saveCheckpoints(path, sourceSize, checksum);
+            }
+        }
+    }
+    if (!ok) {
+        m_checkpoints.clear();
+    }
+    m_blocks.resize(CachedBlocks);
+    endResetModel();
+    return ok;
+}
+
+bool SCDEntryModel::scan()
+{
+    // 只遍历不解码：组首词条出现时，读取前的位置就是该组的偏移
+    quint32 rows = 0;
+    SCDEntryView entry;
+    for (;;) {
+        const qint64 position = m_reader.position();
+        if (!m_reader.next(entry)) {
+            break;
+        }
+        if (entry.firstInGroup && entry.group % GroupsPerCheckpoint == 0) {
+            m_checkpoints.push_back({position, rows});
+        }
+        ++rows;
+    }
+    if (m_reader.hasError()) {
+        m_error = m_reader.errorString();
+        return false;
+    }
+    m_checkpoints.push_back({m_reader.position(), rows});
+    return true;
+}
+
+bool SCDEntryModel::loadCheckpoints(const QString &path, quint64 sourceSize, const QByteArray &checksum)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const QByteArray data = file.readAll();
+    const uchar *p = reinterpret_cast<const uchar *>(data.constData());
+    if (data.size() < checkpointHeaderSize || std::memcmp(p, checkpointMagic, sizeof(checkpointMagic)) != 0
+        || qFromLittleEndian<quint64>(p + 8) != sourceSize
+        || std::memcmp(p + 16, checksum.constData(), SCDChecksum::Size) != 0
+        || qFromLittleEndian<quint32>(p + 16 + SCDChecksum::Size) != GroupsPerCheckpoint) {
+        return false;
+    }
+    const quint32 count = qFromLittleEndian<quint32>(p + 20 + SCDChecksum::Size);
+    if (count == 0 || data.size() != checkpointHeaderSize + static_cast<qint64>(count) * checkpointRecordSize) {
+        return false;
+    }
+
+    m_checkpoints.resize(count);
+    p += checkpointHeaderSize;
+    for (Checkpoint &checkpoint : m_checkpoints) {
+        checkpoint.offset = qFromLittleEndian<qint64>(p);
+        checkpoint.firstRow = qFromLittleEndian<quint32>(p + 8);
+        p += checkpointRecordSize;
+    }
+    return true;
+}
+
+void SCDEntryModel::saveCheckpoints(const QString &path, quint64 sourceSize, const QByteArray &checksum) const
+{
+    QByteArray data(checkpointHeaderSize + static_cast<qint64>(m_checkpoints.size()) * checkpointRecordSize,
+                    Qt::Uninitialized);
+    uchar *p = reinterpret_cast<uchar *>(data.data());
+    std::memcpy(p, checkpointMagic, sizeof(checkpointMagic));
+    qToLittleEndian<quint64>(sourceSize, p + 8);
+    std::memcpy(p + 16, checksum.constData(), SCDChecksum::Size);
+    qToLittleEndian<quint32>(GroupsPerCheckpoint, p + 16 + SCDChecksum::Size);
+    qToLittleEndian<quint32>(static_cast<quint32>(m_checkpoints.size()), p + 20 + SCDChecksum::Size);
+    p += checkpointHeaderSize;
+    for (const Checkpoint &checkpoint : m_checkpoints) {
+        qToLittleEndian<qint64>(checkpoint.offset, p);
+        qToLittleEndian<quint32>(checkpoint.firstRow, p + 8);
+        p += checkpointRecordSize;
+    }
+
+    // 缓存写不出时下次重新扫描即可
+    QDir().mkpath(QFileInfo(path).path());
+    QSaveFile out(path);
+    if (out.open(QIODevice::WriteOnly) && out.write(data) == data.size()) {
+        out.commit();
+    }
+}
+
+const SCDEntryModel::Block &SCDEntryModel::block(int index) const
+{
+    Block *target = &m_blocks.front();
+    for (Block &cached : m_blocks) {
+        if (cached.index == index) {
+            cached.lastUsed = ++m_useCounter;
+            return cached;
+        }
+        if (cached.lastUsed < target->lastUsed) {
+            target = &cached;
+        }
+    }
+
+    target->index = index;
+    target->lastUsed = ++m_useCounter;
+    target->entries.clear();
+
+    const Checkpoint &begin = m_checkpoints[index];
+    const quint32 rows = m_checkpoints[index + 1].firstRow - begin.firstRow;
+    if (!m_reader.seekGroup(begin.offset, static_cast<quint32>(index) * GroupsPerCheckpoint)) {
+        return *target;
+    }
+
+    // 原样存入音节下标和 UTF-16LE 词；超出上限的词条存为空行，保持行号对应
+    SCDEntryView entry;
+    for (quint32 i = 0; i < rows && m_reader.next(entry); ++i) {
+        if (target->entries.append(entry) == SCDDictionary::NotFound) {
+            target->entries.append(static_cast<const uchar *>(nullptr), 0, nullptr, 0);
+        }
+    }
+    return *target;
+}
+
+QString SCDEntryModel::text(const Block &cached, quint32 offset, int column) const
+{
+    QByteArray text;
+    if (column == 1) {
+        SCDText::appendUtf8(text, cached.entries.word(offset), cached.entries.wordBytes(offset));
+        return QString::fromUtf8(text);
+    }
+
+    const SCDPinyinTable &pinyin = m_reader.pinyinTable();
+    for (int k = 0; k < cached.entries.syllableCount(offset); ++k) {
+        int length = 0;
+        const char *syllable = pinyin.syllable(cached.entries.syllableAt(offset, k), &length);
+        if (k > 0) {
+            text.append('\'');
+        }
+        if (syllable) {
+            text.append(syllable, length);
+        } else {
+            text.append('?');
+        }
+    }
+    return QString::fromUtf8(text);
+}
+
+int SCDEntryModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid() || m_checkpoints.empty()) {
+        return 0;
+    }
+    return static_cast<int>(qMin<quint32>(m_checkpoints.back().firstRow, INT_MAX));
+}
+
+int SCDEntryModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : 2;
+}
+
+QVariant SCDEntryModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || role != Qt::DisplayRole || index.row() >= rowCount()) {
+        return {};
+    }
+
+    // 最后一个检查点之前、首行不大于 row 的检查点即为所在段
+    const quint32 row = static_cast<quint32>(index.row());
+    auto it = std::upper_bound(m_checkpoints.begin(), m_checkpoints.end() - 1, row,
+                               [](quint32 value, const Checkpoint &checkpoint) { return value < checkpoint.firstRow; });
+    const int blockIndex = static_cast<int>(it - m_checkpoints.begin()) - 1;
+    const Block &cached = block(blockIndex);
+
+    const quint32 offset = row - m_checkpoints[blockIndex].firstRow;
+    if (offset >= cached.entries.size()) {
+        return {};
+    }
+    return text(cached, offset, index.column());
+}
+
+QVariant SCDEntryModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (role != Qt::DisplayRole) {
+        return {};
+    }
+    if (orientation == Qt::Vertical) {
+        return section + 1;
+    }
+    return section == 0 ? QString("拼音") : QString("词");
+}
@@ -0,0 +1,71 @@
+#ifndef SCDENTRYMODEL_H
+#define SCDENTRYMODEL_H
+
+#include "SCDDictionary.h"
+#include "SCDEntryReader.h"
+#include <QAbstractTableModel>
+#include <QString>
+#include <vector>
+
+/**
+ * 词条表格模型（拼音、词两列），按需解码
+ *
+ * 打开时只扫描一遍词条区，每 GroupsPerCheckpoint 个拼音组记一个检查点（文件偏移 + 首行行号），
+ * 检查点存入 ~/.cache/scdtool/entries/，词库大小和校验和不变时下次直接载入。
+ * 显示某一行时二分找到所在检查点，从该处读入这一段拼音组；最近用过的 CachedBlocks 段保留在内存中，
+ * 每段是一个列式词库（SCDDictionary，逐段清空复用），只在显示时才转成 QString，
+ * 内存占用只与可见行数有关，与词库大小无关。
+ */
+class SCDEntryModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    static constexpr quint32 GroupsPerCheckpoint = 64;
+    static constexpr int CachedBlocks = 16;
+
+    explicit SCDEntryModel(QObject *parent = nullptr);
+
+    // 打开词库并建立（或载入）检查点
+    bool open(const QString &scelPath);
+
+    QString errorString() const { return m_error; }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    // 检查点缓存文件路径
+    static QString cachePath(const QString &scelPath);
+
+private:
+    struct Checkpoint {
+        qint64 offset;    // 拼音组在文件中的偏移
+        quint32 firstRow; // 该组第一个词条的行号
+    };
+
+    struct Block {
+        int index = -1;
+        quint64 lastUsed = 0;
+        SCDDictionary entries;
+    };
+
+    bool scan();
+    bool loadCheckpoints(const QString &path, quint64 sourceSize, const QByteArray &checksum);
+    void saveCheckpoints(const QString &path, quint64 sourceSize, const QByteArray &checksum) const;
+
+    // 读入第 index 段（缓存中没有时替换最久未用的一段）
+    const Block &block(int index) const;
+
+    // 段内第 offset 行的拼音（column 0）或词（column 1）
+    QString text(const Block &cached, quint32 offset, int column) const;
+
+    mutable SCDEntryReader m_reader;
+    std::vector<Checkpoint> m_checkpoints; // 最后一项为结束位置和总行数
+    mutable std::vector<Block> m_blocks;
+    mutable quint64 m_useCounter = 0;
+    QString m_error;
+};
+
+#endif // SCDENTRYMODEL_H
@@ -0,0 +1,404 @@
+#include "SCDEntryReader.h"
+#include "SCDHeader.h"
+#include "SCDProgress.h"
+#include "SCDStats.h"
+#include "SCDText.h"
+#include <QElapsedTimer>
+#include <QSaveFile>
+#include <cstring>
+
+// 拼音表起始偏移（紧跟固定文件头之后）
+static constexpr qint64 pinyinTableStart = SCDHeader::HeaderSize;
+
+// 拼音表最大字节数：音节数 uint16 以内，每个音节不超过几十字节
+static constexpr qint64 pinyinTableMaxSize = 64 * 1024;
+
+bool SCDPinyinTable::parse(const uchar *data, qint64 size, qint64 *consumed)
+{
+    m_pool.clear();
+    m_offsets.assign(1, 0);
+
+    if (size < 4) {
+        return false;
+    }
+    const quint32 count = qFromLittleEndian<quint32>(data);
+    if (count == 0 || count > 0xFFFF) {
+        return false;
+    }
+
+    // 音节按下标排布，先收集再拼接
+    std::vector<QByteArray> syllables(count);
+    qint64 pos = 4;
+    for (quint32 i = 0; i < count; ++i) {
+        if (pos + 4 > size) {
+            return false;
+        }
+        const quint16 index = qFromLittleEndian<quint16>(data + pos);
+        const quint16 length = qFromLittleEndian<quint16>(data + pos + 2);
+        pos += 4;
+        if (pos + length > size || index >= count) {
+            return false;
+        }
+        SCDText::appendUtf8(syllables[index], data + pos, length);
+        pos += length;
+    }
+
+    m_offsets.reserve(count + 1);
+    for (const QByteArray &syllable : syllables) {
+        m_pool.append(syllable);
+        m_offsets.push_back(static_cast<int>(m_pool.size()));
+    }
+
+    *consumed = pos;
+    return true;
+}
+
+QHash<QByteArray, quint16> SCDPinyinTable::syllableIndex() const
+{
+    QHash<QByteArray, quint16> index;
+    index.reserve(size());
+    for (int i = 0; i < size(); ++i) {
+        int length = 0;
+        if (const char *text = syllable(static_cast<quint16>(i), &length)) {
+            index.insert(QByteArray(text, length), static_cast<quint16>(i));
+        }
+    }
+    return index;
+}
+
+QByteArray SCDPinyinTable::builtinData()
+{
+    static const QByteArray data = []() {
+        QFile file(":/pinyin.bin");
+        if (!file.open(QIODevice::ReadOnly)) {
+            return QByteArray();
+        }
+        QByteArray bytes = file.readAll();
+        SCDPinyinTable table;
+        qint64 consumed = 0;
+        if (!table.parse(reinterpret_cast<const uchar *>(bytes.constData()), bytes.size(), &consumed)) {
+            return QByteArray();
+        }
+        bytes.truncate(consumed);
+        return bytes;
+    }();
+    return data;
+}
+
+SCDEntryReader::~SCDEntryReader()
+{
+    close();
+}
+
+bool SCDEntryReader::fail(const QString &message)
+{
+    if (m_error.isEmpty()) {
+        m_error = message;
+    }
+    return false;
+}
+
+bool SCDEntryReader::open(const QString &filePath)
+{
+    close();
+
+    m_file.setFileName(filePath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return fail("无法打开文件: " + filePath);
+    }
+    m_fileSize = m_file.size();
+
+    // 映射失败（如某些网络文件系统）时使用滑动缓冲区
+    m_map = m_file.map(0, m_fileSize);
+
+    // 格式在这里识别一次；两种格式的词条区布局相同，逐条解码不再区分格式
+    const qint64 probeBytes = qMin<qint64>(m_fileSize, SCDHeader::ProbeSize);
+    const uchar *headerData = probeBytes >= SCDHeader::HeaderSize ? ensure(probeBytes) : nullptr;
+    if (!headerData) {
+        return fail("文件太短，无法读取完整文件头");
+    }
+    SCDHeader header;
+    if (!header.loadFromData(QByteArray::fromRawData(reinterpret_cast<const char *>(headerData), probeBytes))) {
+        return fail("非法的细胞词库文件头！");
+    }
+    m_format = header.format();
+    m_groupTotal = header.number(SCDField::GroupCount);
+    m_phraseTotal = header.number(SCDField::PhraseCount);
+    m_pos = pinyinTableStart;
+
+    const qint64 tableBytes = qMin(m_fileSize - m_pos, pinyinTableMaxSize);
+    const uchar *tableData = ensure(tableBytes);
+    qint64 consumed = 0;
+    if (!tableData || !m_pinyin.parse(tableData, tableBytes, &consumed)) {
+        return fail("拼音表格式错误");
+    }
+    m_pos += consumed;
+    return true;
+}
+
+void SCDEntryReader::close()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    m_file.close();
+    m_fileSize = 0;
+    m_buffer.clear();
+    m_bufferStart = m_bufferLength = 0;
+    m_pos = 0;
+    m_format = SCDFormat::Unknown;
+    m_groupTotal = m_phraseTotal = m_groupIndex = 0;
+    m_wordsLeft = 0;
+    m_groupSyllableCount = 0;
+    m_error.clear();
+}
+
+const uchar *SCDEntryReader::ensure(qint64 size)
+{
+    if (m_pos + size > m_fileSize) {
+        return nullptr;
+    }
+    if (m_map) {
+        return m_map + m_pos;
+    }
+
+    qint64 offset = m_pos - m_bufferStart;
+    if (offset + size <= m_bufferLength) {
+        return reinterpret_cast<const uchar *>(m_buffer.constData()) + offset;
+    }
+
+    // 把未消费的数据移到缓冲区开头，再从文件补齐
+    const qint64 remain = m_bufferLength - offset;
+    const qint64 capacity = qMax(BufferSize, size);
+    if (m_buffer.size() < capacity) {
+        m_buffer.resize(capacity);
+    }
+    char *buffer = m_buffer.data();
+    std::memmove(buffer, buffer + offset, remain);
+    m_bufferStart = m_pos;
+    m_bufferLength = remain;
+
+    while (m_bufferLength < size) {
+        const qint64 n = m_file.read(buffer + m_bufferLength, m_buffer.size() - m_bufferLength);
+        if (n <= 0) {
+            return nullptr;
+        }
+        m_bufferLength += n;
+    }
+    return reinterpret_cast<const uchar *>(buffer);
+}
+
+bool SCDEntryReader::seekGroup(qint64 offset, quint32 group)
+{
+    if (!m_file.isOpen() || offset < pinyinTableStart || offset > m_fileSize) {
+        return fail("跳转位置超出词条区");
+    }
+    m_error.clear();
+    m_pos = offset;
+    m_groupIndex = group;
+    m_wordsLeft = 0;
+
+    // 滑动缓冲区只能向前读，跳转时丢弃已缓冲的数据
+    if (!m_map) {
+        m_bufferStart = offset;
+        m_bufferLength = 0;
+        if (!m_file.seek(offset)) {
+            return fail("无法定位到文件偏移 0x" + QString::number(offset, 16));
+        }
+    }
+    return true;
+}
+
+bool SCDEntryReader::readGroupHeader()
+{
+    // 按文件头记录的组数结束，之后可能还有黑名单等附加数据
+    if (m_groupTotal > 0 && m_groupIndex >= m_groupTotal) {
+        return false;
+    }
+    if (m_pos >= m_fileSize) {
+        if (m_groupTotal > 0) {
+            return fail(QString("词条区提前结束：已读 %1 组，应有 %2 组").arg(m_groupIndex).arg(m_groupTotal));
+        }
+        return false;
+    }
+
+    const uchar *p = ensure(4);
+    if (!p) {
+        return fail("拼音组不完整");
+    }
+    const int wordCount = qFromLittleEndian<quint16>(p);
+    const int syllableBytes = qFromLittleEndian<quint16>(p + 2);
+    if (wordCount == 0 || syllableBytes == 0 || syllableBytes % 2 != 0) {
+        return fail(QString("拼音组格式错误，偏移 0x%1").arg(QString::number(m_pos, 16)));
+    }
+
+    p = ensure(4 + syllableBytes);
+    if (!p) {
+        return fail("拼音组不完整");
+    }
+    m_groupSyllables.assign(p + 4, p + 4 + syllableBytes);
+    m_groupSyllableCount = syllableBytes / 2;
+
+    m_pos += 4 + syllableBytes;
+    m_wordsLeft = wordCount;
+    ++m_groupIndex;
+    return true;
+}
+
+bool SCDEntryReader::next(SCDEntryView &entry)
+{
+    if (hasError()) {
+        return false;
+    }
+
+    bool firstInGroup = false;
+    if (m_wordsLeft == 0) {
+        if (!readGroupHeader()) {
+            return false;
+        }
+        firstInGroup = true;
+    }
+
+    const uchar *p = ensure(2);
+    if (!p) {
+        return fail("词条不完整");
+    }
+    const int wordBytes = qFromLittleEndian<quint16>(p);
+
+    p = ensure(2 + wordBytes + 2);
+    if (!p) {
+        return fail("词条不完整");
+    }
+    const int extBytes = qFromLittleEndian<quint16>(p + 2 + wordBytes);
+
+    const qint64 total = 4 + wordBytes + extBytes;
+    p = ensure(total);
+    if (!p) {
+        return fail("词条不完整");
+    }
+
+    entry.syllables = m_groupSyllables.data();
+    entry.syllableCount = m_groupSyllableCount;
+    entry.word = p + 2;
+    entry.wordBytes = wordBytes;
+    entry.ext = p + 4 + wordBytes;
+    entry.extBytes = extBytes;
+    entry.group = m_groupIndex - 1;
+    entry.firstInGroup = firstInGroup;
+
+    m_pos += total;
+    --m_wordsLeft;
+    return true;
+}
+
+bool SCDEntryText::appendEntry(QByteArray &out, const SCDPinyinTable &pinyin, const SCDEntryView &entry)
+{
+    for (int i = 0; i < entry.syllableCount; ++i) {
+        int length = 0;
+        const char *syllable = pinyin.syllable(entry.syllableAt(i), &length);
+        if (!syllable) {
+            return false;
+        }
+        out.append('\'');
+        out.append(syllable, length);
+    }
+    out.append(' ');
+    SCDText::appendUtf8(out, entry.word, entry.wordBytes);
+    out.append('\n');
+    return true;
+}
+
+qint64 SCDEntryText::exportFile(const QString &scelPath, const QString &txtPath, QString *errorString,
+                                SCDStats *stats, SCDProgress *progress, qint64 *skippedCount)
+{
+    QElapsedTimer timer;
+    timer.start();
+
+    SCDEntryReader reader;
+    if (!reader.open(scelPath)) {
+        if (errorString) *errorString = reader.errorString();
+        return -1;
+    }
+
+    // 先写临时文件，读完且全部写入成功后才替换目标文件，失败或取消时不留下半个输出文件
+    QSaveFile out(txtPath);
+    if (!out.open(QIODevice::WriteOnly)) {
+        if (errorString) *errorString = "无法写入文件: " + txtPath;
+        return -1;
+    }
+    const auto fail = [&](const QString &message) {
+        out.cancelWriting();
+        if (errorString) *errorString = message;
+        return qint64(-1);
+    };
+
+    if (progress) {
+        progress->setTotal(reader.phraseCount());
+        progress->setPhase("decode");
+    }
+
+    // 攒满一块再写，避免逐行写入
+    QByteArray buffer;
+    buffer.reserve(SCDEntryReader::BufferSize + 4096);
+
+    // 解码与写出交替进行：只给写出计时，其余都算解码
+    qint64 writeTime = 0;
+    QElapsedTimer writeTimer;
+    qint64 count = 0;
+    qint64 skipped = 0;
+    qint64 bytesOut = 0;
+    SCDEntryView entry;
+    while (reader.next(entry)) {
+        if (!appendEntry(buffer, reader.pinyinTable(), entry)) {
+            ++skipped;
+            continue;
+        }
+        ++count;
+        if (buffer.size() >= SCDEntryReader::BufferSize) {
+            writeTimer.start();
+            const bool written = out.write(buffer) == buffer.size();
+            writeTime += writeTimer.nsecsElapsed();
+            if (!written) {
+                return fail("写入文件失败: " + txtPath);
+            }
+            bytesOut += buffer.size();
+            buffer.resize(0);
+
+            if (progress) {
+                progress->setDone(count);
+                progress->setEntries(count);
+                if (progress->isCanceled()) {
+                    return fail("已取消");
+                }
+            }
+        }
+    }
+    if (reader.hasError()) {
+        return fail(reader.errorString());
+    }
+
+    writeTimer.start();
+    const bool written = out.write(buffer) == buffer.size() && out.commit();
+    writeTime += writeTimer.nsecsElapsed();
+    if (!written) {
+        return fail("写入文件失败: " + txtPath);
+    }
+    bytesOut += buffer.size();
+    if (progress) {
+        progress->setDone(count);
+        progress->setEntries(count);
+    }
+
+    if (stats) {
+        stats->addStage("decode", timer.nsecsElapsed() - writeTime);
+        stats->addStage("write", writeTime);
+        stats->setCounter("phrases", count);
+        stats->setCounter("skipped", skipped);
+        stats->setCounter("bytesIn", reader.position());
+        stats->setCounter("bytesOut", bytesOut);
+    }
+
+    if (skippedCount) *skippedCount = skipped;
+    return count;
+}
@@ -0,0 +1,152 @@
+#ifndef SCDENTRYREADER_H
+#define SCDENTRYREADER_H
+
+#include "SCDHeader.h"
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QString>
+#include <QtEndian>
+#include <QtGlobal>
+#include <vector>
+
+class SCDProgress;
+class SCDStats;
+
+// 拼音表：音节下标 -> 音节（UTF-8），位于 0x1540 起
+class SCDPinyinTable
+{
+public:
+    // 解析拼音表，consumed 返回拼音表占用的字节数
+    bool parse(const uchar *data, qint64 size, qint64 *consumed);
+
+    int size() const { return static_cast<int>(m_offsets.size()) - 1; }
+    bool isEmpty() const { return size() <= 0; }
+
+    // 取音节，下标越界时返回 nullptr
+    const char *syllable(quint16 index, int *length) const
+    {
+        if (index >= size() || m_offsets[index] == m_offsets[index + 1]) {
+            return nullptr;
+        }
+        *length = m_offsets[index + 1] - m_offsets[index];
+        return m_pool.constData() + m_offsets[index];
+    }
+
+    // 音节 -> 下标
+    QHash<QByteArray, quint16> syllableIndex() const;
+
+    // 内置拼音表的原始数据（与 scel-maker 共用 pinyin.bin，编译进资源），生成词库时原样写入；读取失败时返回空
+    static QByteArray builtinData();
+
+private:
+    QByteArray m_pool;          // 所有音节首尾相接
+    std::vector<int> m_offsets; // 第 i 个音节位于 [m_offsets[i], m_offsets[i + 1])
+};
+
+// 词条视图：指针指向读取缓冲区，下一次调用 next() 后失效
+struct SCDEntryView {
+    const uchar *syllables; // 音节下标，uint16 小端
+    int syllableCount;
+    const uchar *word;      // UTF-16LE 词
+    int wordBytes;
+    const uchar *ext;       // 扩展信息（词频等）
+    int extBytes;
+    quint32 group;          // 所属拼音组序号
+    bool firstInGroup;
+
+    quint16 syllableAt(int i) const { return qFromLittleEndian<quint16>(syllables + i * 2); }
+};
+
+/**
+ * 细胞词库词条流式读取器（拉取式），同时读取搜狗 .scel 和 QQ 拼音 .qcel
+ *
+ * 词条区位于拼音表之后，按拼音组存放：
+ *   uint16 同音词数, uint16 音节下标字节数, uint16 音节下标...,
+ *   然后每个词：uint16 词字节数, UTF-16LE 词, uint16 扩展字节数, 扩展信息
+ * 文件优先整体映射；无法映射时退回固定大小的滑动缓冲区，内存占用与词库大小无关。
+ */
+class SCDEntryReader
+{
+public:
+    static constexpr qint64 BufferSize = 1 << 20;
+
+    SCDEntryReader() = default;
+    ~SCDEntryReader();
+
+    SCDEntryReader(const SCDEntryReader &) = delete;
+    SCDEntryReader &operator=(const SCDEntryReader &) = delete;
+
+    // 打开词库并解析拼音表
+    bool open(const QString &filePath);
+    void close();
+
+    // 读取下一个词条，读完或出错时返回 false
+    bool next(SCDEntryView &entry);
+
+    // 下一个未读字节的文件偏移；刚读完一个拼音组的最后一个词时即为下一组的起点
+    qint64 position() const { return m_pos; }
+
+    // 已读入的拼音组数（下一组的序号）
+    quint32 groupIndex() const { return m_groupIndex; }
+
+    // 跳到拼音组边界继续读取：offset 为第 group 个拼音组的文件偏移（由 position() 记下）
+    bool seekGroup(qint64 offset, quint32 group);
+
+    const SCDPinyinTable &pinyinTable() const { return m_pinyin; }
+
+    // 打开时识别出的词库格式（搜狗 .scel / QQ 拼音 .qcel）
+    SCDFormat format() const { return m_format; }
+
+    // 文件头中记录的拼音组数 / 词条数
+    quint32 groupCount() const { return m_groupTotal; }
+    quint32 phraseCount() const { return m_phraseTotal; }
+
+    bool hasError() const { return !m_error.isEmpty(); }
+    QString errorString() const { return m_error; }
+
+private:
+    // 返回当前位置起至少 size 字节的数据，数据不足时返回 nullptr
+    const uchar *ensure(qint64 size);
+    bool readGroupHeader();
+    bool fail(const QString &message);
+
+    QFile m_file;
+    uchar *m_map = nullptr;
+    qint64 m_fileSize = 0;
+
+    // 未映射时使用的滑动缓冲区
+    QByteArray m_buffer;
+    qint64 m_bufferStart = 0; // 缓冲区首字节对应的文件偏移
+    qint64 m_bufferLength = 0;
+
+    qint64 m_pos = 0; // 当前文件偏移
+
+    SCDFormat m_format = SCDFormat::Unknown;
+    SCDPinyinTable m_pinyin;
+    quint32 m_groupTotal = 0;
+    quint32 m_phraseTotal = 0;
+    quint32 m_groupIndex = 0;
+    int m_wordsLeft = 0;
+
+    // 当前拼音组的音节下标（复制出来，避免缓冲区滑动后失效）
+    std::vector<uchar> m_groupSyllables;
+    int m_groupSyllableCount = 0;
+
+    QString m_error;
+};
+
+namespace SCDEntryText {
+    // 追加一条搜狗文本格式词条（'a'b 词\n，UTF-8），音节下标非法时返回 false
+    bool appendEntry(QByteArray &out, const SCDPinyinTable &pinyin, const SCDEntryView &entry);
+
+    // 把整个细胞词库反编译为搜狗文本词库，返回写出的词条数，失败返回 -1；
+    // stats 不为空时记录解码、写出耗时和词条数、输入输出字节数；
+    // progress 不为空时每写出一块更新进度；先写临时文件，读完且全部写入成功才替换 txtPath，
+    // 出错或已取消时放弃临时文件（已有的 txtPath 保持不变）并返回 -1；
+    // skippedCount 不为空时写入因音节下标非法而跳过的词条数
+    qint64 exportFile(const QString &scelPath, const QString &txtPath, QString *errorString = nullptr,
+                      SCDStats *stats = nullptr, SCDProgress *progress = nullptr, qint64 *skippedCount = nullptr);
+}
+
+#endif // SCDENTRYREADER_H
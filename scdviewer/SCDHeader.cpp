@@ -0,0 +1,178 @@
+#include "SCDHeader.h"
+#include "SCDText.h"
+#include <QFile>
+#include <QtEndian>
+#include <QDebug>
+#include <cstring>
+
+/** 文件头偏移表（文件头布局只在这里定义，其他代码都经 SCDHeader 取字段）：
+魔法字节：0x000-0x00B（0x004-0x005 为 44 43 时为官方词库；QQ 拼音词库的签名见 QQMagic）
+词库ID：0x01C-0x05B
+时间戳：0x11C-0x11F
+拼音组数量 / 词条数量 / 拼音组字节数 / 词条字节数：0x120 / 0x124 / 0x128 / 0x12C
+词库名称：0x130-0x337
+词库类别：0x338-0x53F
+词库备注：0x540-0xD3F
+示例词：0xD40-0x153F
+**/
+const char SCDHeader::QQMagic[MagicSize] = {'\x40', '\x15', '\x00', '\x00', '\x44', '\x43',
+                                           '\x51', '\x01', '\x01', '\x00', '\x00', '\x00'};
+
+const SCDFieldSpan SCDHeader::FieldTable[static_cast<int>(SCDField::FieldCount)] = {
+    {0x01C, 0x040, true},  // Id
+    {0x11C, 4, false},     // Timestamp
+    {0x120, 4, false},     // GroupCount
+    {0x124, 4, false},     // PhraseCount
+    {0x128, 4, false},     // GroupSize
+    {0x12C, 4, false},     // PhraseSize
+    {0x130, 0x208, true},  // Name
+    {0x338, 0x208, true},  // Category
+    {0x540, 0x800, true},  // Remark
+    {0xD40, 0x800, true},  // Example
+};
+
+SCDFormat SCDHeader::detectFormat(const char *data, qsizetype size)
+{
+    if (size < MagicSize) {
+        return SCDFormat::Unknown;
+    }
+
+    static const char expectedPrefix[] = {'\x40', '\x15', '\x00', '\x00'};
+    static const char expectedSuffix[] = {'\x53', '\x01', '\x01', '\x00', '\x00', '\x00'};
+
+    if (std::memcmp(data, expectedPrefix, 4) == 0 && std::memcmp(data + 6, expectedSuffix, 6) == 0) {
+        return SCDFormat::Sogou;
+    }
+
+    // QQ 拼音词库：12 字节签名整体比较，其余签名（包括签名损坏的 .scel）一律不认
+    if (size < HeaderSize || std::memcmp(data, QQMagic, MagicSize) != 0) {
+        return SCDFormat::Unknown;
+    }
+    auto numberAt = [data](int offset) { return qFromLittleEndian<quint32>(data + offset); };
+    const quint32 groups = numberAt(FieldTable[static_cast<int>(SCDField::GroupCount)].offset);
+    const quint32 phrases = numberAt(FieldTable[static_cast<int>(SCDField::PhraseCount)].offset);
+    if (groups > phrases) {
+        return SCDFormat::Unknown;
+    }
+    if (size >= ProbeSize) {
+        const quint32 syllables = numberAt(HeaderSize);
+        if (syllables == 0 || syllables > 0xFFFF) {
+            return SCDFormat::Unknown;
+        }
+    }
+    return SCDFormat::QQ;
+}
+
+QString SCDHeader::formatName(SCDFormat format)
+{
+    switch (format) {
+    case SCDFormat::Sogou:
+        return "sogou";
+    case SCDFormat::QQ:
+        return "qq";
+    default:
+        return "unknown";
+    }
+}
+
+std::pair<bool, bool> SCDHeader::checkMagic(const char *data, qsizetype size)
+{
+    const SCDFormat format = detectFormat(data, size);
+    if (format == SCDFormat::Unknown) {
+        return {false, false};
+    }
+
+    bool isOfficial = format == SCDFormat::Sogou && data[4] == '\x44' && data[5] == '\x43';
+    return {true, isOfficial};
+}
+
+SCDHeader SCDHeader::create(bool official)
+{
+    // 0xD2 0x6D 为自定义词库，0x44 0x43 为官方词库
+    static const char magic[] = {'\x40', '\x15', '\x00', '\x00', '\xD2', '\x6D',
+                                 '\x53', '\x01', '\x01', '\x00', '\x00', '\x00'};
+
+    QByteArray data(HeaderSize, '\0');
+    std::memcpy(data.data(), magic, MagicSize);
+    if (official) {
+        data[4] = '\x44';
+        data[5] = '\x43';
+    }
+
+    SCDHeader header;
+    header.loadFromData(data);
+    return header;
+}
+
+bool SCDHeader::load(const QString &filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "无法打开文件:" << filePath;
+        m_data.clear();
+        m_valid = m_official = false;
+        return false;
+    }
+
+    return loadFromData(file.read(ProbeSize));
+}
+
+bool SCDHeader::loadFromData(const QByteArray &data)
+{
+    const SCDFormat format = detectFormat(data.constData(), data.size());
+    m_data = data.left(HeaderSize);
+    m_valid = format != SCDFormat::Unknown && m_data.size() >= HeaderSize;
+    m_official = m_valid && format == SCDFormat::Sogou && m_data[4] == '\x44' && m_data[5] == '\x43';
+    m_format = m_valid ? format : SCDFormat::Unknown;
+    return m_valid;
+}
+
+QString SCDHeader::string(SCDField field) const
+{
+    const SCDFieldSpan &span = FieldTable[static_cast<int>(field)];
+    if (!span.isString || m_data.size() < span.offset + span.size) {
+        return {};
+    }
+
+    // 字段为定长 UTF-16LE，以 NUL 补齐
+    const uchar *begin = reinterpret_cast<const uchar *>(m_data.constData()) + span.offset;
+    return SCDText::fromFixedUtf16(begin, span.size);
+}
+
+quint32 SCDHeader::number(SCDField field) const
+{
+    const SCDFieldSpan &span = FieldTable[static_cast<int>(field)];
+    if (span.isString || m_data.size() < span.offset + 4) {
+        return 0;
+    }
+    return qFromLittleEndian<quint32>(m_data.constData() + span.offset);
+}
+
+void SCDHeader::setString(SCDField field, const QString &value)
+{
+    const SCDFieldSpan &span = FieldTable[static_cast<int>(field)];
+    if (!span.isString || m_data.size() < span.offset + span.size) {
+        return;
+    }
+
+    // 保留至少一个 NUL 结尾，且不拆开代理对
+    qsizetype length = qMin<qsizetype>(value.size(), span.size / 2 - 1);
+    if (length > 0 && length < value.size() && value.at(length - 1).isHighSurrogate()) {
+        --length;
+    }
+
+    char *out = m_data.data() + span.offset;
+    std::memset(out, 0, span.size);
+    for (qsizetype i = 0; i < length; ++i) {
+        qToLittleEndian<quint16>(value.at(i).unicode(), out + i * 2);
+    }
+}
+
+void SCDHeader::setNumber(SCDField field, quint32 value)
+{
+    const SCDFieldSpan &span = FieldTable[static_cast<int>(field)];
+    if (span.isString || m_data.size() < span.offset + 4) {
+        return;
+    }
+    qToLittleEndian<quint32>(value, m_data.data() + span.offset);
+}
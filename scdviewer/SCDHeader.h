@@ -0,0 +1,109 @@
+#ifndef SCDHEADER_H
+#define SCDHEADER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+#include <utility> // std::pair
+
+// 细胞词库文件头字段
+enum class SCDField {
+    Id,          // 词库ID
+    Timestamp,   // 生成时间戳
+    GroupCount,  // 拼音组数量
+    PhraseCount, // 词条数量
+    GroupSize,   // 拼音组占用字节数
+    PhraseSize,  // 词条占用字节数
+    Name,        // 词库名称
+    Category,    // 词库类别
+    Remark,      // 词库备注
+    Example,     // 示例词
+    FieldCount
+};
+
+// 词库格式：QQ 拼音的 .qcel 沿用细胞词库的布局（0x1540 文件头 + 拼音表 + 拼音组），只是文件头签名不同
+enum class SCDFormat {
+    Unknown,
+    Sogou, // 搜狗拼音 .scel
+    QQ,    // QQ 拼音 .qcel
+};
+
+// 字段偏移表项：起始偏移、字节数、是否为 UTF-16LE 字符串
+struct SCDFieldSpan {
+    int offset;
+    int size;
+    bool isString;
+};
+
+/**
+ * 细胞词库文件头视图
+ *
+ * 一次性读取固定 0x1540 字节的文件头，之后所有字段都从这一块缓冲区中按偏移表取值，
+ * 字符串字段在访问时才解码，不再为每个字段重新打开文件。
+ */
+class SCDHeader
+{
+public:
+    static constexpr int HeaderSize = 0x1540;
+    static constexpr int MagicSize = 12;
+
+    // 识别格式需要读取的字节数：文件头 + 拼音表开头的音节数
+    static constexpr int ProbeSize = HeaderSize + 4;
+
+    // QQ 拼音 .qcel 的 12 字节签名（首 4 字节与搜狗词库相同，都是拼音表偏移 0x1540）
+    static const char QQMagic[MagicSize];
+
+    // 按 SCDField 顺序排列的偏移表
+    static const SCDFieldSpan FieldTable[static_cast<int>(SCDField::FieldCount)];
+
+    SCDHeader() = default;
+
+    // 生成一个只含魔法字节、其余全为 0 的新文件头
+    static SCDHeader create(bool official);
+
+    // 读取文件头（一次 open + 一次 read，连同拼音表开头以识别格式），返回文件头是否合法
+    bool load(const QString &filePath);
+
+    // 使用已读入内存的数据（至少包含完整文件头，超出部分只用于识别格式）
+    bool loadFromData(const QByteArray &data);
+
+    bool isValid() const { return m_valid; }
+    bool isOfficial() const { return m_official; }
+    SCDFormat format() const { return m_format; }
+
+    // 解码字符串字段（遇到第一个 NUL 结束，并去掉首尾空白）
+    QString string(SCDField field) const;
+
+    // 读取 32 位小端整数字段
+    quint32 number(SCDField field) const;
+
+    // 写入字符串字段（超长截断，剩余部分以 NUL 补齐）
+    void setString(SCDField field, const QString &value);
+
+    // 写入 32 位小端整数字段
+    void setNumber(SCDField field, quint32 value);
+
+    // 原始文件头数据
+    const QByteArray &data() const { return m_data; }
+
+    /**
+     * 识别词库格式。搜狗词库只看前 MagicSize 字节的签名；
+     * QQ 拼音词库要求签名与 QQMagic 完全相同、文件头中的计数自洽，
+     * 数据包含 ProbeSize 字节时还检查拼音表音节数；其余一律为 Unknown
+     */
+    static SCDFormat detectFormat(const char *data, qsizetype size);
+
+    // 格式名称（用于显示和目录输出）
+    static QString formatName(SCDFormat format);
+
+    // 检查文件头魔法字节，返回 pair<是否合法, 是否官方>（QQ 拼音词库合法但不是官方词库）
+    static std::pair<bool, bool> checkMagic(const char *data, qsizetype size);
+
+private:
+    QByteArray m_data;
+    bool m_valid = false;
+    bool m_official = false;
+    SCDFormat m_format = SCDFormat::Unknown;
+};
+
+#endif // SCDHEADER_H
@@ -0,0 +1,347 @@
+#include "SCDInfoCache.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <cstring>
+#ifdef Q_OS_LINUX
+#include <sys/stat.h>
+#endif
+
+namespace {
+
+// 缓存文件格式：文件头 "SCDCACHE" + uint32 版本，之后为若干条记录：
+// uint32 记录长度, uint32 记录标记, uint64 大小, int64 修改时间(ns), uint64 inode, uint64 设备号,
+// uint32 时间戳, int32 词条数, uint8 是否官方, uint8 格式, 6 个字符串（路径、ID、名称、类别、备注、示例，uint32 长度 + UTF-8）
+constexpr char fileMagic[8] = {'S', 'C', 'D', 'C', 'A', 'C', 'H', 'E'};
+constexpr quint32 fileVersion = 2;
+constexpr int fileHeaderSize = 12;
+constexpr quint32 recordMagic = 0x31494353; // "SCI1"
+
+// 攒够这么多字节才追加写入一次
+constexpr qsizetype flushThreshold = 64 * 1024;
+
+// 修改时间距今不足 2 秒的文件不写入缓存，避免同一时间粒度内的再次改写无法区分
+constexpr qint64 racyWindowNs = 2000000000LL;
+
+struct FileKey {
+    quint64 size = 0;
+    qint64 mtimeNs = 0;
+    quint64 inode = 0;
+    quint64 device = 0;
+
+    bool operator==(const FileKey &other) const
+    {
+        return size == other.size && mtimeNs == other.mtimeNs
+               && inode == other.inode && device == other.device;
+    }
+};
+
+struct CacheRecord {
+    FileKey key;
+    SCDInfo info;
+};
+
+bool statFile(const QString &filePath, FileKey *key)
+{
+#ifdef Q_OS_LINUX
+    struct stat st;
+    if (::stat(QFile::encodeName(filePath).constData(), &st) != 0 || !S_ISREG(st.st_mode)) {
+        return false;
+    }
+    key->size = static_cast<quint64>(st.st_size);
+    key->mtimeNs = static_cast<qint64>(st.st_mtim.tv_sec) * 1000000000LL + st.st_mtim.tv_nsec;
+    key->inode = static_cast<quint64>(st.st_ino);
+    key->device = static_cast<quint64>(st.st_dev);
+#else
+    QFileInfo fileInfo(filePath);
+    if (!fileInfo.isFile()) {
+        return false;
+    }
+    key->size = static_cast<quint64>(fileInfo.size());
+    key->mtimeNs = fileInfo.lastModified().toMSecsSinceEpoch() * 1000000LL;
+    key->inode = 0;
+    key->device = 0;
+#endif
+    return true;
+}
+
+template <typename T>
+void appendNumber(QByteArray &out, T value)
+{
+    char bytes[sizeof(T)];
+    qToLittleEndian<T>(value, bytes);
+    out.append(bytes, sizeof(T));
+}
+
+void appendString(QByteArray &out, const QString &value)
+{
+    const QByteArray bytes = value.toUtf8();
+    appendNumber<quint32>(out, static_cast<quint32>(bytes.size()));
+    out.append(bytes);
+}
+
+// 带越界检查的顺序读取
+struct RecordCursor {
+    const char *data;
+    qsizetype size;
+    qsizetype pos = 0;
+    bool ok = true;
+
+    template <typename T>
+    T number()
+    {
+        if (pos + static_cast<qsizetype>(sizeof(T)) > size) {
+            ok = false;
+            return 0;
+        }
+        T value = qFromLittleEndian<T>(data + pos);
+        pos += sizeof(T);
+        return value;
+    }
+
+    QString string()
+    {
+        const quint32 length = number<quint32>();
+        if (!ok || pos + static_cast<qsizetype>(length) > size) {
+            ok = false;
+            return {};
+        }
+        QString value = QString::fromUtf8(data + pos, length);
+        pos += length;
+        return value;
+    }
+};
+
+QByteArray serialize(const QString &path, const CacheRecord &record)
+{
+    QByteArray body;
+    appendNumber<quint32>(body, recordMagic);
+    appendNumber<quint64>(body, record.key.size);
+    appendNumber<qint64>(body, record.key.mtimeNs);
+    appendNumber<quint64>(body, record.key.inode);
+    appendNumber<quint64>(body, record.key.device);
+    appendNumber<quint32>(body, record.info.timestamp);
+    appendNumber<qint32>(body, record.info.phraseCount);
+    appendNumber<quint8>(body, record.info.isOfficial ? 1 : 0);
+    appendNumber<quint8>(body, static_cast<quint8>(record.info.format));
+    appendString(body, path);
+    appendString(body, record.info.id);
+    appendString(body, record.info.name);
+    appendString(body, record.info.category);
+    appendString(body, record.info.remark);
+    appendString(body, record.info.example);
+
+    QByteArray out;
+    appendNumber<quint32>(out, static_cast<quint32>(body.size()));
+    out.append(body);
+    return out;
+}
+
+bool deserialize(const char *data, qsizetype size, QString *path, CacheRecord *record)
+{
+    RecordCursor cursor{data, size};
+    if (cursor.number<quint32>() != recordMagic) {
+        return false;
+    }
+    record->key.size = cursor.number<quint64>();
+    record->key.mtimeNs = cursor.number<qint64>();
+    record->key.inode = cursor.number<quint64>();
+    record->key.device = cursor.number<quint64>();
+    record->info.timestamp = cursor.number<quint32>();
+    record->info.phraseCount = cursor.number<qint32>();
+    record->info.isOfficial = cursor.number<quint8>() != 0;
+    record->info.format = static_cast<SCDFormat>(cursor.number<quint8>());
+    *path = cursor.string();
+    record->info.id = cursor.string();
+    record->info.name = cursor.string();
+    record->info.category = cursor.string();
+    record->info.remark = cursor.string();
+    record->info.example = cursor.string();
+    record->info.isValid = true;
+    return cursor.ok;
+}
+
+class Cache
+{
+public:
+    ~Cache()
+    {
+        QMutexLocker locker(&mutex);
+        flushLocked();
+    }
+
+    void ensureLoaded();
+    void flushLocked();
+
+    bool enabled = true;
+    bool loaded = false;
+    QMutex mutex;
+    QHash<QString, CacheRecord> records;
+    QByteArray pending;
+};
+
+Cache &cache()
+{
+    static Cache instance;
+    return instance;
+}
+
+void Cache::ensureLoaded()
+{
+    if (loaded) {
+        return;
+    }
+    loaded = true;
+
+    const QString path = SCDInfoCache::cacheFilePath();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const QByteArray data = file.readAll();
+    file.close();
+
+    if (data.size() < fileHeaderSize || std::memcmp(data.constData(), fileMagic, sizeof(fileMagic)) != 0
+        || qFromLittleEndian<quint32>(data.constData() + sizeof(fileMagic)) != fileVersion) {
+        // 无法识别的旧缓存直接丢弃
+        QFile::remove(path);
+        return;
+    }
+
+    // 同一路径后出现的记录覆盖先出现的；遇到不完整的记录（写入中断）即停止
+    qsizetype pos = fileHeaderSize;
+    qsizetype total = 0;
+    while (pos + 4 <= data.size()) {
+        const quint32 length = qFromLittleEndian<quint32>(data.constData() + pos);
+        if (pos + 4 + static_cast<qsizetype>(length) > data.size()) {
+            break;
+        }
+        QString recordPath;
+        CacheRecord record;
+        if (!deserialize(data.constData() + pos + 4, length, &recordPath, &record)) {
+            break;
+        }
+        records.insert(recordPath, record);
+        pos += 4 + length;
+        ++total;
+    }
+
+    // 过期记录过多或末尾损坏时重写一份紧凑的缓存
+    if (pos < data.size() || total > records.size() * 2 + 1024) {
+        QSaveFile compact(path);
+        if (compact.open(QIODevice::WriteOnly)) {
+            QByteArray out(fileMagic, sizeof(fileMagic));
+            appendNumber<quint32>(out, fileVersion);
+            for (auto it = records.constBegin(); it != records.constEnd(); ++it) {
+                out.append(serialize(it.key(), it.value()));
+            }
+            compact.write(out);
+            compact.commit();
+        }
+    }
+}
+
+void Cache::flushLocked()
+{
+    if (pending.isEmpty()) {
+        return;
+    }
+
+    const QString path = SCDInfoCache::cacheFilePath();
+    QDir().mkpath(QFileInfo(path).absolutePath());
+
+    QFile file(path);
+    if (file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        if (file.size() == 0) {
+            QByteArray header(fileMagic, sizeof(fileMagic));
+            appendNumber<quint32>(header, fileVersion);
+            file.write(header);
+        }
+        // 一次写入整批记录
+        file.write(pending);
+    }
+    pending.clear();
+}
+
+} // namespace
+
+void SCDInfoCache::setEnabled(bool enabled)
+{
+    QMutexLocker locker(&cache().mutex);
+    cache().enabled = enabled;
+}
+
+bool SCDInfoCache::isEnabled()
+{
+    QMutexLocker locker(&cache().mutex);
+    return cache().enabled;
+}
+
+QString SCDInfoCache::cacheFilePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+           + "/scdtool/scdinfo.cache";
+}
+
+bool SCDInfoCache::lookup(const QString &filePath, SCDInfo *info)
+{
+    Cache &c = cache();
+    if (!isEnabled()) {
+        return false;
+    }
+
+    FileKey key;
+    if (!statFile(filePath, &key)) {
+        return false;
+    }
+    const QString absolutePath = QFileInfo(filePath).absoluteFilePath();
+
+    QMutexLocker locker(&c.mutex);
+    c.ensureLoaded();
+    auto it = c.records.constFind(absolutePath);
+    if (it == c.records.constEnd() || !(it.value().key == key)) {
+        return false;
+    }
+    *info = it.value().info;
+    return true;
+}
+
+void SCDInfoCache::store(const QString &filePath, const SCDInfo &info)
+{
+    Cache &c = cache();
+    if (!info.isValid || !isEnabled()) {
+        return;
+    }
+
+    CacheRecord record;
+    record.info = info;
+    if (!statFile(filePath, &record.key)) {
+        return;
+    }
+    const qint64 nowNs = QDateTime::currentMSecsSinceEpoch() * 1000000LL;
+    if (nowNs - record.key.mtimeNs < racyWindowNs) {
+        return;
+    }
+    const QString absolutePath = QFileInfo(filePath).absoluteFilePath();
+
+    QMutexLocker locker(&c.mutex);
+    c.ensureLoaded();
+    c.records.insert(absolutePath, record);
+    c.pending.append(serialize(absolutePath, record));
+    if (c.pending.size() >= flushThreshold) {
+        c.flushLocked();
+    }
+}
+
+void SCDInfoCache::flush()
+{
+    QMutexLocker locker(&cache().mutex);
+    cache().flushLocked();
+}
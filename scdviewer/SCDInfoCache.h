@@ -0,0 +1,32 @@
+#ifndef SCDINFOCACHE_H
+#define SCDINFOCACHE_H
+
+#include "SCDInfoRead.h"
+#include <QString>
+
+/**
+ * 词库信息持久缓存
+ *
+ * 缓存文件位于 ~/.cache/scdtool/scdinfo.cache，只追加写入，同一路径以最后一条记录为准。
+ * 记录以 路径 + 大小 + 修改时间（纳秒）+ inode 为键，文件被 scdeditor 原地改写后
+ * 修改时间变化，旧记录自然失效。命中时只需一次 stat，不再打开词库文件。
+ */
+namespace SCDInfoCache {
+    // 缓存开关（默认开启），关闭后 lookup 总是未命中且不再写入
+    void setEnabled(bool enabled);
+    bool isEnabled();
+
+    // 查找未变化文件的词库信息
+    bool lookup(const QString &filePath, SCDInfo *info);
+
+    // 记录词库信息（先写入内存，攒够一批或程序退出时追加到缓存文件）
+    void store(const QString &filePath, const SCDInfo &info);
+
+    // 立即把未写入的记录追加到缓存文件
+    void flush();
+
+    // 缓存文件路径
+    QString cacheFilePath();
+}
+
+#endif // SCDINFOCACHE_H
@@ -1,82 +1,13 @@
 #include "SCDInfoRead.h"
+#include "SCDHeader.h"
+#include "SCDInfoCache.h"
 #include <QFile>
 #include <QByteArray>
-#include <QtEndian>
 #include <QDateTime>
 #include <QDebug>
 #include <QFileInfo>
 
-// 定义搜狗拼音词库的偏移区间
-/** 偏移区间说明：
-魔法字节：0x004-0x005（44 43为搜狗输入法ng版官方词库）
-词库ID：0x001C-0x005B
-词库生成时间戳：0x011C-0x011F
-词库词条数量：0x124-0x127
-词库名称：0x130-0x337
-词库类别：0x338-0x53F
-词库备注：0x540-0xD3F
-词库示例词：0xD40-0x153
-**/
-
-const int magicBytesStart = 0x004;
-const int idStart = 0x01C;
-const int idEnd = 0x05B;
-const int timestampStart = 0x11C;
-const int timestampEnd = 0x11F;
-const int phraseCountStart = 0x124;
-const int phraseCountEnd = 0x127;
-const int nameStart = 0x130;
-const int nameEnd = 0x337;
-const int categoryStart = 0x338;
-const int categoryEnd = 0x53F;
-const int remarkStart = 0x540;
-const int remarkEnd = 0xD3F;
-const int exampleStart = 0xD40;
-const int exampleEnd = 0x153F;
-
-// 内部函数：读取 UTF-16LE 字符串
-static QString readString(const QString &filePath, int offsetStart, int offsetEnd)
-{
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) return {};
-
-    int size = offsetEnd - offsetStart;
-    if (size <= 0) return {};
-
-    if (!file.seek(offsetStart)) return {};
-
-    QByteArray byteArray = file.read(size);
-
-    // 转为 UTF-16LE 字符串
-    QString result = QString::fromUtf16(reinterpret_cast<const char16_t*>(byteArray.constData()),
-                                        byteArray.size() / 2);
-
-    result.remove(QChar(0x00));
-    result = result.trimmed();
-    return result;
-}
-
-// 内部函数：读取词条数
-static int readPhraseCount(const QString &filePath, int offsetStart, int offsetEnd)
-{
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) return 0;
-    file.seek(offsetStart);
-    QByteArray byteArray = file.read(offsetEnd - offsetStart);
-    return static_cast<int>(qFromLittleEndian<quint32>((const uchar*)byteArray.data()));
-}
-
-// 内部函数：读取时间戳
-static unsigned readTimestamp(const QString &filePath, int offsetStart, int offsetEnd)
-{
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) return 0;
-    file.seek(offsetStart);
-    QByteArray byteArray = file.read(offsetEnd - offsetStart + 1);
-    return qFromLittleEndian<quint32>((const uchar*)byteArray.data());
-}
-
-// 文件头检查实现
+// 文件头检查实现：按前 12 字节签名识别搜狗词库和 QQ 拼音词库，QQ 拼音词库再检查文件头和拼音表开头
 std::pair<bool, bool> SCDInfoRead::checkSogouHeader(const QString &filePath)
 {
     QFile file(filePath);
@@ -85,49 +16,20 @@ std::pair<bool, bool> SCDInfoRead::checkSogouHeader(const QString &filePath)
         return {false, false};
     }
 
-    QByteArray header = file.read(12);
+    QByteArray header = file.read(SCDHeader::ProbeSize);
     file.close();
 
-    if (header.size() < 12) {
+    if (header.size() < SCDHeader::MagicSize) {
         qDebug() << "文件太短，无法读取完整文件头";
         return {false, false};
     }
 
-    QByteArray prefix = header.left(4);
-    QByteArray middle = header.mid(4, 2);
-    QByteArray suffix = header.mid(6, 6);
-
-    QByteArray expectedPrefix = QByteArray::fromHex("40150000");
-    QByteArray expectedSuffix = QByteArray::fromHex("530101000000");
-
-    if (prefix != expectedPrefix || suffix != expectedSuffix) {
-        return {false, false};
-    }
-
-    bool isOfficial = (middle == QByteArray::fromHex("4443"));
-    return {true, isOfficial};
+    return SCDHeader::checkMagic(header.constData(), header.size());
 }
 
-// 读取词库信息
-SCDInfo SCDInfoRead::readSCDInfo(const QString &filePath)
+// 内部函数：由各字段生成格式化时间和汇总文本（缓存中不保存这两项）
+static void composeInformation(const QString &filePath, SCDInfo &info)
 {
-    SCDInfo info;
-
-    auto [valid, isOfficial] = checkSogouHeader(filePath);
-    if (!valid) {
-        info.allInformation = "非法的细胞词库文件头！";
-        info.isOfficial = false;
-        return info;
-    }
-    info.isOfficial = isOfficial;
-
-    info.id = readString(filePath, idStart, idEnd);
-    info.name = readString(filePath, nameStart, nameEnd);
-    info.category = readString(filePath, categoryStart, categoryEnd);
-    info.remark = readString(filePath, remarkStart, remarkEnd);
-    info.example = readString(filePath, exampleStart, exampleEnd);
-    info.phraseCount = readPhraseCount(filePath, phraseCountStart, phraseCountEnd);
-    info.timestamp = readTimestamp(filePath, timestampStart, timestampEnd);
     info.formattedTimestamp = QDateTime::fromSecsSinceEpoch(info.timestamp)
                               .toString("yyyy-MM-dd HH:mm:ss");
 
@@ -145,7 +47,40 @@ SCDInfo SCDInfoRead::readSCDInfo(const QString &filePath)
             .arg(QString::number(info.timestamp))
             .arg(QString::number(info.phraseCount))
             .arg(info.example)
-            .arg(info.isOfficial ? "官方词库" : "其他词库");
+            .arg(info.format == SCDFormat::QQ ? "QQ 拼音词库" : info.isOfficial ? "官方词库" : "其他词库");
+}
 
+// 读取词库信息
+SCDInfo SCDInfoRead::readSCDInfo(const QString &filePath)
+{
+    SCDInfo info;
+
+    // 文件未变化时直接使用缓存，不再打开词库
+    if (SCDInfoCache::lookup(filePath, &info)) {
+        composeInformation(filePath, info);
+        return info;
+    }
+
+    // 一次读取整个文件头，各字段从同一缓冲区解码
+    SCDHeader header;
+    if (!header.load(filePath)) {
+        info.allInformation = "非法的细胞词库文件头！";
+        info.isOfficial = false;
+        return info;
+    }
+    info.isValid = true;
+    info.isOfficial = header.isOfficial();
+    info.format = header.format();
+
+    info.id = header.string(SCDField::Id);
+    info.name = header.string(SCDField::Name);
+    info.category = header.string(SCDField::Category);
+    info.remark = header.string(SCDField::Remark);
+    info.example = header.string(SCDField::Example);
+    info.phraseCount = static_cast<int>(header.number(SCDField::PhraseCount));
+    info.timestamp = header.number(SCDField::Timestamp);
+
+    SCDInfoCache::store(filePath, info);
+    composeInformation(filePath, info);
     return info;
 }
@@ -1,26 +1,10 @@
 #ifndef SCDINFOREAD_H
 #define SCDINFOREAD_H
 
+#include "SCDHeader.h"
 #include <QString>
 #include <utility> // std::pair
 
-// 搜狗拼音细胞词库偏移区间
-extern const int magicBytesStart;
-extern const int idStart;
-extern const int idEnd;
-extern const int timestampStart;
-extern const int timestampEnd;
-extern const int phraseCountStart;
-extern const int phraseCountEnd;
-extern const int nameStart;
-extern const int nameEnd;
-extern const int categoryStart;
-extern const int categoryEnd;
-extern const int remarkStart;
-extern const int remarkEnd;
-extern const int exampleStart;
-extern const int exampleEnd;
-
 // 词库信息结构体
 struct SCDInfo {
     QString id;
@@ -32,6 +16,8 @@ struct SCDInfo {
     QString formattedTimestamp;
     unsigned timestamp;
     bool isOfficial;
+    SCDFormat format = SCDFormat::Unknown;
+    bool isValid = false;
     QString allInformation;
 };
 
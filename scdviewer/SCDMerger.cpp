@@ -0,0 +1,291 @@
+#include "SCDMerger.h"
+#include "SCDChecksum.h"
+#include "SCDDictionary.h"
+#include "SCDEntryReader.h"
+#include "SCDHeader.h"
+#include "SCDText.h"
+#include "SCDWriter.h"
+#include <QFileInfo>
+#include <QHash>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// 按音节下标逐个比较（与 SCDWriter 的排序一致），音节序列为 uint16 小端
+int compareSyllables(const QByteArray &a, const QByteArray &b)
+{
+    const int n = static_cast<int>(qMin(a.size(), b.size()) / 2);
+    for (int i = 0; i < n; ++i) {
+        const quint16 x = qFromLittleEndian<quint16>(a.constData() + i * 2);
+        const quint16 y = qFromLittleEndian<quint16>(b.constData() + i * 2);
+        if (x != y) {
+            return x < y ? -1 : 1;
+        }
+    }
+    return static_cast<int>(a.size() - b.size());
+}
+
+// 一个输入词库的读取位置：当前拼音组（音节已换成内置拼音表下标）及其全部词条
+struct Cursor {
+    SCDEntryReader reader;
+    std::vector<int> remap;   // 输入的音节下标 -> 内置拼音表下标，-1 表示内置表中没有
+    QByteArray syllables;     // 当前组的音节下标，uint16 小端
+    QByteArray previous;      // 上一组的音节下标，用于发现无序输入
+    QByteArray records;       // 当前组词条的原始记录首尾相接：uint16 词字节数, 词, uint16 扩展字节数, 扩展信息
+    std::vector<std::pair<int, int>> words; // 每条记录在 records 中的偏移和长度
+    SCDEntryView pending;     // 已读出的下一组第一个词条（视图在下一次 next() 之前有效）
+    bool hasPending = false;
+    int input = 0;
+};
+
+// 文件头中的四个计数
+struct Counts {
+    quint64 groups = 0;
+    quint64 phrases = 0;
+    quint64 groupBytes = 0;
+    quint64 phraseBytes = 0;
+};
+
+void appendRecord(Cursor &cursor, const SCDEntryView &entry)
+{
+    const int offset = static_cast<int>(cursor.records.size());
+    const int length = 4 + entry.wordBytes + entry.extBytes;
+    cursor.records.append(reinterpret_cast<const char *>(entry.word) - 2, length);
+    cursor.words.emplace_back(offset, length);
+}
+
+/**
+ * 读入下一个拼音组，读完时返回 false（出错时 reader.hasError() 为 true）。
+ * 含内置拼音表中没有的音节的组整组跳过，计入 skipped
+ */
+bool loadGroup(Cursor &cursor, qint64 *skipped)
+{
+    for (;;) {
+        if (!cursor.hasPending && !cursor.reader.next(cursor.pending)) {
+            return false;
+        }
+        cursor.hasPending = false;
+
+        const SCDEntryView &first = cursor.pending;
+        bool known = true;
+        cursor.syllables.resize(first.syllableCount * 2);
+        for (int i = 0; i < first.syllableCount; ++i) {
+            const quint16 index = first.syllableAt(i);
+            const int mapped = index < cursor.remap.size() ? cursor.remap[index] : -1;
+            if (mapped < 0) {
+                known = false;
+                break;
+            }
+            qToLittleEndian<quint16>(static_cast<quint16>(mapped), cursor.syllables.data() + i * 2);
+        }
+
+        cursor.records.resize(0);
+        cursor.words.clear();
+        if (known) {
+            appendRecord(cursor, first);
+        }
+        qint64 dropped = known ? 0 : 1;
+
+        SCDEntryView entry;
+        while (cursor.reader.next(entry)) {
+            if (entry.firstInGroup) {
+                cursor.pending = entry;
+                cursor.hasPending = true;
+                break;
+            }
+            if (known) {
+                appendRecord(cursor, entry);
+            } else {
+                ++dropped;
+            }
+        }
+        if (cursor.reader.hasError()) {
+            return false;
+        }
+        if (known) {
+            return true;
+        }
+        *skipped += dropped;
+        if (!cursor.hasPending) {
+            return false;
+        }
+    }
+}
+
+} // namespace
+
+bool SCDMerger::write(const QString &outputPath)
+{
+    m_groupCount = m_phraseCount = 0;
+    m_duplicates = m_skipped = m_unordered = 0;
+
+    if (m_inputs.isEmpty()) {
+        m_error = "没有要合并的词库";
+        return false;
+    }
+
+    const QByteArray pinyinTable = SCDPinyinTable::builtinData();
+    SCDPinyinTable builtin;
+    qint64 tableSize = 0;
+    if (pinyinTable.isEmpty()
+        || !builtin.parse(reinterpret_cast<const uchar *>(pinyinTable.constData()), pinyinTable.size(), &tableSize)) {
+        m_error = "无法读取内置拼音表";
+        return false;
+    }
+    const QHash<QByteArray, quint16> syllableIndex = builtin.syllableIndex();
+
+    // 打开全部输入，按音节文本建立下标映射，读入各自的第一个拼音组
+    std::vector<std::unique_ptr<Cursor>> cursors;
+    std::vector<Cursor *> heap;
+    auto greater = [](const Cursor *a, const Cursor *b) {
+        const int c = compareSyllables(a->syllables, b->syllables);
+        return c != 0 ? c > 0 : a->input > b->input;
+    };
+    auto readFailed = [&](const Cursor &cursor) {
+        m_error = m_inputs.at(cursor.input) + ": " + cursor.reader.errorString();
+        return false;
+    };
+
+    for (int i = 0; i < m_inputs.size(); ++i) {
+        cursors.push_back(std::make_unique<Cursor>());
+        Cursor &cursor = *cursors.back();
+        cursor.input = i;
+        if (!cursor.reader.open(m_inputs.at(i))) {
+            return readFailed(cursor);
+        }
+        const SCDPinyinTable &table = cursor.reader.pinyinTable();
+        cursor.remap.assign(table.size(), -1);
+        for (int k = 0; k < table.size(); ++k) {
+            int length = 0;
+            if (const char *text = table.syllable(static_cast<quint16>(k), &length)) {
+                cursor.remap[k] = syllableIndex.value(QByteArray::fromRawData(text, length), -1);
+            }
+        }
+        if (loadGroup(cursor, &m_skipped)) {
+            heap.push_back(&cursor);
+        } else if (cursor.reader.hasError()) {
+            return readFailed(cursor);
+        }
+    }
+    std::make_heap(heap.begin(), heap.end(), greater);
+
+    QSaveFile out(outputPath);
+    if (!out.open(QIODevice::WriteOnly)) {
+        m_error = "无法写入文件: " + outputPath;
+        return false;
+    }
+    // 文件头最后回填计数、示例词和校验和
+    if (out.write(SCDHeader::create(m_official).data()) != SCDHeader::HeaderSize) {
+        m_error = "写入文件失败: " + outputPath;
+        return false;
+    }
+
+    SCDChecksumWriter output(&out);
+    output.append(pinyinTable.constData(), pinyinTable.size());
+    Counts counts;
+    QStringList examples;
+
+    // 当前输出组：各输入中音节序列相同的组按输入顺序拼接，去掉重复的词。
+    // 组内音节序列都相同，去重只看词：登记进一个只存词的列式词库，逐组清空复用，不逐词分配内存
+    QByteArray key;
+    QByteArray records;
+    std::vector<std::pair<int, int>> words;
+    SCDDictionary seen;
+
+    while (!heap.empty()) {
+        key = heap.front()->syllables;
+        records.resize(0);
+        words.clear();
+        seen.clear();
+
+        while (!heap.empty() && compareSyllables(heap.front()->syllables, key) == 0) {
+            std::pop_heap(heap.begin(), heap.end(), greater);
+            Cursor &cursor = *heap.back();
+            heap.pop_back();
+
+            for (const auto &word : cursor.words) {
+                const char *record = cursor.records.constData() + word.first;
+                const int wordBytes = qFromLittleEndian<quint16>(record);
+                bool inserted = false;
+                if (seen.insert(nullptr, 0, reinterpret_cast<const uchar *>(record + 2), wordBytes, nullptr,
+                                &inserted) != SCDDictionary::NotFound && !inserted) {
+                    ++m_duplicates;
+                    continue;
+                }
+                words.emplace_back(static_cast<int>(records.size()), word.second);
+                records.append(record, word.second);
+            }
+
+            cursor.previous = cursor.syllables;
+            if (loadGroup(cursor, &m_skipped)) {
+                if (compareSyllables(cursor.syllables, cursor.previous) < 0) {
+                    ++m_unordered;
+                }
+                heap.push_back(&cursor);
+                std::push_heap(heap.begin(), heap.end(), greater);
+            } else if (cursor.reader.hasError()) {
+                return readFailed(cursor);
+            }
+        }
+
+        // 写出拼音组；词数超过上限时拆成多个组
+        for (size_t begin = 0; begin < words.size(); begin += SCDWriter::MaxWordsPerGroup) {
+            const size_t end = qMin(words.size(), begin + SCDWriter::MaxWordsPerGroup);
+            output.appendU16(static_cast<quint16>(end - begin));
+            output.appendU16(static_cast<quint16>(key.size()));
+            output.append(key.constData(), key.size());
+            ++counts.groups;
+            counts.groupBytes += 2 + key.size();
+            for (size_t i = begin; i < end; ++i) {
+                const char *record = records.constData() + words[i].first;
+                const int wordBytes = qFromLittleEndian<quint16>(record);
+                output.append(record, words[i].second);
+                counts.phraseBytes += 2 + wordBytes;
+                ++counts.phrases;
+                if (examples.size() < 6) {
+                    QByteArray utf8;
+                    SCDText::appendUtf8(utf8, reinterpret_cast<const uchar *>(record + 2), wordBytes);
+                    examples.append(QString::fromUtf8(utf8));
+                }
+            }
+        }
+        if (!output.flushIfFull()) {
+            m_error = "写入文件失败: " + outputPath;
+            return false;
+        }
+    }
+
+    if (!output.flush()) {
+        m_error = "写入文件失败: " + outputPath;
+        return false;
+    }
+    if (counts.groups > 0xFFFFFFFFu || counts.phrases > 0xFFFFFFFFu
+        || counts.groupBytes > 0xFFFFFFFFu || counts.phraseBytes > 0xFFFFFFFFu) {
+        m_error = "词条过多，超出细胞词库格式的上限";
+        return false;
+    }
+
+    const QString name = m_name.isEmpty() ? QFileInfo(outputPath).completeBaseName() : m_name;
+    SCDHeader header = SCDWriter::createHeader(m_official, name, m_category, m_remark, examples);
+    header.setNumber(SCDField::GroupCount, static_cast<quint32>(counts.groups));
+    header.setNumber(SCDField::PhraseCount, static_cast<quint32>(counts.phrases));
+    header.setNumber(SCDField::GroupSize, static_cast<quint32>(counts.groupBytes));
+    header.setNumber(SCDField::PhraseSize, static_cast<quint32>(counts.phraseBytes));
+    QByteArray headerData = header.data();
+    headerData.replace(SCDChecksum::Offset, SCDChecksum::Size, SCDChecksum::toBytes(output.result()));
+
+    // 输出可能与某个输入相同：先关闭全部输入，再用新文件替换
+    cursors.clear();
+    if (!out.seek(0) || out.write(headerData) != SCDHeader::HeaderSize || !out.commit()) {
+        m_error = "写入文件失败: " + outputPath;
+        return false;
+    }
+
+    m_groupCount = static_cast<quint32>(counts.groups);
+    m_phraseCount = static_cast<quint32>(counts.phrases);
+    return true;
+}
@@ -0,0 +1,64 @@
+#ifndef SCDMERGER_H
+#define SCDMERGER_H
+
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+
+/**
+ * 细胞词库合并
+ *
+ * 把多个细胞词库按音节序列多路归并为一个：每个输入同一时间只读入一个拼音组，
+ * 内存占用与输入个数成正比，与词库大小无关。各输入的音节下标按音节文本换成内置拼音表的下标，
+ * 音节序列相同的拼音组合并为一组，组内重复的词只保留第一次出现（按输入顺序）及其扩展信息
+ * （去重用逐组复用的 SCDDictionary，不逐词分配内存）。
+ * 输出与 SCDWriter 相同：先写文件头占位，词条区边写边算校验和，最后回填计数和校验和。
+ *
+ * 官方词库按音节序列有序；某个输入的拼音组无序时合并照常进行（输出仍是合法词库），
+ * 但同一音节序列可能分成多个组，此时计入 unorderedCount()。
+ */
+class SCDMerger
+{
+public:
+    void addInput(const QString &scelPath) { m_inputs.append(scelPath); }
+
+    void setName(const QString &name) { m_name = name; }
+    void setCategory(const QString &category) { m_category = category; }
+    void setRemark(const QString &remark) { m_remark = remark; }
+    void setOfficial(bool official) { m_official = official; }
+
+    // 合并所有输入并写出到 outputPath（可以与某个输入相同，写完后原子替换）
+    bool write(const QString &outputPath);
+
+    // 写出后的统计
+    quint32 groupCount() const { return m_groupCount; }
+    quint32 phraseCount() const { return m_phraseCount; }
+
+    // 跨输入（或同一输入内）重复而去掉的词条数
+    qint64 duplicateCount() const { return m_duplicates; }
+
+    // 音节不在内置拼音表中而跳过的词条数
+    qint64 skippedCount() const { return m_skipped; }
+
+    // 输入中排在前一组之前的拼音组数（输入无序）
+    qint64 unorderedCount() const { return m_unordered; }
+
+    QString errorString() const { return m_error; }
+
+private:
+    QStringList m_inputs;
+
+    QString m_name;
+    QString m_category = "本地";
+    QString m_remark = "由 scdtool 合并的细胞词库";
+    bool m_official = true;
+
+    quint32 m_groupCount = 0;
+    quint32 m_phraseCount = 0;
+    qint64 m_duplicates = 0;
+    qint64 m_skipped = 0;
+    qint64 m_unordered = 0;
+    QString m_error;
+};
+
+#endif // SCDMERGER_H
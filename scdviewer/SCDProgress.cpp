@@ -0,0 +1,118 @@
+#include "SCDProgress.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <cstring>
+
+namespace {
+
+// 进度行中可能出现的阶段名；phase() 返回的指针都指向这里或字符串字面量
+constexpr const char *knownPhases[] = {"detect", "read", "parse", "convert", "sort", "write", "decode"};
+
+struct PhaseLabel {
+    const char *name;
+    const char *label;
+};
+
+constexpr PhaseLabel phaseLabels[] = {
+    {"detect", "检测编码"}, {"read", "读取"},   {"parse", "解析"},   {"convert", "转换"},
+    {"sort", "排序"},       {"write", "写出"},  {"decode", "解码"},
+};
+
+} // namespace
+
+void SCDProgress::setPhase(const char *phase)
+{
+    m_done.store(0, std::memory_order_relaxed);
+    m_phaseStart.store(m_timer.nsecsElapsed(), std::memory_order_relaxed);
+    m_phase.store(phase, std::memory_order_relaxed);
+}
+
+qint64 SCDProgress::etaMs() const
+{
+    const qint64 external = m_eta.load(std::memory_order_relaxed);
+    if (external >= 0) {
+        return external;
+    }
+    const qint64 total = this->total();
+    const qint64 done = this->done();
+    if (total <= 0 || done <= 0) {
+        return -1;
+    }
+    const qint64 elapsed = m_timer.nsecsElapsed() - m_phaseStart.load(std::memory_order_relaxed);
+    return static_cast<qint64>(static_cast<double>(elapsed) / done * qMax<qint64>(total - done, 0) / 1e6);
+}
+
+int SCDProgress::permille() const
+{
+    const qint64 total = this->total();
+    if (total <= 0) {
+        return -1;
+    }
+    return static_cast<int>(qBound<qint64>(0, done() * 1000 / total, 1000));
+}
+
+QByteArray SCDProgress::toJson() const
+{
+    QByteArray out("{\"progress\":{\"phase\":\"");
+    out.append(phase());
+    out.append("\",\"done\":");
+    out.append(QByteArray::number(done()));
+    out.append(",\"total\":");
+    out.append(QByteArray::number(total()));
+    out.append(",\"entries\":");
+    out.append(QByteArray::number(entries()));
+    out.append(",\"etaMs\":");
+    out.append(QByteArray::number(etaMs()));
+    out.append("}}");
+    return out;
+}
+
+bool SCDProgress::fromJson(const QByteArray &line, SCDProgress *progress)
+{
+    const QByteArray trimmed = line.trimmed();
+    if (!trimmed.startsWith("{\"progress\"")) {
+        return false;
+    }
+    const QJsonObject object = QJsonDocument::fromJson(trimmed).object().value("progress").toObject();
+    if (object.isEmpty()) {
+        return false;
+    }
+
+    const QByteArray phase = object.value("phase").toString().toLatin1();
+    const char *known = "";
+    for (const char *name : knownPhases) {
+        if (phase == name) {
+            known = name;
+        }
+    }
+    progress->m_phase.store(known, std::memory_order_relaxed);
+    progress->setTotal(static_cast<qint64>(object.value("total").toDouble()));
+    progress->setDone(static_cast<qint64>(object.value("done").toDouble()));
+    progress->setEntries(static_cast<qint64>(object.value("entries").toDouble()));
+    progress->m_eta.store(static_cast<qint64>(object.value("etaMs").toDouble(-1)), std::memory_order_relaxed);
+    return true;
+}
+
+QString SCDProgress::toText() const
+{
+    QString label = QString::fromUtf8(phase());
+    for (const PhaseLabel &phaseLabel : phaseLabels) {
+        if (std::strcmp(phase(), phaseLabel.name) == 0) {
+            label = QString::fromUtf8(phaseLabel.label);
+        }
+    }
+
+    QString text = label;
+    const int value = permille();
+    if (value >= 0) {
+        text += QString(" %1%").arg(value / 10);
+    }
+    if (entries() > 0) {
+        text += QString("　%1 条").arg(entries());
+    }
+    const qint64 eta = etaMs();
+    if (eta >= 0) {
+        text += QString("　剩余约 %1 秒").arg((eta + 999) / 1000);
+    }
+    return text;
+}
@@ -0,0 +1,68 @@
+#ifndef SCDPROGRESS_H
+#define SCDPROGRESS_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+
+/**
+ * 长任务的进度与取消
+ *
+ * 工作线程只做原子写（阶段、已完成量、总量、词条数），界面按固定帧率读取，
+ * 两边不加锁，工作线程不因界面刷新而等待。cancel() 可从任何线程调用，工作线程在批次之间检查 isCanceled()。
+ * 命令行工具用 --progress 时每隔一段时间把 toJson() 输出到标准错误：
+ *   {"progress":{"phase":"parse","done":1024,"total":4096,"entries":100,"etaMs":300}}
+ * 读取、解析阶段的单位是字节，写出和反编译（decode）的单位是词条；total 为 0 表示总量未知。txtmaker -progress 输出相同结构。
+ */
+class SCDProgress
+{
+public:
+    SCDProgress() { m_timer.start(); }
+
+    SCDProgress(const SCDProgress &) = delete;
+    SCDProgress &operator=(const SCDProgress &) = delete;
+
+    // 进入新阶段（parse、sort、write 等，只接受字符串字面量），已完成量清零，剩余时间从此刻起估计
+    void setPhase(const char *phase);
+    const char *phase() const { return m_phase.load(std::memory_order_relaxed); }
+
+    void setTotal(qint64 total) { m_total.store(total, std::memory_order_relaxed); }
+    void setDone(qint64 done) { m_done.store(done, std::memory_order_relaxed); }
+    void setEntries(qint64 entries) { m_entries.store(entries, std::memory_order_relaxed); }
+
+    qint64 total() const { return m_total.load(std::memory_order_relaxed); }
+    qint64 done() const { return m_done.load(std::memory_order_relaxed); }
+    qint64 entries() const { return m_entries.load(std::memory_order_relaxed); }
+
+    void cancel() { m_canceled.store(true, std::memory_order_relaxed); }
+    bool isCanceled() const { return m_canceled.load(std::memory_order_relaxed); }
+
+    // 按当前阶段的平均速度估计剩余时间，无法估计时返回 -1
+    qint64 etaMs() const;
+
+    // 0～1000，总量未知时返回 -1
+    int permille() const;
+
+    // 单行 JSON（不含换行符）
+    QByteArray toJson() const;
+
+    // 解析 toJson() 或 txtmaker -progress 输出的一行，不是进度行时返回 false
+    static bool fromJson(const QByteArray &line, SCDProgress *progress);
+
+    // 进度条上显示的文本，如“解析 45%　剩余约 3 秒”
+    QString toText() const;
+
+private:
+    std::atomic<const char *> m_phase{""};
+    std::atomic<qint64> m_total{0};
+    std::atomic<qint64> m_done{0};
+    std::atomic<qint64> m_entries{0};
+    std::atomic<qint64> m_eta{-1};       // 从外部进度行解析而来时直接使用
+    std::atomic<qint64> m_phaseStart{0}; // 当前阶段开始时 m_timer 的读数（纳秒）
+    std::atomic<bool> m_canceled{false};
+    QElapsedTimer m_timer;               // 构造时启动，之后只读
+};
+
+#endif // SCDPROGRESS_H
@@ -0,0 +1,293 @@
+#include "SCDSearchIndex.h"
+#include "SCDChecksum.h"
+#include "SCDEntryReader.h"
+#include "SCDHeader.h"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+constexpr char indexMagic[8] = {'S', 'C', 'D', 'S', 'I', 'D', 'X', '1'};
+
+// 魔法字节, uint64 词库大小, 16 字节校验和, uint32 词条数, uint32 文本区字节数
+constexpr int indexHeaderSize = 8 + 8 + SCDChecksum::Size + 4 + 4;
+
+int compareBytes(const char *a, int aLength, const char *b, int bLength)
+{
+    const int c = std::memcmp(a, b, static_cast<size_t>(qMin(aLength, bLength)));
+    return c != 0 ? c : aLength - bLength;
+}
+
+} // namespace
+
+SCDSearchIndex::~SCDSearchIndex()
+{
+    close();
+}
+
+QString SCDSearchIndex::sidecarPath(const QString &scelPath)
+{
+    return scelPath + ".sidx";
+}
+
+QString SCDSearchIndex::cachePath(const QString &scelPath)
+{
+    const QByteArray key = QCryptographicHash::hash(QFileInfo(scelPath).absoluteFilePath().toUtf8(),
+                                                    QCryptographicHash::Sha1).toHex();
+    return QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation)
+           + "/scdtool/index/" + QString::fromLatin1(key) + ".sidx";
+}
+
+void SCDSearchIndex::close()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    m_file.close();
+    m_data.clear();
+    m_count = m_poolSize = 0;
+    m_offsets = m_order = nullptr;
+    m_pool = nullptr;
+    m_scelPath.clear();
+}
+
+bool SCDSearchIndex::open(const QString &scelPath, bool *rebuilt)
+{
+    close();
+    m_error.clear();
+    if (rebuilt) *rebuilt = false;
+
+    // 词库大小和文件头中的校验和决定索引是否过期
+    SCDHeader header;
+    if (!header.load(scelPath)) {
+        m_error = "非法的细胞词库文件头！";
+        return false;
+    }
+    const quint64 sourceSize = static_cast<quint64>(QFileInfo(scelPath).size());
+    const QByteArray checksum = header.data().mid(SCDChecksum::Offset, SCDChecksum::Size);
+    m_scelPath = scelPath;
+
+    if (load(sidecarPath(scelPath), sourceSize, checksum) || load(cachePath(scelPath), sourceSize, checksum)) {
+        return true;
+    }
+
+    if (!build(sourceSize, checksum)) {
+        m_scelPath.clear();
+        return false;
+    }
+    if (rebuilt) *rebuilt = true;
+
+    // 写出索引文件，下次直接映射；两处都写不出时只在内存中使用
+    for (const QString &path : {sidecarPath(scelPath), cachePath(scelPath)}) {
+        QDir().mkpath(QFileInfo(path).path());
+        QSaveFile out(path);
+        if (out.open(QIODevice::WriteOnly) && out.write(m_data) == m_data.size() && out.commit()) {
+            break;
+        }
+    }
+    return true;
+}
+
+bool SCDSearchIndex::load(const QString &indexPath, quint64 sourceSize, const QByteArray &checksum)
+{
+    m_file.setFileName(indexPath);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    const qint64 size = m_file.size();
+    m_map = m_file.map(0, size);
+    if (m_map && attach(m_map, size, sourceSize, checksum)) {
+        return true;
+    }
+    if (m_map) {
+        m_file.unmap(m_map);
+        m_map = nullptr;
+    }
+    m_file.close();
+    return false;
+}
+
+bool SCDSearchIndex::attach(const uchar *data, qint64 size, quint64 sourceSize, const QByteArray &checksum)
+{
+    if (size < indexHeaderSize || std::memcmp(data, indexMagic, sizeof(indexMagic)) != 0
+        || qFromLittleEndian<quint64>(data + 8) != sourceSize
+        || std::memcmp(data + 16, checksum.constData(), SCDChecksum::Size) != 0) {
+        return false;
+    }
+    const quint32 count = qFromLittleEndian<quint32>(data + 16 + SCDChecksum::Size);
+    const quint32 poolSize = qFromLittleEndian<quint32>(data + 20 + SCDChecksum::Size);
+    const qint64 offsetsSize = (static_cast<qint64>(count) + 1) * 4;
+    const qint64 orderSize = static_cast<qint64>(count) * 4;
+    if (size != indexHeaderSize + offsetsSize + orderSize + poolSize
+        || qFromLittleEndian<quint32>(data + indexHeaderSize + offsetsSize - 4) != poolSize) {
+        return false;
+    }
+
+    m_count = count;
+    m_poolSize = poolSize;
+    m_offsets = data + indexHeaderSize;
+    m_order = m_offsets + offsetsSize;
+    m_pool = reinterpret_cast<const char *>(m_order + orderSize);
+    return true;
+}
+
+bool SCDSearchIndex::build(quint64 sourceSize, const QByteArray &checksum)
+{
+    SCDEntryReader reader;
+    if (!reader.open(m_scelPath)) {
+        m_error = reader.errorString();
+        return false;
+    }
+
+    // 词条展开为文本行，记录每行起点
+    QByteArray pool;
+    std::vector<quint32> offsets;
+    offsets.reserve(reader.phraseCount() + 1);
+    SCDEntryView entry;
+    while (reader.next(entry)) {
+        const qsizetype start = pool.size();
+        if (!SCDEntryText::appendEntry(pool, reader.pinyinTable(), entry)) {
+            pool.truncate(start);
+            continue;
+        }
+        if (pool.size() > 0xFFFFFFFFLL) {
+            m_error = "词库过大，无法建立索引";
+            return false;
+        }
+        offsets.push_back(static_cast<quint32>(start));
+    }
+    if (reader.hasError()) {
+        m_error = reader.errorString();
+        return false;
+    }
+    const quint32 count = static_cast<quint32>(offsets.size());
+    offsets.push_back(static_cast<quint32>(pool.size()));
+
+    // 行号按整行字节序排序（即按音节序列、再按词）
+    std::vector<quint32> order(count);
+    for (quint32 i = 0; i < count; ++i) {
+        order[i] = i;
+    }
+    const char *text = pool.constData();
+    std::sort(order.begin(), order.end(), [&](quint32 a, quint32 b) {
+        return compareBytes(text + offsets[a], static_cast<int>(offsets[a + 1] - offsets[a]),
+                            text + offsets[b], static_cast<int>(offsets[b + 1] - offsets[b])) < 0;
+    });
+
+    const qint64 total = indexHeaderSize + (static_cast<qint64>(count) * 2 + 1) * 4 + pool.size();
+    m_data.resize(total);
+    uchar *out = reinterpret_cast<uchar *>(m_data.data());
+    std::memcpy(out, indexMagic, sizeof(indexMagic));
+    qToLittleEndian<quint64>(sourceSize, out + 8);
+    std::memcpy(out + 16, checksum.constData(), SCDChecksum::Size);
+    qToLittleEndian<quint32>(count, out + 16 + SCDChecksum::Size);
+    qToLittleEndian<quint32>(static_cast<quint32>(pool.size()), out + 20 + SCDChecksum::Size);
+    uchar *p = out + indexHeaderSize;
+    qToLittleEndian<quint32>(offsets.data(), static_cast<qsizetype>(offsets.size()), p);
+    p += offsets.size() * 4;
+    qToLittleEndian<quint32>(order.data(), static_cast<qsizetype>(order.size()), p);
+    p += order.size() * 4;
+    std::memcpy(p, pool.constData(), static_cast<size_t>(pool.size()));
+
+    return attach(out, total, sourceSize, checksum);
+}
+
+const char *SCDSearchIndex::line(quint32 i, int *length) const
+{
+    const quint32 start = qFromLittleEndian<quint32>(m_offsets + static_cast<qint64>(i) * 4);
+    const quint32 end = qFromLittleEndian<quint32>(m_offsets + (static_cast<qint64>(i) + 1) * 4);
+    *length = static_cast<int>(end - start);
+    return m_pool + start;
+}
+
+QList<QByteArray> SCDSearchIndex::search(const QString &query, int limit, qint64 *total) const
+{
+    QList<QByteArray> results;
+    qint64 matched = 0;
+    auto collect = [&](quint32 i) {
+        ++matched;
+        if (limit <= 0 || results.size() < limit) {
+            int length = 0;
+            const char *text = line(i, &length);
+            results.append(QByteArray(text, length - 1));
+        }
+    };
+
+    const QByteArray utf8 = query.trimmed().toUtf8();
+    const bool ascii = std::all_of(utf8.begin(), utf8.end(), [](char c) { return static_cast<uchar>(c) < 0x80; });
+
+    if (!utf8.isEmpty() && !ascii) {
+        // 按词查找子串：只算落在空格之后（词部分）的命中，同一行只计一次
+        const QByteArray pool = QByteArray::fromRawData(m_pool, m_poolSize);
+        qsizetype from = 0;
+        quint32 row = 0;
+        while ((from = pool.indexOf(utf8, from)) >= 0) {
+            // 行偏移递增，从上一个命中的行向后找命中所在的行
+            while (qFromLittleEndian<quint32>(m_offsets + (static_cast<qint64>(row) + 1) * 4) <= from) {
+                ++row;
+            }
+            int length = 0;
+            const char *text = line(row, &length);
+            const char *space = static_cast<const char *>(std::memchr(text, ' ', static_cast<size_t>(length)));
+            if (!space || m_pool + from < space) {
+                ++from;
+                continue;
+            }
+            collect(row);
+            from = qFromLittleEndian<quint32>(m_offsets + (static_cast<qint64>(row) + 1) * 4);
+        }
+    } else if (!utf8.isEmpty()) {
+        // 拼音：规范为 'a'b 形式；末尾 * 为前缀查询，否则要求音节序列完全相同（后跟空格）
+        QByteArray key("'");
+        for (const char c : utf8) {
+            if (c != ' ' && !(key.size() == 1 && c == '\'')) {
+                key.append(c >= 'A' && c <= 'Z' ? static_cast<char>(c + 32) : c);
+            }
+        }
+        const bool prefix = key.endsWith('*');
+        if (prefix) {
+            key.chop(1);
+        }
+        if (!prefix) {
+            key.append(' ');
+        }
+
+        auto rowAt = [this](quint32 k) { return qFromLittleEndian<quint32>(m_order + static_cast<qint64>(k) * 4); };
+        auto lowerBound = [&](bool upper) {
+            quint32 lo = 0;
+            quint32 hi = m_count;
+            while (lo < hi) {
+                const quint32 mid = lo + (hi - lo) / 2;
+                int length = 0;
+                const char *text = line(rowAt(mid), &length);
+                // 只比较前 key.size() 字节：等于时视为落在匹配区间内
+                int c = compareBytes(text, qMin(length, static_cast<int>(key.size())), key.constData(),
+                                     static_cast<int>(key.size()));
+                if (c < 0 || (upper && c == 0)) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            return lo;
+        };
+        const quint32 first = lowerBound(false);
+        const quint32 last = lowerBound(true);
+        const quint32 end = limit > 0 ? first + qMin(static_cast<quint32>(limit), last - first) : last;
+        for (quint32 k = first; k < end; ++k) {
+            collect(rowAt(k));
+        }
+        matched = last - first;
+    }
+
+    if (total) *total = matched;
+    return results;
+}
@@ -0,0 +1,78 @@
+#ifndef SCDSEARCHINDEX_H
+#define SCDSEARCHINDEX_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QString>
+#include <QtGlobal>
+
+/**
+ * 细胞词库检索索引
+ *
+ * 把词库的全部词条展开为搜狗文本行（'bei'jing 北京），首尾相接存成一块文本区，
+ * 另存每行的起始偏移和按整行字节序排好的行号。整行按字节比较恰好等价于按音节序列排序
+ * （' 小于任何字母、空格又小于 '），所以拼音查询只需在行号数组上二分；
+ * 按词查询在连续的文本区上做子串查找，不再解析词库。
+ *
+ * 索引文件（词库同目录的 <词库>.sidx，目录不可写时放在 ~/.cache/scdtool/index/）可以直接映射使用：
+ *   "SCDSIDX1", uint64 词库大小, 16 字节校验和（词库文件头 0x00C）, uint32 词条数, uint32 文本区字节数,
+ *   uint32 行偏移[词条数 + 1], uint32 排序后的行号[词条数], 文本区
+ * 词库大小或校验和变化时重建；只改文件头描述信息（scdeditor）不影响索引。
+ */
+class SCDSearchIndex
+{
+public:
+    SCDSearchIndex() = default;
+    ~SCDSearchIndex();
+
+    SCDSearchIndex(const SCDSearchIndex &) = delete;
+    SCDSearchIndex &operator=(const SCDSearchIndex &) = delete;
+
+    /**
+     * 打开词库的索引：已有且未过期的索引文件直接映射，否则解析词库重建并写出索引文件
+     * （写不出时只在内存中使用）。rebuilt 返回是否重新解析了词库
+     */
+    bool open(const QString &scelPath, bool *rebuilt = nullptr);
+    void close();
+
+    QString scelPath() const { return m_scelPath; }
+    quint32 entryCount() const { return m_count; }
+
+    /**
+     * 查询，返回匹配的搜狗文本行（不含换行符），最多 limit 条（limit <= 0 不限），total 返回匹配总数。
+     *   bei'jing（开头的 ' 可省略）：音节序列完全相同的词条，按拼音排序
+     *   bei'jing*：拼音以此开头的词条（bei'jing'shi 等），按拼音排序
+     *   含中文（非 ASCII）：词中包含该子串的词条，按词库中的顺序
+     */
+    QList<QByteArray> search(const QString &query, int limit = 0, qint64 *total = nullptr) const;
+
+    QString errorString() const { return m_error; }
+
+    // 词库同目录的索引文件路径 / 缓存目录中的索引文件路径
+    static QString sidecarPath(const QString &scelPath);
+    static QString cachePath(const QString &scelPath);
+
+private:
+    bool load(const QString &indexPath, quint64 sourceSize, const QByteArray &checksum);
+    bool build(quint64 sourceSize, const QByteArray &checksum);
+    bool attach(const uchar *data, qint64 size, quint64 sourceSize, const QByteArray &checksum);
+
+    // 第 i 行（含换行符）
+    const char *line(quint32 i, int *length) const;
+
+    QString m_scelPath;
+    QFile m_file;
+    uchar *m_map = nullptr;
+    QByteArray m_data; // 未映射时索引数据在内存中
+
+    quint32 m_count = 0;
+    const uchar *m_offsets = nullptr;
+    const uchar *m_order = nullptr;
+    const char *m_pool = nullptr;
+    quint32 m_poolSize = 0;
+
+    QString m_error;
+};
+
+#endif // SCDSEARCHINDEX_H
@@ -0,0 +1,185 @@
+#include "SCDStats.h"
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+namespace {
+
+// 面板中显示的中文名称，未列出的名称原样显示
+struct Label {
+    const char *name;
+    const char *label;
+};
+
+constexpr Label stageLabels[] = {
+    {"detect", "编码检测"}, {"read", "读取"},     {"decode", "解码"},     {"extract", "提取词条"},
+    {"pinyin", "转拼音"},   {"parse", "解析"},    {"dedup", "去重"},      {"sort", "排序去重"},
+    {"write", "写出"},      {"checksum", "校验和"},
+};
+
+constexpr Label counterLabels[] = {
+    {"lines", "行数"},         {"phrases", "词条数"},      {"duplicates", "重复（已去掉）"},
+    {"skipped", "无法识别"},   {"groups", "拼音组数"},     {"bytesIn", "输入字节"},
+    {"bytesOut", "输出字节"},
+};
+
+template <size_t N>
+QString labelOf(const Label (&labels)[N], const QByteArray &name)
+{
+    for (const Label &label : labels) {
+        if (name == label.name) {
+            return QString::fromUtf8(label.label);
+        }
+    }
+    return QString::fromUtf8(name);
+}
+
+// 写出 JSON 字符串：转义引号和反斜杠，去掉控制字符
+void appendJsonString(QByteArray &out, const QByteArray &text)
+{
+    out.append('"');
+    for (const char c : text) {
+        if (c == '"' || c == '\\') {
+            out.append('\\');
+        }
+        if (static_cast<uchar>(c) >= 0x20) {
+            out.append(c);
+        }
+    }
+    out.append('"');
+}
+
+} // namespace
+
+SCDStats::Item &SCDStats::find(std::vector<Item> &items, const char *name)
+{
+    for (Item &item : items) {
+        if (item.name == name) {
+            return item;
+        }
+    }
+    items.push_back({QByteArray(name), 0});
+    return items.back();
+}
+
+void SCDStats::addStage(const char *name, qint64 nanoseconds)
+{
+    find(m_stages, name).value += nanoseconds;
+}
+
+void SCDStats::addCounter(const char *name, qint64 value)
+{
+    find(m_counters, name).value += value;
+}
+
+void SCDStats::setCounter(const char *name, qint64 value)
+{
+    find(m_counters, name).value = value;
+}
+
+qint64 SCDStats::counter(const char *name) const
+{
+    for (const Item &item : m_counters) {
+        if (item.name == name) {
+            return item.value;
+        }
+    }
+    return 0;
+}
+
+qint64 SCDStats::total() const
+{
+    if (m_total >= 0) {
+        return m_total;
+    }
+    qint64 sum = 0;
+    for (const Item &stage : m_stages) {
+        sum += stage.value;
+    }
+    return sum;
+}
+
+void SCDStats::clear()
+{
+    m_stages.clear();
+    m_counters.clear();
+    m_total = -1;
+}
+
+QByteArray SCDStats::toJson() const
+{
+    QByteArray out("{\"tool\":");
+    appendJsonString(out, m_tool.toUtf8());
+    out.append(",\"totalMs\":");
+    out.append(QByteArray::number(total() / 1e6, 'f', 3));
+    out.append(",\"stages\":[");
+    for (size_t i = 0; i < m_stages.size(); ++i) {
+        out.append(i > 0 ? ",{\"name\":" : "{\"name\":");
+        appendJsonString(out, m_stages[i].name);
+        out.append(",\"ms\":");
+        out.append(QByteArray::number(m_stages[i].value / 1e6, 'f', 3));
+        out.append('}');
+    }
+    out.append("],\"counters\":{");
+    for (size_t i = 0; i < m_counters.size(); ++i) {
+        if (i > 0) {
+            out.append(',');
+        }
+        appendJsonString(out, m_counters[i].name);
+        out.append(':');
+        out.append(QByteArray::number(m_counters[i].value));
+    }
+    out.append("}}");
+    return out;
+}
+
+bool SCDStats::fromJson(const QByteArray &line, SCDStats *stats)
+{
+    const QByteArray trimmed = line.trimmed();
+    if (!trimmed.startsWith("{\"tool\"")) {
+        return false;
+    }
+    const QJsonDocument document = QJsonDocument::fromJson(trimmed);
+    const QJsonObject object = document.object();
+    if (!document.isObject() || !object.value("stages").isArray()) {
+        return false;
+    }
+
+    stats->clear();
+    stats->setTool(object.value("tool").toString());
+    for (const QJsonValue &value : object.value("stages").toArray()) {
+        const QJsonObject stage = value.toObject();
+        stats->addStage(stage.value("name").toString().toUtf8().constData(),
+                        static_cast<qint64>(stage.value("ms").toDouble() * 1e6));
+    }
+    const QJsonObject counters = object.value("counters").toObject();
+    for (auto it = counters.begin(); it != counters.end(); ++it) {
+        stats->setCounter(it.key().toUtf8().constData(), static_cast<qint64>(it.value().toDouble()));
+    }
+    stats->setTotal(static_cast<qint64>(object.value("totalMs").toDouble() * 1e6));
+    return true;
+}
+
+QString SCDStats::toText() const
+{
+    qint64 stageSum = 0;
+    for (const Item &stage : m_stages) {
+        stageSum += stage.value;
+    }
+
+    QString text = QString("%1　总耗时 %2 ms\n").arg(m_tool).arg(total() / 1e6, 0, 'f', 1);
+    for (const Item &stage : m_stages) {
+        const double share = stageSum > 0 ? stage.value * 100.0 / stageSum : 0;
+        text += QString("%1  %2 ms  %3%\n")
+                    .arg(labelOf(stageLabels, stage.name), -8)
+                    .arg(stage.value / 1e6, 10, 'f', 1)
+                    .arg(share, 5, 'f', 1);
+    }
+    if (stageSum > total() * 21 / 20) {
+        text += "（并行阶段为各线程累计耗时，占比按各阶段之和计算）\n";
+    }
+    for (const Item &counter : m_counters) {
+        text += QString("%1：%2\n").arg(labelOf(counterLabels, counter.name)).arg(counter.value);
+    }
+    return text;
+}
@@ -0,0 +1,84 @@
+#ifndef SCDSTATS_H
+#define SCDSTATS_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <QtGlobal>
+#include <vector>
+
+/**
+ * 工具运行统计：各阶段耗时和计数
+ *
+ * 阶段和计数按第一次出现的顺序保存，同名累加。--stats=json 时以一行 JSON 输出到标准错误：
+ *   {"tool":"scdmaker","totalMs":12.3,"stages":[{"name":"read","ms":1.2},...],
+ *    "counters":{"lines":100,"phrases":98,...}}
+ * txtmaker 输出相同结构，界面按这一结构显示统计面板。
+ * 多线程的阶段（如 txtmaker 的解码、转拼音）记录的是各 worker 的累计耗时，总和可以超过 totalMs。
+ */
+class SCDStats
+{
+public:
+    explicit SCDStats(const QString &tool = QString()) : m_tool(tool) {}
+
+    QString tool() const { return m_tool; }
+    void setTool(const QString &tool) { m_tool = tool; }
+
+    void addStage(const char *name, qint64 nanoseconds);
+    void addCounter(const char *name, qint64 value);
+    void setCounter(const char *name, qint64 value);
+    qint64 counter(const char *name) const;
+
+    // 总耗时；未设置时为各阶段之和
+    void setTotal(qint64 nanoseconds) { m_total = nanoseconds; }
+    qint64 total() const;
+
+    bool isEmpty() const { return m_stages.empty() && m_counters.empty(); }
+    void clear();
+
+    // 单行 JSON（不含换行符）
+    QByteArray toJson() const;
+
+    // 解析 toJson() 或 txtmaker / scdmaker 输出的一行，不是统计行时返回 false
+    static bool fromJson(const QByteArray &line, SCDStats *stats);
+
+    // 统计面板中显示的文本：每阶段一行（耗时、占比），之后是计数
+    QString toText() const;
+
+    // 计时到作用域结束，计入 name 阶段；stats 为空时什么也不做
+    class Scope
+    {
+    public:
+        Scope(SCDStats *stats, const char *name) : m_stats(stats), m_name(name)
+        {
+            if (m_stats) m_timer.start();
+        }
+        ~Scope()
+        {
+            if (m_stats) m_stats->addStage(m_name, m_timer.nsecsElapsed());
+        }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        SCDStats *m_stats;
+        const char *m_name;
+        QElapsedTimer m_timer;
+    };
+
+private:
+    struct Item {
+        QByteArray name;
+        qint64 value;
+    };
+
+    static Item &find(std::vector<Item> &items, const char *name);
+
+    QString m_tool;
+    std::vector<Item> m_stages;   // 纳秒
+    std::vector<Item> m_counters;
+    qint64 m_total = -1;
+};
+
+#endif // SCDSTATS_H
@@ -0,0 +1,437 @@
+#include "SCDText.h"
+#include <QtEndian>
+#include <cstring>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define SCDTEXT_X86 1
+#include <immintrin.h>
+#define SCDTEXT_TARGET(isa) __attribute__((target(isa)))
+// 辅助函数强制内联到各指令集版本中，避免 SSE 与 AVX 代码互相调用时的切换开销
+#define SCDTEXT_INLINE inline __attribute__((always_inline))
+#endif
+
+namespace {
+
+// 每个码元最多输出 3 字节（代理对 2 个码元输出 4 字节），另留 16 字节供整块写入越过末尾
+inline qsizetype utf8Capacity(qsizetype units)
+{
+    return units * 3 + 16;
+}
+
+// 标量：转换一个码元（高代理项与下一个码元组成代理对），返回消耗的码元数
+inline int encodeUnit(const uchar *in, qsizetype remain, char *&out)
+{
+    uint c = qFromLittleEndian<quint16>(in);
+    if (c < 0x80) {
+        *out++ = static_cast<char>(c);
+        return 1;
+    }
+    if (c < 0x800) {
+        *out++ = static_cast<char>(0xC0 | (c >> 6));
+        *out++ = static_cast<char>(0x80 | (c & 0x3F));
+        return 1;
+    }
+    if (c >= 0xD800 && c < 0xE000) {
+        if (c < 0xDC00 && remain > 1) {
+            const uint low = qFromLittleEndian<quint16>(in + 2);
+            if (low >= 0xDC00 && low < 0xE000) {
+                c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+                *out++ = static_cast<char>(0xF0 | (c >> 18));
+                *out++ = static_cast<char>(0x80 | ((c >> 12) & 0x3F));
+                *out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+                *out++ = static_cast<char>(0x80 | (c & 0x3F));
+                return 2;
+            }
+        }
+        c = 0xFFFD;
+    }
+    *out++ = static_cast<char>(0xE0 | (c >> 12));
+    *out++ = static_cast<char>(0x80 | ((c >> 6) & 0x3F));
+    *out++ = static_cast<char>(0x80 | (c & 0x3F));
+    return 1;
+}
+
+qsizetype utf16ToUtf8Scalar(const uchar *in, qsizetype units, char *out)
+{
+    char *start = out;
+    qsizetype i = 0;
+    while (i < units) {
+        i += encodeUnit(in + i * 2, units - i, out);
+    }
+    return out - start;
+}
+
+#ifdef SCDTEXT_X86
+
+// 8 个码元是否全部小于 0x80（只看 mask 选中的码元）
+SCDTEXT_INLINE bool isAscii(__m128i v, int mask)
+{
+    const __m128i high = _mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xFF80)));
+    return (_mm_movemask_epi8(_mm_cmpeq_epi16(high, _mm_setzero_si128())) & mask) == mask;
+}
+
+// 8 个码元是否全部落在 [0x800, 0xD800) 或 [0xE000, 0xFFFF]，即都编码为 3 字节
+SCDTEXT_INLINE bool isThreeByte(__m128i v, int mask)
+{
+    const __m128i top = _mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xF800)));
+    const __m128i bad = _mm_or_si128(_mm_cmpeq_epi16(top, _mm_setzero_si128()),
+                                     _mm_cmpeq_epi16(top, _mm_set1_epi16(static_cast<short>(0xD800))));
+    return (_mm_movemask_epi8(bad) & mask) == 0;
+}
+
+// 8 个码元编码为 24 字节：先分别算出三个字节，再用 pshufb 交错排列
+SCDTEXT_TARGET("ssse3") SCDTEXT_INLINE void encodeThreeByte(__m128i v, char *out)
+{
+    const __m128i low6 = _mm_set1_epi16(0x3F);
+    const __m128i b0 = _mm_or_si128(_mm_srli_epi16(v, 12), _mm_set1_epi16(0xE0));
+    const __m128i b1 = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(v, 6), low6), _mm_set1_epi16(0x80));
+    const __m128i b2 = _mm_or_si128(_mm_and_si128(v, low6), _mm_set1_epi16(0x80));
+
+    // t01：每个 16 位里低字节为 b0、高字节为 b1；t2：b2 紧密排列
+    const __m128i t01 = _mm_or_si128(b0, _mm_slli_epi16(b1, 8));
+    const __m128i t2 = _mm_packus_epi16(b2, b2);
+
+    const __m128i out0 = _mm_or_si128(
+        _mm_shuffle_epi8(t01, _mm_setr_epi8(0, 1, -1, 2, 3, -1, 4, 5, -1, 6, 7, -1, 8, 9, -1, 10)),
+        _mm_shuffle_epi8(t2, _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, 4, -1)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), out0);
+    const __m128i out1 = _mm_or_si128(
+        _mm_shuffle_epi8(t01, _mm_setr_epi8(11, -1, 12, 13, -1, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1)),
+        _mm_shuffle_epi8(t2, _mm_setr_epi8(-1, 5, -1, -1, 6, -1, -1, 7, -1, -1, -1, -1, -1, -1, -1, -1)));
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(out + 16), out1);
+}
+
+// 4 个码元中 ASCII 与 3 字节混排时的压缩表：按 ASCII 位图选出每个码元的有效字节
+struct CompactTable {
+    alignas(16) char shuffle[16][16];
+    int length[16];
+
+    constexpr CompactTable()
+        : shuffle{}, length{}
+    {
+        for (int mask = 0; mask < 16; ++mask) {
+            int n = 0;
+            for (int j = 0; j < 4; ++j) {
+                const int bytes = (mask >> j) & 1 ? 1 : 3;
+                for (int k = 0; k < bytes; ++k) {
+                    shuffle[mask][n++] = static_cast<char>(j * 3 + k);
+                }
+            }
+            length[mask] = n;
+            while (n < 16) {
+                shuffle[mask][n++] = static_cast<char>(0x80);
+            }
+        }
+    }
+};
+
+constexpr CompactTable compactTable;
+
+// 4 个码元一块（词条多为 2~4 个汉字），只含 ASCII 和 3 字节字符时走整块路径，返回是否处理
+SCDTEXT_TARGET("ssse3") SCDTEXT_INLINE bool encodeBlock4(const uchar *in, char *&out)
+{
+    const __m128i v = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(in));
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xFF80))), zero);
+    const __m128i top = _mm_and_si128(v, _mm_set1_epi16(static_cast<short>(0xF800)));
+    const __m128i bad = _mm_or_si128(_mm_andnot_si128(ascii, _mm_cmpeq_epi16(top, zero)),
+                                     _mm_cmpeq_epi16(top, _mm_set1_epi16(static_cast<short>(0xD800))));
+    if (_mm_movemask_epi8(bad) & 0x00FF) {
+        return false;
+    }
+    const int asciiBits = _mm_movemask_epi8(_mm_packs_epi16(ascii, zero)) & 0x0F;
+    if (asciiBits == 0x0F) {
+        const int packed = _mm_cvtsi128_si32(_mm_packus_epi16(v, v));
+        std::memcpy(out, &packed, 4);
+        out += 4;
+        return true;
+    }
+
+    // ASCII 码元的首字节取原值，其余按 3 字节编码，交错后再去掉 ASCII 码元多出的两个字节
+    const __m128i low6 = _mm_set1_epi16(0x3F);
+    const __m128i lead = _mm_or_si128(_mm_srli_epi16(v, 12), _mm_set1_epi16(0xE0));
+    const __m128i b0 = _mm_or_si128(_mm_and_si128(ascii, v), _mm_andnot_si128(ascii, lead));
+    const __m128i b1 = _mm_or_si128(_mm_and_si128(_mm_srli_epi16(v, 6), low6), _mm_set1_epi16(0x80));
+    const __m128i b2 = _mm_or_si128(_mm_and_si128(v, low6), _mm_set1_epi16(0x80));
+    const __m128i t01 = _mm_or_si128(b0, _mm_slli_epi16(b1, 8));
+    const __m128i t2 = _mm_packus_epi16(b2, b2);
+    const __m128i interleaved = _mm_or_si128(
+        _mm_shuffle_epi8(t01, _mm_setr_epi8(0, 1, -1, 2, 3, -1, 4, 5, -1, 6, 7, -1, -1, -1, -1, -1)),
+        _mm_shuffle_epi8(t2, _mm_setr_epi8(-1, -1, 0, -1, -1, 1, -1, -1, 2, -1, -1, 3, -1, -1, -1, -1)));
+    const __m128i shuffle = _mm_load_si128(reinterpret_cast<const __m128i *>(compactTable.shuffle[asciiBits]));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_shuffle_epi8(interleaved, shuffle));
+    out += compactTable.length[asciiBits];
+    return true;
+}
+
+// 处理一个 8 码元块；整块不同类时拆成两个 4 码元块，仍不行再逐个处理
+SCDTEXT_TARGET("ssse3") SCDTEXT_INLINE qsizetype encodeBlock8(const uchar *in, qsizetype remain, char *&out)
+{
+    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in));
+    if (isAscii(v, 0xFFFF)) {
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(out), _mm_packus_epi16(v, v));
+        out += 8;
+        return 8;
+    }
+    if (isThreeByte(v, 0xFFFF)) {
+        encodeThreeByte(v, out);
+        out += 24;
+        return 8;
+    }
+
+    qsizetype i = 0;
+    while (i < 8) {
+        if (i + 4 <= 8 && encodeBlock4(in + i * 2, out)) {
+            i += 4;
+            continue;
+        }
+        // 逐个处理到下一个 4 码元边界（代理对可能跨过边界）
+        const qsizetype stop = qMin<qsizetype>(i < 4 ? 4 : 8, remain);
+        while (i < stop) {
+            i += encodeUnit(in + i * 2, remain - i, out);
+        }
+    }
+    return i;
+}
+
+// 不足 8 个码元的结尾
+SCDTEXT_TARGET("ssse3") SCDTEXT_INLINE void encodeTail(const uchar *in, qsizetype i, qsizetype units, char *&out)
+{
+    if (i + 4 <= units && encodeBlock4(in + i * 2, out)) {
+        i += 4;
+    }
+    while (i < units) {
+        i += encodeUnit(in + i * 2, units - i, out);
+    }
+}
+
+SCDTEXT_TARGET("ssse3") qsizetype utf16ToUtf8Ssse3(const uchar *in, qsizetype units, char *out)
+{
+    char *start = out;
+    qsizetype i = 0;
+    while (i + 8 <= units) {
+        i += encodeBlock8(in + i * 2, units - i, out);
+    }
+    encodeTail(in, i, units, out);
+    return out - start;
+}
+
+SCDTEXT_TARGET("avx2") qsizetype utf16ToUtf8Avx2(const uchar *in, qsizetype units, char *out)
+{
+    char *start = out;
+    qsizetype i = 0;
+    const __m256i asciiMask = _mm256_set1_epi16(static_cast<short>(0xFF80));
+    const __m256i topMask = _mm256_set1_epi16(static_cast<short>(0xF800));
+    const __m256i surrogate = _mm256_set1_epi16(static_cast<short>(0xD800));
+    while (i + 16 <= units) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + i * 2));
+        if (_mm256_testz_si256(v, asciiMask)) {
+            // packus 按 128 位分别打包，再把两半的低 8 字节并到一起
+            const __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), 0x08);
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm256_castsi256_si128(packed));
+            out += 16;
+            i += 16;
+            continue;
+        }
+        const __m256i top = _mm256_and_si256(v, topMask);
+        const __m256i bad = _mm256_or_si256(_mm256_cmpeq_epi16(top, _mm256_setzero_si256()),
+                                            _mm256_cmpeq_epi16(top, surrogate));
+        if (_mm256_testz_si256(bad, bad)) {
+            encodeThreeByte(_mm256_castsi256_si128(v), out);
+            encodeThreeByte(_mm256_extracti128_si256(v, 1), out + 24);
+            out += 48;
+            i += 16;
+            continue;
+        }
+        i += encodeBlock8(in + i * 2, units - i, out);
+    }
+    while (i + 8 <= units) {
+        i += encodeBlock8(in + i * 2, units - i, out);
+    }
+    encodeTail(in, i, units, out);
+    return out - start;
+}
+
+#endif // SCDTEXT_X86
+
+using Utf16ToUtf8 = qsizetype (*)(const uchar *, qsizetype, char *);
+
+struct Kernel {
+    Utf16ToUtf8 utf16ToUtf8;
+    const char *name;
+};
+
+// 首次使用时按 CPU 选择一次
+Kernel selectKernel()
+{
+#ifdef SCDTEXT_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        return {utf16ToUtf8Avx2, "avx2"};
+    }
+    if (__builtin_cpu_supports("ssse3")) {
+        return {utf16ToUtf8Ssse3, "ssse3"};
+    }
+#endif
+    return {utf16ToUtf8Scalar, "scalar"};
+}
+
+const Kernel &kernel()
+{
+    static const Kernel selected = selectKernel();
+    return selected;
+}
+
+} // namespace
+
+void SCDText::appendUtf8(QByteArray &out, const uchar *utf16, qsizetype bytes)
+{
+    const qsizetype units = bytes / 2;
+    if (units <= 0) {
+        return;
+    }
+    const qsizetype at = out.size();
+    out.resize(at + utf8Capacity(units));
+    const qsizetype written = kernel().utf16ToUtf8(utf16, units, out.data() + at);
+    out.resize(at + written);
+}
+
+bool SCDText::appendUtf16(std::vector<char16_t> &out, const uchar *utf8, qsizetype length)
+{
+    const size_t at = out.size();
+    out.resize(at + length);
+    char16_t *dst = out.data() + at;
+    qsizetype i = 0;
+
+    while (i < length) {
+#ifdef __SSE2__
+        // 连续 16 个 ASCII 字节直接零扩展
+        if (i + 16 <= length) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(utf8 + i));
+            if (_mm_movemask_epi8(v) == 0) {
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst), _mm_unpacklo_epi8(v, _mm_setzero_si128()));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + 8), _mm_unpackhi_epi8(v, _mm_setzero_si128()));
+                dst += 16;
+                i += 16;
+                continue;
+            }
+        }
+#endif
+        uint c = utf8[i];
+        if (c < 0x80) {
+            *dst++ = static_cast<char16_t>(c);
+            ++i;
+            continue;
+        }
+
+        int extra = 0;
+        uint min = 0;
+        if ((c & 0xE0) == 0xC0) {
+            c &= 0x1F;
+            extra = 1;
+            min = 0x80;
+        } else if ((c & 0xF0) == 0xE0) {
+            c &= 0x0F;
+            extra = 2;
+            min = 0x800;
+        } else if ((c & 0xF8) == 0xF0) {
+            c &= 0x07;
+            extra = 3;
+            min = 0x10000;
+        } else {
+            out.resize(at);
+            return false;
+        }
+        if (i + extra >= length) {
+            out.resize(at);
+            return false;
+        }
+        for (int k = 1; k <= extra; ++k) {
+            const uint next = utf8[i + k];
+            if ((next & 0xC0) != 0x80) {
+                out.resize(at);
+                return false;
+            }
+            c = (c << 6) | (next & 0x3F);
+        }
+        i += extra + 1;
+
+        // 拒绝过长编码、代理项和超出 Unicode 范围的码点
+        if (c < min || (c >= 0xD800 && c < 0xE000) || c > 0x10FFFF) {
+            out.resize(at);
+            return false;
+        }
+        if (c >= 0x10000) {
+            c -= 0x10000;
+            *dst++ = static_cast<char16_t>(0xD800 + (c >> 10));
+            *dst++ = static_cast<char16_t>(0xDC00 + (c & 0x3FF));
+        } else {
+            *dst++ = static_cast<char16_t>(c);
+        }
+    }
+
+    out.resize(dst - out.data());
+    return true;
+}
+
+qsizetype SCDText::findNul16(const uchar *utf16, qsizetype units)
+{
+    qsizetype i = 0;
+#ifdef __SSE2__
+    for (; i + 8 <= units; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(utf16 + i * 2));
+        const int mask = _mm_movemask_epi8(_mm_cmpeq_epi16(v, _mm_setzero_si128()));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask) / 2;
+        }
+    }
+#endif
+    for (; i < units; ++i) {
+        if ((utf16[i * 2] | utf16[i * 2 + 1]) == 0) {
+            return i;
+        }
+    }
+    return units;
+}
+
+QString SCDText::fromFixedUtf16(const uchar *utf16, qsizetype bytes)
+{
+    const qsizetype length = findNul16(utf16, bytes / 2);
+    QString result(length, Qt::Uninitialized);
+    qFromLittleEndian<quint16>(utf16, length, result.data());
+    return std::move(result).trimmed();
+}
+
+bool SCDText::looksLikeUtf8(const uchar *data, qsizetype size)
+{
+    const qsizetype end = qMin<qsizetype>(size, 64 * 1024);
+    qsizetype i = 0;
+    while (i < end) {
+        const uchar c = data[i];
+        int extra = 0;
+        if (c < 0x80) {
+            ++i;
+            continue;
+        } else if ((c & 0xE0) == 0xC0) {
+            extra = 1;
+        } else if ((c & 0xF0) == 0xE0) {
+            extra = 2;
+        } else if ((c & 0xF8) == 0xF0) {
+            extra = 3;
+        } else {
+            return false;
+        }
+        for (int k = 1; k <= extra && i + k < end; ++k) {
+            if ((data[i + k] & 0xC0) != 0x80) {
+                return false;
+            }
+        }
+        i += extra + 1;
+    }
+    return true;
+}
+
+const char *SCDText::kernelName()
+{
+    return kernel().name;
+}
@@ -0,0 +1,37 @@
+#ifndef SCDTEXT_H
+#define SCDTEXT_H
+
+#include <QByteArray>
+#include <QString>
+#include <QtGlobal>
+#include <vector>
+
+/**
+ * 细胞词库字符串转码
+ *
+ * 文件中的字符串全部为 UTF-16LE。这里的函数由文件头读取、词条解析和词库生成共用：
+ * 直接写入预留好的输出缓冲区，不经过 QString 中转。x86-64 上按块处理 ASCII 和
+ * 3 字节 UTF-8（常用汉字）的连续片段（运行时选择 SSSE3 或 AVX2），其余情况逐个码元处理。
+ * 代理对按 UTF-16 规范组合，孤立的代理项替换为 U+FFFD。
+ */
+namespace SCDText {
+    // UTF-16LE 追加为 UTF-8
+    void appendUtf8(QByteArray &out, const uchar *utf16, qsizetype bytes);
+
+    // UTF-8 追加为 UTF-16（主机字节序），遇到非法序列时撤销本次追加并返回 false
+    bool appendUtf16(std::vector<char16_t> &out, const uchar *utf8, qsizetype length);
+
+    // 返回第一个 NUL 码元的下标，没有 NUL 时返回 units
+    qsizetype findNul16(const uchar *utf16, qsizetype units);
+
+    // 解码定长 UTF-16LE 字段：到第一个 NUL 为止，并去掉首尾空白
+    QString fromFixedUtf16(const uchar *utf16, qsizetype bytes);
+
+    // 粗略判断开头一段是否为 UTF-8（允许末尾截断的多字节序列）
+    bool looksLikeUtf8(const uchar *data, qsizetype size);
+
+    // 当前使用的指令集（"avx2"、"ssse3" 或 "scalar"），用于基准测试输出
+    const char *kernelName();
+}
+
+#endif // SCDTEXT_H
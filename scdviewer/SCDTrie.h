@@ -0,0 +1,283 @@
+#ifndef SCDTRIE_H
+#define SCDTRIE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/**
+ * 静态拼音 trie 的只读加载器（scdviewer --trie 导出的 .sdt 文件）
+ *
+ * 只依赖 C++ 标准库，可以单独拷给输入法引擎使用。文件映射到内存后 attach() 只检查文件头和各段边界，
+ * 不做任何反序列化，查询直接读映射的数据；启动开销与词库大小无关。
+ *
+ * 边是音节编号（按音节文本的字节序排列，可二分查找），节点按层序（与 LOUDS 相同的顺序）存放：
+ * 同一节点的子节点连续，子节点区间和词区间都由相邻两个节点的起点相减得到，每个节点只占 10 字节。
+ * 音节序列恰好等于某个节点路径的词条挂在该节点上，保持词库中的顺序（词频顺序）。
+ * 词按节点顺序排成一列，每 16 个一块做前缀压缩（front coding）：块内第一个词完整存放，
+ * 之后每个词只存与前一个词相同的前缀长度和其余部分，取词时最多解码 15 个前驱。
+ *
+ * 文件格式（小端，各段按 4 字节对齐）：
+ *   "SCDTRIE1", uint32 音节数 S, uint32 音节文本字节数, uint32 节点数 N, uint32 词数 W,
+ *   uint32 块数 B, uint32 词区字节数, uint32 最长词的码元数, uint32 保留
+ *   uint32 音节偏移[S + 1], 音节文本（ASCII，首尾相接）
+ *   uint16 边标签[N]（根节点为 0）
+ *   uint32 子节点起点[N + 1], uint32 词起点[N + 1]
+ *   uint32 块偏移[B + 1], 词区：
+ *     块内第一个词 varint 长度 + UTF-16LE；其余 varint 共同前缀长度 + varint 其余长度 + UTF-16LE
+ *
+ * 用法：
+ *   SCDTrie trie;
+ *   if (trie.attach(data, size)) {
+ *       const uint32_t node = trie.find("bei'jing", 8);
+ *       char16_t word[SCDTrie::MaxWordLength];
+ *       for (uint32_t k = 0; node != SCDTrie::NotFound && k < trie.wordCount(node); ++k) {
+ *           size_t length = trie.word(node, k, word, SCDTrie::MaxWordLength);
+ *       }
+ *   }
+ */
+class SCDTrie
+{
+public:
+    static constexpr uint32_t NotFound = 0xFFFFFFFFu;
+    static constexpr uint32_t Root = 0;
+    static constexpr uint32_t BucketSize = 16;
+    static constexpr size_t HeaderSize = 40;
+    static constexpr size_t MaxWordLength = 0x7FFF; // 细胞词库中词的字节数为 uint16
+
+    // data 须在 SCDTrie 的生命周期内有效（通常是映射的文件）；格式或边界不对时返回 false
+    bool attach(const void *data, size_t size)
+    {
+        const auto *p = static_cast<const unsigned char *>(data);
+        if (size < HeaderSize || std::memcmp(p, "SCDTRIE1", 8) != 0) {
+            return false;
+        }
+        m_syllableCount = u32(p + 8);
+        m_syllablePoolSize = u32(p + 12);
+        m_nodeCount = u32(p + 16);
+        m_wordCount = u32(p + 20);
+        m_bucketCount = u32(p + 24);
+        m_wordPoolSize = u32(p + 28);
+        m_maxWordLength = u32(p + 32);
+        if (m_nodeCount == 0 || m_maxWordLength > MaxWordLength
+            || m_bucketCount != (m_wordCount + BucketSize - 1) / BucketSize) {
+            return false;
+        }
+
+        // 逐段推进并检查不越界（用 64 位计算，避免恶意的计数溢出）
+        uint64_t at = HeaderSize;
+        const auto take = [&](uint64_t bytes) -> const unsigned char * {
+            const uint64_t begin = at;
+            at = (at + bytes + 3) & ~uint64_t(3);
+            return begin + bytes <= size ? p + begin : nullptr;
+        };
+        m_syllableOffsets = take((uint64_t(m_syllableCount) + 1) * 4);
+        m_syllables = reinterpret_cast<const char *>(take(m_syllablePoolSize));
+        m_labels = take(uint64_t(m_nodeCount) * 2);
+        m_childStart = take((uint64_t(m_nodeCount) + 1) * 4);
+        m_wordStart = take((uint64_t(m_nodeCount) + 1) * 4);
+        m_bucketOffsets = take((uint64_t(m_bucketCount) + 1) * 4);
+        m_words = take(m_wordPoolSize);
+        if (!m_syllableOffsets || !m_syllables || !m_labels || !m_childStart || !m_wordStart
+            || !m_bucketOffsets || !m_words) {
+            m_nodeCount = 0;
+            return false;
+        }
+        return true;
+    }
+
+    uint32_t syllableCount() const { return m_syllableCount; }
+    uint32_t nodeCount() const { return m_nodeCount; }
+    uint32_t wordCount() const { return m_wordCount; }
+    uint32_t maxWordLength() const { return m_maxWordLength; }
+
+    // 音节编号 -> 文本（不以 0 结尾）
+    const char *syllable(uint32_t id, size_t *length) const
+    {
+        if (id >= m_syllableCount) {
+            return nullptr;
+        }
+        const uint32_t begin = u32(m_syllableOffsets + id * 4);
+        const uint32_t end = u32(m_syllableOffsets + (id + 1) * 4);
+        if (begin > end || end > m_syllablePoolSize) {
+            return nullptr;
+        }
+        *length = end - begin;
+        return m_syllables + begin;
+    }
+
+    // 音节文本 -> 编号（二分查找），不存在时返回 NotFound
+    uint32_t syllableId(const char *text, size_t length) const
+    {
+        uint32_t lo = 0;
+        uint32_t hi = m_syllableCount;
+        while (lo < hi) {
+            const uint32_t mid = lo + (hi - lo) / 2;
+            size_t midLength = 0;
+            const char *midText = syllable(mid, &midLength);
+            if (!midText) {
+                return NotFound;
+            }
+            const int c = compare(midText, midLength, text, length);
+            if (c == 0) {
+                return mid;
+            }
+            if (c < 0) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return NotFound;
+    }
+
+    // 子节点区间 [childBegin, childEnd)，用于按前缀枚举
+    uint32_t childBegin(uint32_t node) const { return clampNode(u32(m_childStart + node * 4)); }
+    uint32_t childEnd(uint32_t node) const { return clampNode(u32(m_childStart + (node + 1) * 4)); }
+    uint16_t label(uint32_t node) const { return u16(m_labels + node * 2); }
+
+    // 沿边 syllableId 走一步（在子节点标签上二分），没有这条边时返回 NotFound
+    uint32_t child(uint32_t node, uint32_t syllableId) const
+    {
+        if (node >= m_nodeCount) {
+            return NotFound;
+        }
+        uint32_t lo = childBegin(node);
+        uint32_t hi = childEnd(node);
+        while (lo < hi) {
+            const uint32_t mid = lo + (hi - lo) / 2;
+            const uint16_t value = label(mid);
+            if (value == syllableId) {
+                return mid;
+            }
+            if (value < syllableId) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        return NotFound;
+    }
+
+    // 'bei'jing / bei'jing 形式的拼音 -> 节点，任一音节不存在或路径不存在时返回 NotFound
+    uint32_t find(const char *pinyin, size_t length) const
+    {
+        uint32_t node = Root;
+        size_t i = 0;
+        while (i < length && node != NotFound) {
+            if (pinyin[i] == '\'') {
+                ++i;
+                continue;
+            }
+            size_t end = i;
+            while (end < length && pinyin[end] != '\'') {
+                ++end;
+            }
+            const uint32_t id = syllableId(pinyin + i, end - i);
+            node = id == NotFound ? NotFound : child(node, id);
+            i = end;
+        }
+        return node;
+    }
+
+    // 挂在节点上的词数
+    uint32_t wordCount(uint32_t node) const
+    {
+        if (node >= m_nodeCount) {
+            return 0;
+        }
+        const uint32_t begin = u32(m_wordStart + node * 4);
+        const uint32_t end = u32(m_wordStart + (node + 1) * 4);
+        return end > begin && end <= m_wordCount ? end - begin : 0;
+    }
+
+    // 节点上的第 k 个词（UTF-16），写入 out 并返回码元数；capacity 不小于 maxWordLength() 时不会截断
+    size_t word(uint32_t node, uint32_t k, char16_t *out, size_t capacity) const
+    {
+        if (k >= wordCount(node)) {
+            return 0;
+        }
+        return wordAt(u32(m_wordStart + node * 4) + k, out, capacity);
+    }
+
+    // 全局第 index 个词（按节点顺序）
+    size_t wordAt(uint32_t index, char16_t *out, size_t capacity) const
+    {
+        if (index >= m_wordCount) {
+            return 0;
+        }
+        const uint32_t bucket = index / BucketSize;
+        uint32_t pos = u32(m_bucketOffsets + bucket * 4);
+        const uint32_t end = u32(m_bucketOffsets + (bucket + 1) * 4);
+        if (end > m_wordPoolSize || pos > end) {
+            return 0;
+        }
+
+        size_t length = 0;
+        for (uint32_t i = bucket * BucketSize; i <= index; ++i) {
+            const uint32_t shared = i == bucket * BucketSize ? 0 : varint(&pos, end);
+            const uint32_t rest = varint(&pos, end);
+            if (shared > length || pos + uint64_t(rest) * 2 > end) {
+                return 0;
+            }
+            length = shared;
+            for (uint32_t j = 0; j < rest; ++j, pos += 2) {
+                if (length < capacity) {
+                    out[length] = static_cast<char16_t>(u16(m_words + pos));
+                }
+                ++length;
+            }
+        }
+        return length < capacity ? length : capacity;
+    }
+
+private:
+    static uint32_t u32(const unsigned char *p)
+    {
+        return uint32_t(p[0]) | uint32_t(p[1]) << 8 | uint32_t(p[2]) << 16 | uint32_t(p[3]) << 24;
+    }
+    static uint16_t u16(const unsigned char *p) { return static_cast<uint16_t>(p[0] | p[1] << 8); }
+
+    static int compare(const char *a, size_t aLength, const char *b, size_t bLength)
+    {
+        const int c = std::memcmp(a, b, aLength < bLength ? aLength : bLength);
+        if (c != 0) {
+            return c;
+        }
+        return aLength < bLength ? -1 : (aLength > bLength ? 1 : 0);
+    }
+
+    uint32_t clampNode(uint32_t index) const { return index < m_nodeCount ? index : m_nodeCount; }
+
+    // LEB128，越界时返回 0 并把 pos 移到 end
+    uint32_t varint(uint32_t *pos, uint32_t end) const
+    {
+        uint32_t value = 0;
+        for (int shift = 0; *pos < end && shift < 32; shift += 7) {
+            const unsigned char byte = m_words[(*pos)++];
+            value |= uint32_t(byte & 0x7F) << shift;
+            if (!(byte & 0x80)) {
+                return value;
+            }
+        }
+        *pos = end;
+        return 0;
+    }
+
+    uint32_t m_syllableCount = 0;
+    uint32_t m_syllablePoolSize = 0;
+    uint32_t m_nodeCount = 0;
+    uint32_t m_wordCount = 0;
+    uint32_t m_bucketCount = 0;
+    uint32_t m_wordPoolSize = 0;
+    uint32_t m_maxWordLength = 0;
+    const unsigned char *m_syllableOffsets = nullptr;
+    const char *m_syllables = nullptr;
+    const unsigned char *m_labels = nullptr;
+    const unsigned char *m_childStart = nullptr;
+    const unsigned char *m_wordStart = nullptr;
+    const unsigned char *m_bucketOffsets = nullptr;
+    const unsigned char *m_words = nullptr;
+};
+
+#endif // SCDTRIE_H
@@ -0,0 +1,204 @@
+#include "SCDTrieWriter.h"
+#include "SCDDictionary.h"
+#include "SCDEntryReader.h"
+#include "SCDTrie.h"
+#include <QByteArray>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+
+// 层序展开时的一个节点：排序后词条 [begin, end) 的前 depth 个音节相同
+struct Node {
+    quint32 begin;
+    quint32 end;
+    quint16 depth;
+    quint16 label;
+};
+
+void appendU32(QByteArray &out, quint32 value)
+{
+    const quint32 le = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char *>(&le), 4);
+}
+
+void appendVarint(QByteArray &out, quint32 value)
+{
+    while (value >= 0x80) {
+        out.append(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    out.append(static_cast<char>(value));
+}
+
+void alignTo4(QByteArray &out)
+{
+    while (out.size() % 4 != 0) {
+        out.append('\0');
+    }
+}
+
+} // namespace
+
+QString SCDTrieWriter::defaultPath(const QString &scelPath)
+{
+    const QFileInfo info(scelPath);
+    return info.path() + "/" + info.completeBaseName() + ".sdt";
+}
+
+bool SCDTrieWriter::write(const QString &scelPath, const QString &triePath)
+{
+    SCDEntryReader reader;
+    if (!reader.open(scelPath)) {
+        m_error = reader.errorString();
+        return false;
+    }
+
+    // 音节按文本的字节序重新编号，加载器可以二分查找；空音节（下标空位）不编号
+    const SCDPinyinTable &pinyin = reader.pinyinTable();
+    std::vector<QByteArray> syllableText;
+    std::vector<int> byText;
+    for (int i = 0; i < pinyin.size(); ++i) {
+        int length = 0;
+        const char *text = pinyin.syllable(static_cast<quint16>(i), &length);
+        syllableText.push_back(text ? QByteArray(text, length) : QByteArray());
+        if (text) {
+            byText.push_back(i);
+        }
+    }
+    std::sort(byText.begin(), byText.end(), [&](int a, int b) { return syllableText[a] < syllableText[b]; });
+    std::vector<int> remap(syllableText.size(), -1);
+    for (size_t id = 0; id < byText.size(); ++id) {
+        remap[byText[id]] = static_cast<int>(id);
+    }
+
+    // 读入全部词条（音节换成新编号）；音节下标非法的跳过
+    SCDDictionary entries;
+    entries.reserve(reader.phraseCount(), size_t(reader.phraseCount()) * 3, size_t(reader.phraseCount()) * 6);
+    SCDEntryView view;
+    while (reader.next(view)) {
+        if (view.syllableCount > 0 && view.wordBytes >= 2) {
+            entries.append(view.syllables, view.syllableCount, view.word, view.wordBytes & ~1, &remap);
+        }
+    }
+    if (reader.hasError()) {
+        m_error = reader.errorString();
+        return false;
+    }
+
+    // 按音节序列排序（前缀在前），序列相同的保持词库中的顺序，重复词条只留一条
+    const std::vector<quint32> order = entries.sortedOrder(true);
+
+    // 层序展开：nodes 既是结果也是队列。区间内音节数恰为 depth 的词条排在最前，挂在本节点上；
+    // 其余按第 depth 个音节分成若干段，每段一个子节点
+    std::vector<Node> nodes;
+    std::vector<quint32> childStart;
+    std::vector<quint32> wordStart;
+    std::vector<quint32> wordOrder;
+    wordOrder.reserve(entries.size());
+    nodes.push_back(Node{0, static_cast<quint32>(order.size()), 0, 0});
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const Node node = nodes[i];
+        childStart.push_back(static_cast<quint32>(nodes.size()));
+        wordStart.push_back(static_cast<quint32>(wordOrder.size()));
+        quint32 p = node.begin;
+        while (p < node.end && entries.syllableCount(order[p]) == node.depth) {
+            wordOrder.push_back(order[p++]);
+        }
+        while (p < node.end) {
+            const quint16 label = entries.syllableAt(order[p], node.depth);
+            quint32 q = p + 1;
+            while (q < node.end && entries.syllableAt(order[q], node.depth) == label) {
+                ++q;
+            }
+            nodes.push_back(Node{p, q, static_cast<quint16>(node.depth + 1), label});
+            p = q;
+        }
+    }
+    childStart.push_back(static_cast<quint32>(nodes.size()));
+    wordStart.push_back(static_cast<quint32>(wordOrder.size()));
+
+    // 词区：每 SCDTrie::BucketSize 个词一块，块内相邻的词做前缀压缩（按 UTF-16 码元，存储区已是小端）
+    QByteArray pool;
+    std::vector<quint32> bucketOffsets;
+    quint32 maxWordLength = 0;
+    quint32 previous = 0;
+    for (size_t i = 0; i < wordOrder.size(); ++i) {
+        const quint32 entry = wordOrder[i];
+        const char *word = reinterpret_cast<const char *>(entries.word(entry));
+        const int length = entries.wordBytes(entry) / 2;
+        maxWordLength = qMax<quint32>(maxWordLength, length);
+        if (i % SCDTrie::BucketSize == 0) {
+            bucketOffsets.push_back(static_cast<quint32>(pool.size()));
+            appendVarint(pool, length);
+            pool.append(word, length * 2);
+        } else {
+            const char *last = reinterpret_cast<const char *>(entries.word(previous));
+            const int limit = qMin(length, entries.wordBytes(previous) / 2);
+            int shared = 0;
+            while (shared < limit && std::memcmp(last + shared * 2, word + shared * 2, 2) == 0) {
+                ++shared;
+            }
+            appendVarint(pool, shared);
+            appendVarint(pool, length - shared);
+            pool.append(word + shared * 2, (length - shared) * 2);
+        }
+        previous = entry;
+    }
+    bucketOffsets.push_back(static_cast<quint32>(pool.size()));
+
+    // 拼装文件，各段按 4 字节对齐
+    QByteArray out("SCDTRIE1");
+    QByteArray syllablePool;
+    std::vector<quint32> syllableOffsets;
+    for (int index : byText) {
+        syllableOffsets.push_back(static_cast<quint32>(syllablePool.size()));
+        syllablePool.append(syllableText[index]);
+    }
+    syllableOffsets.push_back(static_cast<quint32>(syllablePool.size()));
+
+    appendU32(out, static_cast<quint32>(byText.size()));
+    appendU32(out, static_cast<quint32>(syllablePool.size()));
+    appendU32(out, static_cast<quint32>(nodes.size()));
+    appendU32(out, static_cast<quint32>(wordOrder.size()));
+    appendU32(out, static_cast<quint32>(bucketOffsets.size() - 1));
+    appendU32(out, static_cast<quint32>(pool.size()));
+    appendU32(out, maxWordLength);
+    appendU32(out, 0);
+    for (quint32 offset : syllableOffsets) {
+        appendU32(out, offset);
+    }
+    out.append(syllablePool);
+    alignTo4(out);
+    for (const Node &node : nodes) {
+        const quint16 le = qToLittleEndian(node.label);
+        out.append(reinterpret_cast<const char *>(&le), 2);
+    }
+    alignTo4(out);
+    for (quint32 value : childStart) {
+        appendU32(out, value);
+    }
+    for (quint32 value : wordStart) {
+        appendU32(out, value);
+    }
+    for (quint32 value : bucketOffsets) {
+        appendU32(out, value);
+    }
+    out.append(pool);
+    alignTo4(out);
+
+    QSaveFile file(triePath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(out) != out.size() || !file.commit()) {
+        m_error = "无法写入文件: " + triePath;
+        return false;
+    }
+
+    m_nodes = static_cast<quint32>(nodes.size());
+    m_words = static_cast<quint32>(wordOrder.size());
+    m_size = out.size();
+    return true;
+}
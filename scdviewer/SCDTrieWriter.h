@@ -0,0 +1,36 @@
+#ifndef SCDTRIEWRITER_H
+#define SCDTRIEWRITER_H
+
+#include <QString>
+#include <QtGlobal>
+
+/**
+ * 把细胞词库导出为静态拼音 trie（.sdt），供输入法引擎映射后直接查询，格式和加载器见 SCDTrie.h
+ *
+ * 用 SCDEntryReader 顺序读一遍词库，音节下标换成按文本排序后的编号存入 SCDDictionary，
+ * 全部词条按（音节序列, 词库中的顺序）排序、去重后，同一深度上相同前缀的词条连续，按层展开即得到层序的节点和各节点的词；
+ * 词依次做分块前缀压缩。整个过程只排序一次，时间与词条数近似线性。
+ */
+class SCDTrieWriter
+{
+public:
+    // 读取 scelPath，写出 triePath；失败时不留下写了一半的文件
+    bool write(const QString &scelPath, const QString &triePath);
+
+    quint32 nodeCount() const { return m_nodes; }
+    quint32 wordCount() const { return m_words; }
+    qint64 fileSize() const { return m_size; }
+
+    QString errorString() const { return m_error; }
+
+    // 默认输出路径：词库同目录、扩展名换成 .sdt
+    static QString defaultPath(const QString &scelPath);
+
+private:
+    quint32 m_nodes = 0;
+    quint32 m_words = 0;
+    qint64 m_size = 0;
+    QString m_error;
+};
+
+#endif // SCDTRIEWRITER_H
@@ -0,0 +1,392 @@
+#include "SCDUpdater.h"
+#include "SCDChecksum.h"
+#include "SCDEntryReader.h"
+#include "SCDHeader.h"
+#include "SCDText.h"
+#include "SCDWriter.h"
+#include <QFile>
+#include <QHash>
+#include <QSaveFile>
+#include <QSet>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// 要添加到同一拼音组的新词
+struct AddGroup {
+    QByteArray syllables;          // 音节下标，uint16 小端
+    std::vector<QByteArray> words; // UTF-16LE
+};
+
+// 按音节下标逐个比较（与 SCDWriter 的排序一致）
+int compareSyllables(const uchar *a, int aBytes, const uchar *b, int bBytes)
+{
+    const int n = qMin(aBytes, bBytes) / 2;
+    for (int i = 0; i < n; ++i) {
+        const quint16 x = qFromLittleEndian<quint16>(a + i * 2);
+        const quint16 y = qFromLittleEndian<quint16>(b + i * 2);
+        if (x != y) {
+            return x < y ? -1 : 1;
+        }
+    }
+    return aBytes - bBytes;
+}
+
+int compareSyllables(const QByteArray &a, const uchar *b, int bBytes)
+{
+    return compareSyllables(reinterpret_cast<const uchar *>(a.constData()), a.size(), b, bBytes);
+}
+
+// 词条的查找键：uint16 音节字节数 + 音节下标 + UTF-16LE 词
+QByteArray entryKey(const char *syllables, int syllableBytes, const char *word, int wordBytes)
+{
+    QByteArray key(2 + syllableBytes + wordBytes, Qt::Uninitialized);
+    qToLittleEndian<quint16>(static_cast<quint16>(syllableBytes), key.data());
+    std::memcpy(key.data() + 2, syllables, syllableBytes);
+    std::memcpy(key.data() + 2 + syllableBytes, word, wordBytes);
+    return key;
+}
+
+// 文件头中的四个计数
+struct Counts {
+    quint64 groups = 0;
+    quint64 phrases = 0;
+    quint64 groupBytes = 0;
+    quint64 phraseBytes = 0;
+};
+
+} // namespace
+
+bool SCDUpdater::parseEntry(const char *code, int codeLength, const char *word, int wordLength, DeltaEntry *entry)
+{
+    // 拼音以 ' 分隔，开头的 ' 可有可无
+    entry->syllables.clear();
+    int pos = 0;
+    while (pos < codeLength) {
+        if (code[pos] == '\'') {
+            ++pos;
+            continue;
+        }
+        int end = pos;
+        while (end < codeLength && code[end] != '\'') {
+            ++end;
+        }
+        entry->syllables.append(QByteArray(code + pos, end - pos));
+        pos = end;
+    }
+
+    std::vector<char16_t> units;
+    if (entry->syllables.isEmpty() || entry->syllables.size() > 0x7FFF
+        || !SCDText::appendUtf16(units, reinterpret_cast<const uchar *>(word), wordLength)
+        || units.empty() || units.size() > 0x7FFF) {
+        return false;
+    }
+    entry->word.resize(static_cast<qsizetype>(units.size() * 2));
+    qToLittleEndian<quint16>(units.data(), static_cast<qsizetype>(units.size()), entry->word.data());
+    return true;
+}
+
+bool SCDUpdater::addEntry(const char *code, int codeLength, const char *word, int wordLength)
+{
+    DeltaEntry entry;
+    if (!parseEntry(code, codeLength, word, wordLength, &entry)) {
+        ++m_skipped;
+        return false;
+    }
+    m_adds.push_back(std::move(entry));
+    return true;
+}
+
+bool SCDUpdater::removeEntry(const char *code, int codeLength, const char *word, int wordLength)
+{
+    DeltaEntry entry;
+    if (!parseEntry(code, codeLength, word, wordLength, &entry)) {
+        ++m_skipped;
+        return false;
+    }
+    m_removes.push_back(std::move(entry));
+    return true;
+}
+
+qint64 SCDUpdater::addTextFile(const QString &txtPath)
+{
+    const qint64 before = static_cast<qint64>(m_adds.size());
+    const bool ok = SCDEntryText::readTextFile(txtPath,
+        [this](const char *code, int codeLength, const char *word, int wordLength) {
+            addEntry(code, codeLength, word, wordLength);
+        }, &m_error);
+    return ok ? static_cast<qint64>(m_adds.size()) - before : -1;
+}
+
+qint64 SCDUpdater::removeTextFile(const QString &txtPath)
+{
+    const qint64 before = static_cast<qint64>(m_removes.size());
+    const bool ok = SCDEntryText::readTextFile(txtPath,
+        [this](const char *code, int codeLength, const char *word, int wordLength) {
+            removeEntry(code, codeLength, word, wordLength);
+        }, &m_error);
+    return ok ? static_cast<qint64>(m_removes.size()) - before : -1;
+}
+
+bool SCDUpdater::apply(const QString &scelPath, const QString &outputPath)
+{
+    m_added = m_removed = 0;
+
+    QFile source(scelPath);
+    if (!source.open(QIODevice::ReadOnly)) {
+        m_error = "无法打开文件: " + scelPath;
+        return false;
+    }
+    const qint64 size = source.size();
+    const uchar *data = source.map(0, size);
+    QByteArray content;
+    if (!data) {
+        content = source.readAll();
+        data = reinterpret_cast<const uchar *>(content.constData());
+    }
+
+    SCDHeader header;
+    if (size < SCDHeader::HeaderSize
+        || !header.loadFromData(QByteArray(reinterpret_cast<const char *>(data), SCDHeader::HeaderSize))) {
+        m_error = "非法的细胞词库文件头！";
+        return false;
+    }
+
+    // 增删的词条按本词库自己的拼音表换成音节下标
+    SCDPinyinTable pinyin;
+    qint64 tableSize = 0;
+    if (!pinyin.parse(data + SCDHeader::HeaderSize, size - SCDHeader::HeaderSize, &tableSize)) {
+        m_error = "拼音表格式错误";
+        return false;
+    }
+    const QHash<QByteArray, quint16> syllableIndex = pinyin.syllableIndex();
+    auto resolve = [&](const DeltaEntry &entry, QByteArray *syllables) {
+        syllables->resize(entry.syllables.size() * 2);
+        for (int i = 0; i < entry.syllables.size(); ++i) {
+            auto it = syllableIndex.constFind(entry.syllables.at(i));
+            if (it == syllableIndex.constEnd()) {
+                return false;
+            }
+            qToLittleEndian<quint16>(it.value(), syllables->data() + i * 2);
+        }
+        return true;
+    };
+
+    QSet<QByteArray> removeKeys;
+    QSet<QByteArray> removeGroups;
+    for (const DeltaEntry &entry : m_removes) {
+        QByteArray syllables;
+        if (!resolve(entry, &syllables)) {
+            ++m_skipped;
+            continue;
+        }
+        removeKeys.insert(entryKey(syllables.constData(), syllables.size(), entry.word.constData(), entry.word.size()));
+        removeGroups.insert(syllables);
+    }
+
+    std::vector<AddGroup> adds;
+    QHash<QByteArray, size_t> addGroupIndex;
+    QSet<QByteArray> addKeys;
+    for (const DeltaEntry &entry : m_adds) {
+        QByteArray syllables;
+        if (!resolve(entry, &syllables)) {
+            ++m_skipped;
+            continue;
+        }
+        // 增量文件内的重复词条只取第一条
+        const QByteArray key = entryKey(syllables.constData(), syllables.size(), entry.word.constData(), entry.word.size());
+        if (addKeys.contains(key)) {
+            continue;
+        }
+        addKeys.insert(key);
+        const size_t index = addGroupIndex.value(syllables, adds.size());
+        if (index == adds.size()) {
+            addGroupIndex.insert(syllables, index);
+            adds.push_back({syllables, {}});
+        }
+        adds[index].words.push_back(entry.word);
+    }
+    std::sort(adds.begin(), adds.end(), [](const AddGroup &a, const AddGroup &b) {
+        return compareSyllables(a.syllables, reinterpret_cast<const uchar *>(b.syllables.constData()),
+                                b.syllables.size()) < 0;
+    });
+
+    QSaveFile out(outputPath);
+    if (!out.open(QIODevice::WriteOnly)) {
+        m_error = "无法写入文件: " + outputPath;
+        return false;
+    }
+    // 文件头最后回填计数和校验和
+    if (out.write(header.data()) != SCDHeader::HeaderSize) {
+        m_error = "写入文件失败: " + outputPath;
+        return false;
+    }
+
+    SCDChecksumWriter output(&out);
+    Counts counts;
+    output.appendRaw(reinterpret_cast<const char *>(data) + SCDHeader::HeaderSize, tableSize);
+
+    // 写出一个重新编码的拼音组：保留的原词条（原样复制）+ 新词；词数超过上限时拆成多个组
+    using Span = std::pair<const uchar *, qint64>;
+    auto emitGroup = [&](const uchar *syllables, int syllableBytes,
+                         const std::vector<Span> &kept, const std::vector<QByteArray> &added) {
+        const size_t total = kept.size() + added.size();
+        for (size_t begin = 0; begin < total; begin += SCDWriter::MaxWordsPerGroup) {
+            const size_t end = qMin(total, begin + SCDWriter::MaxWordsPerGroup);
+            output.appendU16(static_cast<quint16>(end - begin));
+            output.appendU16(static_cast<quint16>(syllableBytes));
+            output.append(reinterpret_cast<const char *>(syllables), syllableBytes);
+            ++counts.groups;
+            counts.groupBytes += 2 + syllableBytes;
+            for (size_t i = begin; i < end; ++i) {
+                if (i < kept.size()) {
+                    output.append(reinterpret_cast<const char *>(kept[i].first), kept[i].second);
+                    counts.phraseBytes += 2 + qFromLittleEndian<quint16>(kept[i].first);
+                } else {
+                    const QByteArray &word = added[i - kept.size()];
+                    output.appendU16(static_cast<quint16>(word.size()));
+                    output.append(word.constData(), word.size());
+                    output.append(SCDWriter::EntryExt, SCDWriter::EntryExtSize);
+                    counts.phraseBytes += 2 + word.size();
+                }
+                ++counts.phrases;
+            }
+        }
+    };
+    auto emitNewGroup = [&](const AddGroup &group) {
+        emitGroup(reinterpret_cast<const uchar *>(group.syllables.constData()), group.syllables.size(), {}, group.words);
+        m_added += static_cast<qint64>(group.words.size());
+    };
+
+    // 顺序遍历原词库的拼音组；未改动的组累积成一段，遇到需要重新编码的组时再整段复制
+    const quint32 groupTotal = header.number(SCDField::GroupCount);
+    qint64 pos = SCDHeader::HeaderSize + tableSize;
+    qint64 rawStart = pos;
+    size_t nextAdd = 0;
+    auto corrupt = [&]() {
+        m_error = QString("拼音组格式错误，偏移 0x%1").arg(QString::number(pos, 16));
+        return false;
+    };
+
+    for (quint32 g = 0; groupTotal > 0 ? g < groupTotal : pos < size; ++g) {
+        if (pos + 4 > size) {
+            return corrupt();
+        }
+        const int wordCount = qFromLittleEndian<quint16>(data + pos);
+        const int syllableBytes = qFromLittleEndian<quint16>(data + pos + 2);
+        if (wordCount == 0 || syllableBytes == 0 || syllableBytes % 2 != 0 || pos + 4 + syllableBytes > size) {
+            return corrupt();
+        }
+        const uchar *syllables = data + pos + 4;
+
+        // 词条：uint16 词字节数, 词, uint16 扩展字节数, 扩展信息
+        std::vector<Span> words;
+        words.reserve(wordCount);
+        qint64 p = pos + 4 + syllableBytes;
+        quint64 phraseBytes = 0;
+        for (int i = 0; i < wordCount; ++i) {
+            if (p + 2 > size) {
+                return corrupt();
+            }
+            const int wordBytes = qFromLittleEndian<quint16>(data + p);
+            if (p + 2 + wordBytes + 2 > size) {
+                return corrupt();
+            }
+            const int extBytes = qFromLittleEndian<quint16>(data + p + 2 + wordBytes);
+            const qint64 recordSize = 2 + wordBytes + 2 + extBytes;
+            if (p + recordSize > size) {
+                return corrupt();
+            }
+            words.emplace_back(data + p, recordSize);
+            phraseBytes += 2 + wordBytes;
+            p += recordSize;
+        }
+        const qint64 groupEnd = p;
+
+        // 排在本组之前的新拼音组
+        while (nextAdd < adds.size() && compareSyllables(adds[nextAdd].syllables, syllables, syllableBytes) < 0) {
+            output.appendRaw(reinterpret_cast<const char *>(data) + rawStart, pos - rawStart);
+            rawStart = pos;
+            emitNewGroup(adds[nextAdd++]);
+        }
+
+        const bool merge = nextAdd < adds.size() && compareSyllables(adds[nextAdd].syllables, syllables, syllableBytes) == 0;
+        const QByteArray syllableKey = QByteArray::fromRawData(reinterpret_cast<const char *>(syllables), syllableBytes);
+        if (!merge && !removeGroups.contains(syllableKey)) {
+            ++counts.groups;
+            counts.phrases += wordCount;
+            counts.groupBytes += 2 + syllableBytes;
+            counts.phraseBytes += phraseBytes;
+            pos = groupEnd;
+            continue;
+        }
+
+        output.appendRaw(reinterpret_cast<const char *>(data) + rawStart, pos - rawStart);
+
+        // 去掉要删除的词，再追加组内还没有的新词
+        std::vector<Span> kept;
+        QSet<QByteArray> keptWords;
+        for (const Span &word : words) {
+            const int wordBytes = qFromLittleEndian<quint16>(word.first);
+            const char *text = reinterpret_cast<const char *>(word.first + 2);
+            if (removeKeys.contains(entryKey(syllableKey.constData(), syllableBytes, text, wordBytes))) {
+                ++m_removed;
+                continue;
+            }
+            kept.push_back(word);
+            keptWords.insert(QByteArray::fromRawData(text, wordBytes));
+        }
+        std::vector<QByteArray> added;
+        if (merge) {
+            for (const QByteArray &word : adds[nextAdd].words) {
+                if (!keptWords.contains(word)) {
+                    added.push_back(word);
+                }
+            }
+            ++nextAdd;
+        }
+        m_added += static_cast<qint64>(added.size());
+        emitGroup(syllables, syllableBytes, kept, added);
+
+        pos = groupEnd;
+        rawStart = pos;
+    }
+
+    // 剩余的新拼音组放在最后，之后是原样保留的附加数据
+    output.appendRaw(reinterpret_cast<const char *>(data) + rawStart, pos - rawStart);
+    while (nextAdd < adds.size()) {
+        emitNewGroup(adds[nextAdd++]);
+    }
+    output.appendRaw(reinterpret_cast<const char *>(data) + pos, size - pos);
+
+    if (!output.flush()) {
+        m_error = "写入文件失败: " + outputPath;
+        return false;
+    }
+    if (counts.groups > 0xFFFFFFFFu || counts.phrases > 0xFFFFFFFFu
+        || counts.groupBytes > 0xFFFFFFFFu || counts.phraseBytes > 0xFFFFFFFFu) {
+        m_error = "词条过多，超出细胞词库格式的上限";
+        return false;
+    }
+
+    // 回填计数和校验和（原样复制时只计数，不重新编码）
+    header.setNumber(SCDField::GroupCount, static_cast<quint32>(counts.groups));
+    header.setNumber(SCDField::PhraseCount, static_cast<quint32>(counts.phrases));
+    header.setNumber(SCDField::GroupSize, static_cast<quint32>(counts.groupBytes));
+    header.setNumber(SCDField::PhraseSize, static_cast<quint32>(counts.phraseBytes));
+    QByteArray headerData = header.data();
+    headerData.replace(SCDChecksum::Offset, SCDChecksum::Size, SCDChecksum::toBytes(output.result()));
+
+    // 原地更新时先释放原文件，再用新文件替换
+    source.close();
+    if (!out.seek(0) || out.write(headerData) != SCDHeader::HeaderSize || !out.commit()) {
+        m_error = "写入文件失败: " + outputPath;
+        return false;
+    }
+
+    m_groupCount = static_cast<quint32>(counts.groups);
+    m_phraseCount = static_cast<quint32>(counts.phrases);
+    return true;
+}
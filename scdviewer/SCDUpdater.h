@@ -0,0 +1,63 @@
+#ifndef SCDUPDATER_H
+#define SCDUPDATER_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+#include <QtGlobal>
+#include <vector>
+
+/**
+ * 细胞词库增量更新
+ *
+ * 在已有词库上增删少量词条，不重新生成整个词库：
+ * 不涉及增删的拼音组按原样成段复制，只有被增删的拼音组重新编码；
+ * 新的拼音组按音节序列插到第一个比它大的组之前（原词库有序时即为正确位置）。
+ * 文件头的四个计数在写出时累加，校验和边写边算，整个过程只顺序读写一遍文件。
+ * 拼音组之后的附加数据原样保留。
+ */
+class SCDUpdater
+{
+public:
+    // 读取要添加 / 删除的词条（搜狗文本词库格式），返回读入的词条数，失败返回 -1
+    qint64 addTextFile(const QString &txtPath);
+    qint64 removeTextFile(const QString &txtPath);
+
+    // 单条增删：code 为 'a'b 形式的拼音，word 为 UTF-8 词，格式非法时返回 false
+    bool addEntry(const char *code, int codeLength, const char *word, int wordLength);
+    bool removeEntry(const char *code, int codeLength, const char *word, int wordLength);
+
+    // 把增删应用到 scelPath，写出到 outputPath（可以与 scelPath 相同，写完后原子替换）
+    bool apply(const QString &scelPath, const QString &outputPath);
+
+    // apply 之后的统计
+    qint64 addedCount() const { return m_added; }
+    qint64 removedCount() const { return m_removed; }
+    quint32 groupCount() const { return m_groupCount; }
+    quint32 phraseCount() const { return m_phraseCount; }
+
+    // 格式非法或拼音不在词库拼音表中而跳过的词条数
+    qint64 skippedCount() const { return m_skipped; }
+
+    QString errorString() const { return m_error; }
+
+private:
+    struct DeltaEntry {
+        QList<QByteArray> syllables; // UTF-8 音节
+        QByteArray word;             // UTF-16LE
+    };
+
+    static bool parseEntry(const char *code, int codeLength, const char *word, int wordLength, DeltaEntry *entry);
+
+    std::vector<DeltaEntry> m_adds;
+    std::vector<DeltaEntry> m_removes;
+
+    qint64 m_added = 0;
+    qint64 m_removed = 0;
+    qint64 m_skipped = 0;
+    quint32 m_groupCount = 0;
+    quint32 m_phraseCount = 0;
+    QString m_error;
+};
+
+#endif // SCDUPDATER_H
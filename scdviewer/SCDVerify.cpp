@@ -0,0 +1,101 @@
+#include "SCDVerify.h"
+#include "SCDChecksum.h"
+#include "SCDEntryReader.h"
+#include "SCDHeader.h"
+#include <QFile>
+
+// 内部函数：十六进制形式的校验和，用于报告
+static QString digestHex(const SCDChecksum::Digest &digest)
+{
+    return QString::fromLatin1(SCDChecksum::toBytes(digest).toHex());
+}
+
+// 内部函数：计算 0x1540 之后的校验和，优先整体映射文件
+static bool computeChecksum(QFile &file, SCDChecksum::Digest *digest)
+{
+    const qint64 size = file.size();
+    if (uchar *map = file.map(0, size)) {
+        SCDChecksum checksum;
+        checksum.addData(reinterpret_cast<const char *>(map) + SCDHeader::HeaderSize,
+                         size - SCDHeader::HeaderSize);
+        *digest = checksum.result();
+        file.unmap(map);
+        return true;
+    }
+
+    bool ok = false;
+    if (!file.seek(SCDHeader::HeaderSize)) {
+        return false;
+    }
+    *digest = SCDChecksum::compute(&file, &ok);
+    return ok;
+}
+
+// 内部函数：比较一项计数，不一致时写入说明
+static bool checkCount(SCDVerifyResult &result, const char *name, quint32 recorded, quint64 actual)
+{
+    if (recorded == actual) {
+        return true;
+    }
+    result.error = QString("%1不一致：文件头记录 %2，实际 %3").arg(name).arg(recorded).arg(actual);
+    return false;
+}
+
+SCDVerifyResult SCDVerify::verifyFile(const QString &filePath)
+{
+    SCDVerifyResult result;
+
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        result.error = "无法打开文件";
+        return result;
+    }
+
+    SCDHeader header;
+    if (file.size() < SCDHeader::HeaderSize || !header.loadFromData(file.read(SCDHeader::HeaderSize))) {
+        result.error = "非法的细胞词库文件头";
+        return result;
+    }
+    result.headerValid = true;
+
+    // 校验和
+    SCDChecksum::Digest actual;
+    if (!computeChecksum(file, &actual)) {
+        result.error = "读取文件失败";
+        return result;
+    }
+    const SCDChecksum::Digest recorded =
+        SCDChecksum::fromBytes(reinterpret_cast<const uchar *>(header.data().constData()) + SCDChecksum::Offset);
+    result.checksumMatched = (actual == recorded);
+    file.close();
+
+    // 遍历词条区，重新统计数量和字节数
+    SCDEntryReader reader;
+    quint64 groups = 0, phrases = 0, groupBytes = 0, phraseBytes = 0;
+    if (reader.open(filePath)) {
+        SCDEntryView entry;
+        while (reader.next(entry)) {
+            if (entry.firstInGroup) {
+                ++groups;
+                groupBytes += 2 + entry.syllableCount * 2;
+            }
+            ++phrases;
+            phraseBytes += 2 + entry.wordBytes;
+        }
+    }
+
+    if (reader.hasError()) {
+        result.error = reader.errorString();
+    } else {
+        result.countsMatched = checkCount(result, "拼音组数", header.number(SCDField::GroupCount), groups)
+                               && checkCount(result, "词条数", header.number(SCDField::PhraseCount), phrases)
+                               && checkCount(result, "拼音组字节数", header.number(SCDField::GroupSize), groupBytes)
+                               && checkCount(result, "词条字节数", header.number(SCDField::PhraseSize), phraseBytes);
+    }
+
+    // 校验和错误优先报告
+    if (!result.checksumMatched) {
+        result.error = QString("校验和不一致：文件头记录 %1，实际 %2").arg(digestHex(recorded), digestHex(actual));
+    }
+    return result;
+}
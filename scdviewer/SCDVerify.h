@@ -0,0 +1,27 @@
+#ifndef SCDVERIFY_H
+#define SCDVERIFY_H
+
+#include <QString>
+#include <QtGlobal>
+
+// 单个词库的完整性检查结果
+struct SCDVerifyResult {
+    bool headerValid = false;    // 文件头标识
+    bool checksumMatched = false; // 0x00C 处的校验和
+    bool countsMatched = false;  // 0x120-0x12C 处的拼音组数 / 词条数 / 拼音组字节数 / 词条字节数
+    QString error;               // 第一处不一致的说明
+
+    bool isOk() const { return headerValid && checksumMatched && countsMatched; }
+};
+
+// 细胞词库完整性检查
+namespace SCDVerify {
+    /**
+     * 重新计算 0x1540 之后数据的校验和并与文件头比较，
+     * 再遍历全部拼音组，核对文件头记录的数量和字节数。
+     * 只读文件，可在多个线程中同时调用。
+     */
+    SCDVerifyResult verifyFile(const QString &filePath);
+}
+
+#endif // SCDVERIFY_H
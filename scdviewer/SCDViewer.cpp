@@ -1,4 +1,6 @@
 #include "SCDInfoRead.h"
+#include "SCDCommands.h"
+#include "SCDEntryModel.h"
 #include <QApplication>
 #include <QWidget>
 #include <QLabel>
@@ -6,9 +8,17 @@
 #include <QPushButton>
 #include <QMessageBox>
 #include <QFileInfo>
+#include <QTableView>
+#include <QHeaderView>
 
 int main(int argc, char *argv[])
 {
+    // 以选项开头时进入命令行模式，不创建窗口
+    if (argc >= 2 && argv[1][0] == '-') {
+        QCoreApplication app(argc, argv);
+        return SCDCommands::run(app.arguments());
+    }
+
     QApplication app(argc, argv);
 
     if (argc < 2) {
@@ -26,7 +36,7 @@ int main(int argc, char *argv[])
 
     SCDInfo info = SCDInfoRead::readSCDInfo(filePath);
 
-    if (info.allInformation.startsWith("非法")) {
+    if (!info.isValid) {
         QMessageBox::critical(nullptr, "错误", info.allInformation);
         return 1;
     }
@@ -66,6 +76,25 @@ int main(int argc, char *argv[])
     // 将带边距的文本区域加入主布局
     layout->addWidget(textContainer);
 
+    // === 词条表格 ===
+    // 行高固定、不按内容调整列宽，否则视图会为计算尺寸解码全部词条
+    SCDEntryModel *model = new SCDEntryModel(&window);
+    if (model->open(filePath)) {
+        QTableView *table = new QTableView(&window);
+        table->setModel(model);
+        table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+        table->setSelectionBehavior(QAbstractItemView::SelectRows);
+        table->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+        table->verticalHeader()->setDefaultSectionSize(table->fontMetrics().height() + 6);
+        table->horizontalHeader()->setSectionResizeMode(QHeaderView::Interactive);
+        table->horizontalHeader()->setStretchLastSection(true);
+        table->setColumnWidth(0, 260);
+        table->setMinimumSize(480, 360);
+        layout->addWidget(table, 1);
+    } else {
+        label->setText(info.allInformation + "\n\n无法读取词条：" + model->errorString());
+    }
+
     // === 确认按钮 ===
     QPushButton *okButton = new QPushButton("确认");
     okButton->setFixedWidth(80);
@@ -6,6 +6,46 @@ TARGET = scdviewer
 TEMPLATE = app
 
 SOURCES += SCDViewer.cpp \
-           SCDInfoRead.cpp
+           SCDInfoRead.cpp \
+           SCDHeader.cpp \
+           SCDEntryReader.cpp \
+           SCDCommands.cpp \
+           SCDBatch.cpp \
+           SCDInfoCache.cpp \
+           SCDChecksum.cpp \
+           SCDWriter.cpp \
+           SCDDictionary.cpp \
+           SCDText.cpp \
+           SCDVerify.cpp \
+           SCDUpdater.cpp \
+           SCDMerger.cpp \
+           SCDDiff.cpp \
+           SCDSearchIndex.cpp \
+           SCDEntryModel.cpp \
+           SCDStats.cpp \
+           SCDProgress.cpp \
+           SCDTrieWriter.cpp
 
-HEADERS += SCDInfoRead.h
+HEADERS += SCDInfoRead.h \
+           SCDHeader.h \
+           SCDEntryReader.h \
+           SCDCommands.h \
+           SCDBatch.h \
+           SCDInfoCache.h \
+           SCDChecksum.h \
+           SCDWriter.h \
+           SCDDictionary.h \
+           SCDText.h \
+           SCDVerify.h \
+           SCDUpdater.h \
+           SCDMerger.h \
+           SCDDiff.h \
+           SCDSearchIndex.h \
+           SCDEntryModel.h \
+           SCDStats.h \
+           SCDProgress.h \
+           SCDTrie.h \
+           SCDTrieWriter.h
+
+# 内置拼音表（与 scel-maker 共用 pinyin.bin）
+RESOURCES += SCDResources.qrc
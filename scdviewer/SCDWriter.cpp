@@ -0,0 +1,408 @@
+#include "SCDWriter.h"
+#include "SCDChecksum.h"
+#include "SCDEntryReader.h"
+#include "SCDHeader.h"
+#include "SCDText.h"
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QRandomGenerator>
+#include <QStringDecoder>
+#include <QtEndian>
+#include <cstring>
+
+// 每个词条的扩展信息：uint16 长度 10，词频 45，其余为 0（与 scel-maker 一致）
+const char SCDWriter::EntryExt[SCDWriter::EntryExtSize] = {'\x0A', '\x00', '\x2D', '\x00', '\x00', '\x00',
+                                                          '\x00', '\x00', '\x00', '\x00', '\x00', '\x00'};
+
+// 内部函数：追加 uint16 小端
+static inline void appendU16(QByteArray &out, quint16 value)
+{
+    char bytes[2];
+    qToLittleEndian<quint16>(value, bytes);
+    out.append(bytes, 2);
+}
+
+SCDWriter::SCDWriter()
+{
+    m_category = "本地";
+    m_remark = "由 scdtool 生成的细胞词库";
+    loadPinyinTable();
+}
+
+bool SCDWriter::loadPinyinTable()
+{
+    m_pinyinTable = SCDPinyinTable::builtinData();
+    SCDPinyinTable table;
+    qint64 consumed = 0;
+    if (m_pinyinTable.isEmpty()
+        || !table.parse(reinterpret_cast<const uchar *>(m_pinyinTable.constData()), m_pinyinTable.size(), &consumed)) {
+        m_error = "无法读取内置拼音表";
+        m_pinyinTable.clear();
+        return false;
+    }
+    m_syllableIndex = table.syllableIndex();
+    return true;
+}
+
+SCDHeader SCDWriter::createHeader(bool official, const QString &name, const QString &category,
+                                  const QString &remark, const QStringList &examples)
+{
+    SCDHeader header = SCDHeader::create(official);
+    header.setString(SCDField::Id, QString("L%1").arg(QRandomGenerator::global()->bounded(65536)));
+    header.setNumber(SCDField::Timestamp, static_cast<quint32>(QDateTime::currentSecsSinceEpoch()));
+    header.setString(SCDField::Name, name);
+    header.setString(SCDField::Category, category);
+    header.setString(SCDField::Remark, remark);
+    header.setString(SCDField::Example, examples.join("   "));
+    return header;
+}
+
+bool SCDWriter::addEntry(const char *code, int codeLength, const char *word, int wordLength)
+{
+    m_code.clear();
+    m_word.clear();
+
+    // 拼音以 ' 分隔，开头的 ' 可有可无
+    int pos = 0;
+    while (pos < codeLength) {
+        if (code[pos] == '\'') {
+            ++pos;
+            continue;
+        }
+        int end = pos;
+        while (end < codeLength && code[end] != '\'') {
+            ++end;
+        }
+        auto it = m_syllableIndex.constFind(QByteArray::fromRawData(code + pos, end - pos));
+        if (it == m_syllableIndex.constEnd()) {
+            return false;
+        }
+        m_code.push_back(it.value());
+        pos = end;
+    }
+
+    if (m_code.empty() || !SCDText::appendUtf16(m_word, reinterpret_cast<const uchar *>(word), wordLength)
+        || m_word.empty()
+        || m_entries.append(m_code.data(), static_cast<int>(m_code.size()), m_word.data(),
+                            static_cast<int>(m_word.size())) == SCDDictionary::NotFound) {
+        return false;
+    }
+
+    if (m_examples.size() < 6) {
+        m_examples.append(QString::fromUtf8(word, wordLength));
+    }
+    return true;
+}
+
+qint64 SCDWriter::addTextFile(const QString &txtPath)
+{
+    if (m_name.isEmpty()) {
+        m_name = QFileInfo(txtPath).completeBaseName();
+    }
+
+    // 按每行约 24 字节（两三个音节的拼音加两三个字）预留
+    const qint64 before = m_entries.size();
+    const qint64 expected = QFileInfo(txtPath).size() / 24;
+    m_entries.reserve(before + expected, static_cast<size_t>(before + expected) * 3,
+                      static_cast<size_t>(before + expected) * 6);
+    const bool ok = SCDEntryText::readTextFile(txtPath,
+        [this](const char *code, int codeLength, const char *word, int wordLength) {
+            if (!addEntry(code, codeLength, word, wordLength)) {
+                ++m_skipped;
+            }
+        }, &m_error, &m_stats, m_progress);
+    if (!ok) {
+        return -1;
+    }
+    m_stats.setCounter("skipped", m_skipped);
+    return static_cast<qint64>(m_entries.size()) - before;
+}
+
+bool SCDWriter::write(const QString &scelPath)
+{
+    if (m_pinyinTable.isEmpty()) {
+        return false;
+    }
+    if (m_entries.isEmpty()) {
+        m_error = "没有可写入的词条";
+        return false;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    std::vector<quint32> order;
+    qint64 duplicates = 0;
+    if (m_progress) {
+        m_progress->setTotal(0);
+        m_progress->setPhase("sort");
+    }
+    {
+        SCDStats::Scope scope(&m_stats, "sort");
+        order = m_entries.sortedOrder(true, &duplicates);
+    }
+    const qint64 writeStart = timer.nsecsElapsed();
+
+    // 先统计文件头中的四个计数
+    quint32 groupCount = 0;
+    quint32 groupSize = 0;
+    quint32 phraseSize = 0;
+    for (size_t i = 0; i < order.size();) {
+        const size_t j = m_entries.groupEnd(order, i, MaxWordsPerGroup);
+        for (size_t k = i; k < j; ++k) {
+            phraseSize += 2 + m_entries.wordBytes(order[k]);
+        }
+        ++groupCount;
+        groupSize += 2 + m_entries.syllableCount(order[i]) * 2;
+        i = j;
+    }
+    const quint32 phraseCount = static_cast<quint32>(order.size());
+
+    SCDHeader header = createHeader(m_official, m_name, m_category, m_remark, m_examples);
+    header.setNumber(SCDField::GroupCount, groupCount);
+    header.setNumber(SCDField::PhraseCount, phraseCount);
+    header.setNumber(SCDField::GroupSize, groupSize);
+    header.setNumber(SCDField::PhraseSize, phraseSize);
+
+    QFile out(scelPath);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        m_error = "无法写入文件: " + scelPath;
+        return false;
+    }
+
+    // 文件头最后回填校验和；其后的数据在写出的同时计算校验和
+    if (out.write(header.data()) != SCDHeader::HeaderSize) {
+        m_error = "写入文件失败: " + scelPath;
+        return false;
+    }
+
+    SCDChecksumWriter output(&out);
+    output.append(m_pinyinTable.constData(), m_pinyinTable.size());
+    QByteArray &buffer = output.buffer();
+
+    if (m_progress) {
+        m_progress->setTotal(phraseCount);
+        m_progress->setPhase("write");
+    }
+    quint32 groupIndex = 0;
+    for (size_t i = 0; i < order.size();) {
+        const size_t j = m_entries.groupEnd(order, i, MaxWordsPerGroup);
+
+        // 拼音组：同音词数、音节下标字节数、音节下标（存储区中已是小端，直接复制）
+        const SCDEntryView first = m_entries.view(order[i]);
+        appendU16(buffer, static_cast<quint16>(j - i));
+        appendU16(buffer, static_cast<quint16>(first.syllableCount * 2));
+        buffer.append(reinterpret_cast<const char *>(first.syllables), first.syllableCount * 2);
+
+        // 组内每个词：词字节数、UTF-16LE 词、扩展信息
+        for (size_t k = i; k < j; ++k) {
+            const quint32 entry = order[k];
+            appendU16(buffer, static_cast<quint16>(m_entries.wordBytes(entry)));
+            buffer.append(reinterpret_cast<const char *>(m_entries.word(entry)), m_entries.wordBytes(entry));
+            buffer.append(EntryExt, EntryExtSize);
+        }
+
+        if (!output.flushIfFull()) {
+            m_error = "写入文件失败: " + scelPath;
+            return false;
+        }
+        i = j;
+
+        if (m_progress && (++groupIndex & 0xFFF) == 0) {
+            m_progress->setDone(static_cast<qint64>(i));
+            if (m_progress->isCanceled()) {
+                out.remove();
+                m_error = "已取消";
+                return false;
+            }
+        }
+    }
+    if (!output.flush()) {
+        m_error = "写入文件失败: " + scelPath;
+        return false;
+    }
+    if (m_progress) {
+        m_progress->setDone(phraseCount);
+    }
+
+    if (!out.seek(SCDChecksum::Offset)
+        || out.write(SCDChecksum::toBytes(output.result())) != SCDChecksum::Size || !out.flush()) {
+        m_error = "写入校验和失败: " + scelPath;
+        return false;
+    }
+
+    // 写出阶段不含校验和计算，两者分开记录
+    const qint64 checksumTime = output.checksumNanoseconds();
+    m_stats.addStage("write", timer.nsecsElapsed() - writeStart - checksumTime);
+    m_stats.addStage("checksum", checksumTime);
+    m_stats.setCounter("phrases", phraseCount);
+    m_stats.setCounter("duplicates", duplicates);
+    m_stats.setCounter("entryBytes", static_cast<qint64>(m_entries.memoryUsage()));
+    m_stats.setCounter("skipped", m_skipped);
+    m_stats.setCounter("groups", groupCount);
+    m_stats.setCounter("bytesOut", out.size());
+
+    m_groupCount = groupCount;
+    m_phraseCount = phraseCount;
+    return true;
+}
+
+qint64 SCDEntryText::importFile(const QString &txtPath, const QString &scelPath, QString *errorString)
+{
+    SCDWriter writer;
+    if (writer.addTextFile(txtPath) < 0 || !writer.write(scelPath)) {
+        if (errorString) *errorString = writer.errorString();
+        return -1;
+    }
+    return writer.phraseCount();
+}
+
+bool SCDEntryText::readTextFile(const QString &txtPath,
+                                const std::function<void(const char *, int, const char *, int)> &entry,
+                                QString *errorString, SCDStats *stats, SCDProgress *progress)
+{
+    QFile file(txtPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (errorString) *errorString = "无法打开文件: " + txtPath;
+        return false;
+    }
+
+    const auto canceled = [&]() {
+        if (!progress || !progress->isCanceled()) {
+            return false;
+        }
+        if (errorString) *errorString = "已取消";
+        return true;
+    };
+
+    // UTF-8 文件按块读入、逐块解析，只保留一块和上一块末尾不完整的一行，内存占用与文件大小无关；
+    // 不是 UTF-8 时才整体读入后按 GB18030 转换
+    constexpr qint64 ReadBlock = 8 << 20;
+    const qint64 fileSize = file.size();
+    QByteArray content;
+    const auto readBlock = [&](qint64 limit) {
+        SCDStats::Scope scope(stats, "read");
+        limit = qMin(limit, fileSize - file.pos());
+        if (limit <= 0) {
+            return false;
+        }
+        const qsizetype at = content.size();
+        content.resize(at + limit);
+        const qint64 n = file.read(content.data() + at, limit);
+        content.resize(at + qMax<qint64>(n, 0));
+        if (stats) stats->addCounter("bytesIn", qMax<qint64>(n, 0));
+        return n > 0;
+    };
+    readBlock(ReadBlock);
+
+    // 去掉 UTF-8 BOM；开头一段不像 UTF-8 时按 GB18030
+    bool utf8 = true;
+    {
+        SCDStats::Scope scope(stats, "detect");
+        const uchar *head = reinterpret_cast<const uchar *>(content.constData());
+        if (content.size() >= 3 && head[0] == 0xEF && head[1] == 0xBB && head[2] == 0xBF) {
+            content.remove(0, 3);
+        } else {
+            utf8 = SCDText::looksLikeUtf8(head, content.size());
+        }
+    }
+
+    if (!utf8) {
+        if (progress) {
+            progress->setTotal(fileSize);
+            progress->setPhase("read");
+        }
+        while (readBlock(ReadBlock)) {
+            if (progress) progress->setDone(content.size());
+            if (canceled()) {
+                return false;
+            }
+        }
+        SCDStats::Scope scope(stats, "decode");
+        QStringDecoder decoder("GB18030");
+        if (!decoder.isValid()) {
+            if (errorString) *errorString = "当前环境不支持 GB18030 编码";
+            return false;
+        }
+        content = QString(decoder(content)).toUtf8();
+    }
+
+    // 解析 [p, end) 中的完整行（final 为 true 时包括末尾没有换行的一行），返回未解析部分的起点
+    qint64 lines = 0;
+    qint64 parsed = 0; // 已解析的字节数，用于进度
+    bool aborted = false;
+    const auto parseLines = [&](const char *p, const char *end, bool final) {
+        SCDStats::Scope scope(stats, "parse");
+        while (p < end) {
+            // 每 4096 行更新一次进度，工作线程只做几次原子写
+            if (progress && (lines & 0xFFF) == 0) {
+                progress->setDone(parsed);
+                progress->setEntries(lines);
+                if (canceled()) {
+                    aborted = true;
+                    return end;
+                }
+            }
+
+            const char *lineEnd = static_cast<const char *>(std::memchr(p, '\n', end - p));
+            if (!lineEnd) {
+                if (!final) {
+                    break;
+                }
+                lineEnd = end;
+            }
+
+            // 每行：拼音 空白 词，其余内容忽略
+            const char *codeEnd = p;
+            while (codeEnd < lineEnd && *codeEnd != ' ' && *codeEnd != '\t') {
+                ++codeEnd;
+            }
+            const char *word = codeEnd;
+            while (word < lineEnd && (*word == ' ' || *word == '\t')) {
+                ++word;
+            }
+            const char *wordEnd = word;
+            while (wordEnd < lineEnd && *wordEnd != ' ' && *wordEnd != '\t' && *wordEnd != '\r') {
+                ++wordEnd;
+            }
+
+            if (codeEnd > p && wordEnd > word) {
+                entry(p, static_cast<int>(codeEnd - p), word, static_cast<int>(wordEnd - word));
+            }
+            parsed += qMin(lineEnd + 1, end) - p;
+            p = lineEnd + 1;
+            ++lines;
+        }
+        return p;
+    };
+
+    if (progress) {
+        progress->setTotal(utf8 ? fileSize : content.size());
+        progress->setPhase("parse");
+    }
+    for (;;) {
+        const bool final = !utf8 || file.atEnd();
+        const char *begin = content.constData();
+        const char *rest = parseLines(begin, begin + content.size(), final);
+        if (final || aborted) {
+            break;
+        }
+        // 不完整的最后一行移到缓冲区开头，接上下一块
+        content.remove(0, rest - begin);
+        if (!readBlock(ReadBlock)) {
+            parseLines(content.constData(), content.constData() + content.size(), true);
+            break;
+        }
+    }
+    if (aborted) {
+        return false;
+    }
+
+    if (stats) stats->addCounter("lines", lines);
+    if (progress) {
+        progress->setDone(parsed);
+        progress->setEntries(lines);
+    }
+    return true;
+}
@@ -0,0 +1,108 @@
+#ifndef SCDWRITER_H
+#define SCDWRITER_H
+
+#include "SCDDictionary.h"
+#include "SCDHeader.h"
+#include "SCDProgress.h"
+#include "SCDStats.h"
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QtGlobal>
+#include <functional>
+#include <vector>
+
+/**
+ * 细胞词库生成器
+ *
+ * 词条先全部收集到列式词库 SCDDictionary 中（不逐条分配内存），写出前按音节序列排序，
+ * 同音词合并为一个拼音组，重复词条去掉；组内保持输入顺序。
+ * 文件头的拼音组数 / 词条数 / 拼音组字节数 / 词条字节数在写出前即已确定，
+ * 词条区通过一块大缓冲区顺序写出（SCDChecksumWriter），写出的同时计算校验和，最后回填到文件头。
+ */
+class SCDWriter
+{
+public:
+    // 同一拼音组最多容纳的词数（uint16），超出时拆成多个组
+    static constexpr int MaxWordsPerGroup = 0xFFFF;
+
+    // 新词条的扩展信息（含开头的 uint16 长度）
+    static constexpr int EntryExtSize = 12;
+    static const char EntryExt[EntryExtSize];
+
+    SCDWriter();
+
+    // 添加一条词条：code 为 'a'b 形式的拼音，word 为 UTF-8 词；拼音不在拼音表中或词非法时返回 false
+    bool addEntry(const char *code, int codeLength, const char *word, int wordLength);
+
+    // 读取搜狗文本词库（每行 'a'b 词，UTF-8 或 GB18030），返回读入的词条数，失败返回 -1
+    qint64 addTextFile(const QString &txtPath);
+
+    void setName(const QString &name) { m_name = name; }
+    void setCategory(const QString &category) { m_category = category; }
+    void setRemark(const QString &remark) { m_remark = remark; }
+    void setOfficial(bool official) { m_official = official; }
+
+    // 读取、排序、写出过程中更新 progress，并在批次之间检查是否已取消（取消时删除写了一半的文件）
+    void setProgress(SCDProgress *progress) { m_progress = progress; }
+
+    // 排序分组后写出细胞词库
+    bool write(const QString &scelPath);
+
+    // 新词库的文件头：随机 ID、当前时间戳和给定的描述信息，四个计数和校验和由调用方填写
+    static SCDHeader createHeader(bool official, const QString &name, const QString &category,
+                                  const QString &remark, const QStringList &examples);
+
+    // 写出后的统计
+    quint32 groupCount() const { return m_groupCount; }
+    quint32 phraseCount() const { return m_phraseCount; }
+
+    // 因拼音或词非法而跳过的行数
+    qint64 skippedCount() const { return m_skipped; }
+
+    // 各阶段耗时和计数（读取、编码检测、解码、解析、排序去重、写出、校验和）
+    const SCDStats &stats() const { return m_stats; }
+
+    QString errorString() const { return m_error; }
+
+private:
+    bool loadPinyinTable();
+
+    QByteArray m_pinyinTable;                   // 原样写入文件的拼音表
+    QHash<QByteArray, quint16> m_syllableIndex; // 音节 -> 下标
+
+    SCDDictionary m_entries;
+    std::vector<quint16> m_code;  // 解析一行时复用的音节下标
+    std::vector<char16_t> m_word; // 解析一行时复用的 UTF-16 词
+    QStringList m_examples;
+
+    QString m_name;
+    QString m_category;
+    QString m_remark;
+    bool m_official = true;
+
+    quint32 m_groupCount = 0;
+    quint32 m_phraseCount = 0;
+    qint64 m_skipped = 0;
+    SCDStats m_stats{"scdmaker"};
+    SCDProgress *m_progress = nullptr;
+    QString m_error;
+};
+
+namespace SCDEntryText {
+    /**
+     * 逐行读取搜狗文本词库（每行 'a'b 词，UTF-8 或 GB18030），对每行调用 entry(拼音, 长度, 词, 长度)，
+     * 拼音和词均为 UTF-8。UTF-8 文件按块读入、逐块解析，内存占用与文件大小无关。无法读取文件时返回 false。
+     * stats 不为空时记录读取、编码检测、解码、解析（含 entry 回调）各阶段耗时和行数、输入字节数；
+     * progress 不为空时按块更新读取、解析进度，已取消时返回 false
+     */
+    bool readTextFile(const QString &txtPath,
+                      const std::function<void(const char *code, int codeLength, const char *word, int wordLength)> &entry,
+                      QString *errorString = nullptr, SCDStats *stats = nullptr, SCDProgress *progress = nullptr);
+
+    // 把搜狗文本词库编译为细胞词库，返回写出的词条数，失败返回 -1
+    qint64 importFile(const QString &txtPath, const QString &scelPath, QString *errorString = nullptr);
+}
+
+#endif // SCDWRITER_H
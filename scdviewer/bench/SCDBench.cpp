@@ -0,0 +1,632 @@
+// 细胞词库基准测试：scd_bench [--entries 1000,100000,1000000] [--seed N] [--rounds N]
+//                              [--workdir 目录] [--txtmaker 可执行文件] [--json]
+//
+// 按种子生成可复现的合成词库（同一种子、同一词条数得到逐字节相同的文本和 .scel 词条区），
+// 对每个规模依次测量文件头读取、词条解析、生成词库、校验和、转码、反编译、导出拼音 trie、
+// 映射 trie 后查询一次（与 parse 对比即为输入法引擎的启动开销），
+// 给出吞吐量、延迟分位数（p50/p90/p99）和峰值 RSS。指定 --txtmaker 时另外生成中文短文本，
+// 以子进程运行 txtmaker 转换（进程内的测量见 txtmaker 的 go test -bench RunPipeline）。
+// 每个用例在单独的子进程中运行，峰值 RSS 互不影响；--json 输出 JSON Lines，便于比较不同版本。
+#include "SCDChecksum.h"
+#include "SCDEntryReader.h"
+#include "SCDHeader.h"
+#include "SCDInfoCache.h"
+#include "SCDInfoRead.h"
+#include "SCDText.h"
+#include "SCDTrie.h"
+#include "SCDTrieWriter.h"
+#include "SCDWriter.h"
+#include <QByteArray>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QString>
+#include <QStringList>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <random>
+#include <vector>
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+struct Options {
+    std::vector<qint64> sizes = {1000, 100000, 1000000};
+    quint64 seed = 20240501;
+    int rounds = 5;
+    QString workDir;
+    QString txtmaker;
+    bool json = false;
+};
+
+// 一个规模的合成语料
+struct Corpus {
+    qint64 entries = 0; // 生成的行数
+    qint64 phrases = 0; // 细胞词库中的词条数（去掉了偶然重复的行）
+    QString textPath;  // 搜狗文本词库（'a'b 词）
+    QString plainPath; // 中文短文本，txtmaker 的输入（只在指定 --txtmaker 时生成）
+    QString scelPath;  // 由 textPath 生成的细胞词库
+};
+
+// 单个用例的测量结果：每个样本对应 unitsPerSample 个词条（或次调用）、bytesPerSample 字节
+struct Samples {
+    std::vector<double> nanoseconds;
+    qint64 unitsPerSample = 0;
+    qint64 bytesPerSample = 0;
+    QString error;
+};
+
+// 子进程交回父进程的汇总
+struct Summary {
+    double unitsPerSecond = 0;
+    double megabytesPerSecond = 0;
+    double p50 = 0; // 毫秒
+    double p90 = 0;
+    double p99 = 0;
+    long peakRssKiB = -1;
+    bool ok = false;
+    char error[256] = {};
+};
+
+struct BenchCase {
+    const char *name;
+    const char *unit; // 吞吐量的单位
+    std::function<void(const Corpus &, int rounds, Samples *)> run;
+};
+
+// ---- 语料生成 ----
+
+// 内置拼音表中的全部音节
+std::vector<QByteArray> builtinSyllables()
+{
+    const QByteArray data = SCDPinyinTable::builtinData();
+    SCDPinyinTable table;
+    qint64 consumed = 0;
+    std::vector<QByteArray> syllables;
+    if (!table.parse(reinterpret_cast<const uchar *>(data.constData()), data.size(), &consumed)) {
+        return syllables;
+    }
+    for (int i = 0; i < table.size(); ++i) {
+        int length = 0;
+        if (const char *text = table.syllable(static_cast<quint16>(i), &length)) {
+            syllables.emplace_back(text, length);
+        }
+    }
+    return syllables;
+}
+
+// 追加 U+0800 以上的码位（UTF-8 三或四字节）
+void appendCodePoint(QByteArray &out, char32_t c)
+{
+    if (c < 0x10000) {
+        out.append(static_cast<char>(0xE0 | (c >> 12)));
+    } else {
+        out.append(static_cast<char>(0xF0 | (c >> 18)));
+        out.append(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+    }
+    out.append(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+    out.append(static_cast<char>(0x80 | (c & 0x3F)));
+}
+
+/**
+ * 生成一个规模的语料：词长 2~6 字（以 2、3 字为主），约两成词条与上一条同音（形成多词拼音组），
+ * 字取常用汉字区，千分之五为扩展 B 区字（代理对）。随机数只由种子和词条数决定
+ */
+bool generateCorpus(const QString &dir, qint64 entries, quint64 seed, bool plain, Corpus *corpus)
+{
+    const std::vector<QByteArray> syllables = builtinSyllables();
+    if (syllables.empty()) {
+        std::fprintf(stderr, "无法读取内置拼音表\n");
+        return false;
+    }
+
+    const QString base = QString("%1/corpus_%2_%3").arg(dir).arg(seed).arg(entries);
+    corpus->entries = entries;
+    corpus->textPath = base + ".txt";
+    corpus->plainPath = plain ? base + "_plain.txt" : QString();
+    corpus->scelPath = base + ".scel";
+
+    QFile text(corpus->textPath);
+    QFile plainText(corpus->plainPath);
+    if (!text.open(QIODevice::WriteOnly | QIODevice::Truncate)
+        || (plain && !plainText.open(QIODevice::WriteOnly | QIODevice::Truncate))) {
+        std::fprintf(stderr, "无法写入语料: %s\n", qPrintable(base));
+        return false;
+    }
+
+    std::mt19937_64 rng(seed ^ (static_cast<quint64>(entries) * 0x9E3779B97F4A7C15ULL));
+    std::uniform_int_distribution<size_t> syllableDist(0, syllables.size() - 1);
+    std::uniform_int_distribution<int> hanDist(0x4E00, 0x9FA5);
+    std::uniform_int_distribution<int> percent(0, 999);
+
+    QByteArray code;
+    QByteArray word;
+    QByteArray textBuffer;
+    QByteArray plainBuffer;
+    int codeLength = 0;
+    for (qint64 i = 0; i < entries; ++i) {
+        // 约两成与上一条同音，其余重新选拼音
+        if (codeLength == 0 || percent(rng) >= 200) {
+            const int p = percent(rng);
+            codeLength = p < 500 ? 2 : p < 750 ? 3 : p < 950 ? 4 : 5 + p % 2;
+            code.resize(0);
+            for (int k = 0; k < codeLength; ++k) {
+                code.append('\'');
+                code.append(syllables[syllableDist(rng)]);
+            }
+        }
+        word.resize(0);
+        for (int k = 0; k < codeLength; ++k) {
+            appendCodePoint(word, percent(rng) < 5 ? 0x20000 + percent(rng) : hanDist(rng));
+        }
+
+        textBuffer.append(code);
+        textBuffer.append(' ');
+        textBuffer.append(word);
+        textBuffer.append('\n');
+        if (plain) {
+            plainBuffer.append(word);
+            plainBuffer.append(i % 8 == 7 ? "。\n" : "，");
+        }
+        if (textBuffer.size() >= (1 << 20)) {
+            text.write(textBuffer);
+            textBuffer.resize(0);
+            if (plain) {
+                plainText.write(plainBuffer);
+                plainBuffer.resize(0);
+            }
+        }
+    }
+    text.write(textBuffer);
+    text.close();
+    if (plain) {
+        plainText.write(plainBuffer);
+        plainText.close();
+    }
+
+    QString error;
+    corpus->phrases = SCDEntryText::importFile(corpus->textPath, corpus->scelPath, &error);
+    if (corpus->phrases < 0) {
+        std::fprintf(stderr, "生成细胞词库失败: %s\n", qPrintable(error));
+        return false;
+    }
+    return true;
+}
+
+// ---- 用例 ----
+
+// 计时运行 rounds 轮（先空跑一轮预热），每轮一个样本
+void timeRounds(int rounds, Samples *samples, const std::function<bool()> &body)
+{
+    if (!body()) {
+        return;
+    }
+    QElapsedTimer timer;
+    for (int r = 0; r < rounds; ++r) {
+        timer.start();
+        if (!body()) {
+            return;
+        }
+        samples->nanoseconds.push_back(static_cast<double>(timer.nsecsElapsed()));
+    }
+}
+
+void benchHeader(const Corpus &corpus, int rounds, Samples *samples)
+{
+    // 关闭信息缓存，每次都真正读取文件头；每次调用一个样本
+    SCDInfoCache::setEnabled(false);
+    const int calls = rounds * 200;
+    samples->unitsPerSample = 1;
+    samples->bytesPerSample = SCDHeader::ProbeSize;
+    QElapsedTimer timer;
+    for (int i = -1; i < calls; ++i) {
+        timer.start();
+        const SCDInfo info = SCDInfoRead::readSCDInfo(corpus.scelPath);
+        const qint64 elapsed = timer.nsecsElapsed();
+        if (!info.isValid) {
+            samples->error = "文件头非法";
+            return;
+        }
+        if (i >= 0) {
+            samples->nanoseconds.push_back(static_cast<double>(elapsed));
+        }
+    }
+}
+
+void benchParse(const Corpus &corpus, int rounds, Samples *samples)
+{
+    samples->unitsPerSample = corpus.phrases;
+    samples->bytesPerSample = QFileInfo(corpus.scelPath).size();
+    timeRounds(rounds, samples, [&] {
+        SCDEntryReader reader;
+        if (!reader.open(corpus.scelPath)) {
+            samples->error = reader.errorString();
+            return false;
+        }
+        SCDEntryView entry;
+        qint64 count = 0;
+        while (reader.next(entry)) {
+            ++count;
+        }
+        if (reader.hasError() || count != corpus.phrases) {
+            samples->error = reader.hasError() ? reader.errorString() : QString("词条数不符");
+            return false;
+        }
+        return true;
+    });
+}
+
+void benchWrite(const Corpus &corpus, int rounds, Samples *samples)
+{
+    const QString out = corpus.scelPath + ".write";
+    samples->unitsPerSample = corpus.entries;
+    samples->bytesPerSample = QFileInfo(corpus.textPath).size();
+    timeRounds(rounds, samples, [&] {
+        return SCDEntryText::importFile(corpus.textPath, out, &samples->error) >= 0;
+    });
+    QFile::remove(out);
+}
+
+void benchChecksum(const Corpus &corpus, int rounds, Samples *samples)
+{
+    // 读入内存后只计算，不含 I/O
+    QFile file(corpus.scelPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        samples->error = "无法打开文件";
+        return;
+    }
+    const QByteArray body = file.readAll().mid(SCDHeader::HeaderSize);
+    samples->unitsPerSample = corpus.phrases;
+    samples->bytesPerSample = body.size();
+    volatile quint32 sink = 0;
+    timeRounds(rounds, samples, [&] {
+        SCDChecksum checksum;
+        checksum.addData(body);
+        sink = sink ^ checksum.result()[0];
+        return true;
+    });
+}
+
+void benchTranscode(const Corpus &corpus, int rounds, Samples *samples)
+{
+    // 先把全部词（UTF-16LE）拷到一块连续内存，计时部分只有逐词条转码
+    SCDEntryReader reader;
+    if (!reader.open(corpus.scelPath)) {
+        samples->error = reader.errorString();
+        return;
+    }
+    std::vector<uchar> words;
+    std::vector<int> lengths;
+    lengths.reserve(static_cast<size_t>(corpus.phrases));
+    SCDEntryView entry;
+    while (reader.next(entry)) {
+        words.insert(words.end(), entry.word, entry.word + entry.wordBytes);
+        lengths.push_back(entry.wordBytes);
+    }
+
+    samples->unitsPerSample = static_cast<qint64>(lengths.size());
+    samples->bytesPerSample = static_cast<qint64>(words.size());
+    QByteArray out;
+    out.reserve(static_cast<qsizetype>(words.size()) * 2);
+    timeRounds(rounds, samples, [&] {
+        out.resize(0);
+        qsizetype pos = 0;
+        for (int bytes : lengths) {
+            SCDText::appendUtf8(out, words.data() + pos, bytes);
+            pos += bytes;
+        }
+        return true;
+    });
+}
+
+void benchDecompile(const Corpus &corpus, int rounds, Samples *samples)
+{
+    const QString out = corpus.scelPath + ".decompile.txt";
+    samples->unitsPerSample = corpus.phrases;
+    samples->bytesPerSample = QFileInfo(corpus.scelPath).size();
+    timeRounds(rounds, samples, [&] {
+        return SCDEntryText::exportFile(corpus.scelPath, out, &samples->error) >= 0;
+    });
+    QFile::remove(out);
+}
+
+void benchTrie(const Corpus &corpus, int rounds, Samples *samples)
+{
+    const QString out = corpus.scelPath + ".sdt";
+    samples->unitsPerSample = corpus.phrases;
+    samples->bytesPerSample = QFileInfo(corpus.scelPath).size();
+    timeRounds(rounds, samples, [&] {
+        SCDTrieWriter writer;
+        if (!writer.write(corpus.scelPath, out)) {
+            samples->error = writer.errorString();
+            return false;
+        }
+        return true;
+    });
+    QFile::remove(out);
+}
+
+void benchTrieLoad(const Corpus &corpus, int rounds, Samples *samples)
+{
+    // 计时部分为打开并映射 .sdt、attach、按词库最后一个词条的拼音查询一次并取出第一个词
+    const QString path = corpus.scelPath + ".sdt";
+    SCDTrieWriter writer;
+    SCDEntryReader reader;
+    if (!writer.write(corpus.scelPath, path) || !reader.open(corpus.scelPath)) {
+        samples->error = writer.errorString().isEmpty() ? reader.errorString() : writer.errorString();
+        QFile::remove(path);
+        return;
+    }
+    QByteArray query;
+    SCDEntryView entry;
+    while (reader.next(entry)) {
+        query.clear();
+        for (int i = 0; i < entry.syllableCount; ++i) {
+            int length = 0;
+            const char *text = reader.pinyinTable().syllable(entry.syllableAt(i), &length);
+            query.append(i == 0 ? "" : "'").append(text, length);
+        }
+    }
+
+    samples->unitsPerSample = 1;
+    samples->bytesPerSample = QFileInfo(path).size();
+    char16_t word[SCDTrie::MaxWordLength];
+    timeRounds(rounds, samples, [&] {
+        QFile file(path);
+        const uchar *data = file.open(QIODevice::ReadOnly) ? file.map(0, file.size()) : nullptr;
+        SCDTrie trie;
+        if (!data || !trie.attach(data, static_cast<size_t>(file.size()))) {
+            samples->error = "无法映射 trie";
+            return false;
+        }
+        const quint32 node = trie.find(query.constData(), static_cast<size_t>(query.size()));
+        if (trie.word(node, 0, word, SCDTrie::MaxWordLength) == 0) {
+            samples->error = "查询失败";
+            return false;
+        }
+        return true;
+    });
+    QFile::remove(path);
+}
+
+#ifdef Q_OS_UNIX
+// txtmaker 是独立的 Go 程序：以子进程运行，样本为整个进程的耗时
+void benchTxtmaker(const QString &txtmaker, const Corpus &corpus, int rounds, Samples *samples)
+{
+    samples->unitsPerSample = corpus.entries;
+    samples->bytesPerSample = QFileInfo(corpus.plainPath).size();
+    const QByteArray program = QFile::encodeName(txtmaker);
+    const QByteArray input = QFile::encodeName(corpus.plainPath);
+    timeRounds(rounds, samples, [&] {
+        const pid_t pid = fork();
+        if (pid == 0) {
+            std::freopen("/dev/null", "w", stdout);
+            execl(program.constData(), program.constData(), input.constData(), static_cast<char *>(nullptr));
+            _exit(127);
+        }
+        int status = 0;
+        if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+            samples->error = "txtmaker 运行失败";
+            return false;
+        }
+        return true;
+    });
+    QFile::remove(corpus.plainPath.chopped(4) + "_sg.txt");
+}
+#endif
+
+// ---- 统计与运行 ----
+
+// 最近秩法取分位数（毫秒）
+double percentile(std::vector<double> sorted, double p)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    std::sort(sorted.begin(), sorted.end());
+    const size_t rank = static_cast<size_t>(std::ceil(p * sorted.size()));
+    return sorted[std::min(sorted.size() - 1, rank > 0 ? rank - 1 : 0)] / 1e6;
+}
+
+Summary summarize(const Samples &samples)
+{
+    Summary summary;
+    if (!samples.error.isEmpty() || samples.nanoseconds.empty()) {
+        const QByteArray error = (samples.error.isEmpty() ? QString("没有样本") : samples.error).toUtf8();
+        std::strncpy(summary.error, error.constData(), sizeof(summary.error) - 1);
+        return summary;
+    }
+    double total = 0;
+    for (double ns : samples.nanoseconds) {
+        total += ns;
+    }
+    const double seconds = total / 1e9;
+    const double n = static_cast<double>(samples.nanoseconds.size());
+    summary.unitsPerSecond = samples.unitsPerSample * n / seconds;
+    summary.megabytesPerSecond = samples.bytesPerSample * n / seconds / 1e6;
+    summary.p50 = percentile(samples.nanoseconds, 0.50);
+    summary.p90 = percentile(samples.nanoseconds, 0.90);
+    summary.p99 = percentile(samples.nanoseconds, 0.99);
+    summary.ok = true;
+    return summary;
+}
+
+// 在子进程中运行一个用例，峰值 RSS 只含这个用例；不支持 fork 的平台在本进程中运行
+Summary runIsolated(const std::function<void(Samples *)> &run)
+{
+#ifdef Q_OS_UNIX
+    int fds[2];
+    if (pipe(fds) == 0) {
+        std::fflush(stdout);
+        const pid_t pid = fork();
+        if (pid == 0) {
+            close(fds[0]);
+            Samples samples;
+            run(&samples);
+            const Summary summary = summarize(samples);
+            const ssize_t written = write(fds[1], &summary, sizeof(summary));
+            _exit(written == static_cast<ssize_t>(sizeof(summary)) ? 0 : 1);
+        }
+        close(fds[1]);
+        Summary summary;
+        const bool received = pid > 0 && read(fds[0], &summary, sizeof(summary)) == static_cast<ssize_t>(sizeof(summary));
+        close(fds[0]);
+        int status = 0;
+        struct rusage usage = {};
+        if (pid > 0 && wait4(pid, &status, 0, &usage) == pid && received) {
+            summary.peakRssKiB = usage.ru_maxrss; // Linux 上单位为 KiB
+            return summary;
+        }
+        Summary failed;
+        std::strncpy(failed.error, "子进程异常退出", sizeof(failed.error) - 1);
+        return failed;
+    }
+#endif
+    Samples samples;
+    run(&samples);
+    return summarize(samples);
+}
+
+void printSummary(const Options &options, const Corpus &corpus, const BenchCase &benchCase, const Summary &s)
+{
+    if (options.json) {
+        if (!s.ok) {
+            std::printf("{\"case\":\"%s\",\"entries\":%lld,\"seed\":%llu,\"ok\":false,\"error\":\"%s\"}\n",
+                        benchCase.name, static_cast<long long>(corpus.entries),
+                        static_cast<unsigned long long>(options.seed), s.error);
+            return;
+        }
+        std::printf("{\"case\":\"%s\",\"entries\":%lld,\"seed\":%llu,\"rounds\":%d,\"kernel\":\"%s\","
+                    "\"unit\":\"%s\",\"perSecond\":%.1f,\"mbPerSecond\":%.2f,"
+                    "\"p50Ms\":%.4f,\"p90Ms\":%.4f,\"p99Ms\":%.4f,\"peakRssKiB\":%ld,\"ok\":true}\n",
+                    benchCase.name, static_cast<long long>(corpus.entries),
+                    static_cast<unsigned long long>(options.seed), options.rounds, SCDText::kernelName(),
+                    benchCase.unit, s.unitsPerSecond, s.megabytesPerSecond, s.p50, s.p90, s.p99, s.peakRssKiB);
+        return;
+    }
+    if (!s.ok) {
+        std::printf("%-10s %10lld  失败：%s\n", benchCase.name, static_cast<long long>(corpus.entries), s.error);
+        return;
+    }
+    std::printf("%-10s %10lld %14.0f %-6s %9.1f %10.3f %10.3f %10.3f %10.1f\n", benchCase.name,
+                static_cast<long long>(corpus.entries), s.unitsPerSecond, benchCase.unit, s.megabytesPerSecond,
+                s.p50, s.p90, s.p99, s.peakRssKiB >= 0 ? s.peakRssKiB / 1024.0 : -1.0);
+}
+
+bool parseOptions(int argc, char **argv, Options *options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (std::strcmp(arg, "--json") == 0) {
+            options->json = true;
+            continue;
+        }
+        if (!value) {
+            return false;
+        }
+        ++i;
+        if (std::strcmp(arg, "--entries") == 0) {
+            options->sizes.clear();
+            for (const QString &size : QString::fromLocal8Bit(value).split(',')) {
+                const qint64 n = size.toLongLong();
+                if (n <= 0) {
+                    return false;
+                }
+                options->sizes.push_back(n);
+            }
+        } else if (std::strcmp(arg, "--seed") == 0) {
+            options->seed = std::strtoull(value, nullptr, 10);
+        } else if (std::strcmp(arg, "--rounds") == 0) {
+            options->rounds = std::max(1, std::atoi(value));
+        } else if (std::strcmp(arg, "--workdir") == 0) {
+            options->workDir = QString::fromLocal8Bit(value);
+        } else if (std::strcmp(arg, "--txtmaker") == 0) {
+            options->txtmaker = QString::fromLocal8Bit(value);
+        } else {
+            return false;
+        }
+    }
+    return !options->sizes.empty();
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, &options)) {
+        std::fprintf(stderr, "用法: %s [--entries 1000,100000,1000000] [--seed N] [--rounds N] "
+                             "[--workdir 目录] [--txtmaker 可执行文件] [--json]\n", argv[0]);
+        return 2;
+    }
+
+    // 未指定工作目录时用临时目录，结束后删除
+    const bool ownWorkDir = options.workDir.isEmpty();
+    if (ownWorkDir) {
+        options.workDir = QDir::tempPath() + QString("/scd_bench_%1").arg(options.seed);
+    }
+    QDir().mkpath(options.workDir);
+
+    std::vector<BenchCase> cases = {
+        {"header", "次", [](const Corpus &c, int r, Samples *s) { benchHeader(c, r, s); }},
+        {"parse", "词条", [](const Corpus &c, int r, Samples *s) { benchParse(c, r, s); }},
+        {"write", "词条", [](const Corpus &c, int r, Samples *s) { benchWrite(c, r, s); }},
+        {"checksum", "词条", [](const Corpus &c, int r, Samples *s) { benchChecksum(c, r, s); }},
+        {"transcode", "词条", [](const Corpus &c, int r, Samples *s) { benchTranscode(c, r, s); }},
+        {"decompile", "词条", [](const Corpus &c, int r, Samples *s) { benchDecompile(c, r, s); }},
+        {"trie", "词条", [](const Corpus &c, int r, Samples *s) { benchTrie(c, r, s); }},
+        {"trieload", "次", [](const Corpus &c, int r, Samples *s) { benchTrieLoad(c, r, s); }},
+    };
+#ifdef Q_OS_UNIX
+    if (!options.txtmaker.isEmpty()) {
+        const QString txtmaker = options.txtmaker;
+        cases.push_back({"txtmaker", "词条", [txtmaker](const Corpus &c, int r, Samples *s) {
+                             benchTxtmaker(txtmaker, c, r, s);
+                         }});
+    }
+#endif
+
+    if (!options.json) {
+        std::printf("种子：%llu，轮数：%d，转码内核：%s\n", static_cast<unsigned long long>(options.seed),
+                    options.rounds, SCDText::kernelName());
+        std::printf("%-10s %10s %21s %9s %10s %10s %10s %10s\n", "用例", "词条数", "吞吐量/s", "MB/s",
+                    "p50(ms)", "p90(ms)", "p99(ms)", "峰值RSS(MiB)");
+    }
+
+    int failures = 0;
+    for (qint64 size : options.sizes) {
+        Corpus corpus;
+        if (!generateCorpus(options.workDir, size, options.seed, !options.txtmaker.isEmpty(), &corpus)) {
+            return 1;
+        }
+        for (const BenchCase &benchCase : cases) {
+            const Summary summary = runIsolated([&](Samples *samples) {
+                benchCase.run(corpus, options.rounds, samples);
+            });
+            failures += summary.ok ? 0 : 1;
+            printSummary(options, corpus, benchCase, summary);
+            std::fflush(stdout);
+        }
+        if (ownWorkDir) {
+            QFile::remove(corpus.textPath);
+            QFile::remove(corpus.scelPath);
+            if (!corpus.plainPath.isEmpty()) {
+                QFile::remove(corpus.plainPath);
+            }
+        }
+    }
+    if (ownWorkDir) {
+        QDir().rmdir(options.workDir);
+    }
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,133 @@
+// 转码内核基准测试：scdtext_bench [词条数]
+// 输出逐词条解码（模拟反编译）与整块解码（模拟文件头字段）的吞吐量
+#include "SCDText.h"
+#include <QElapsedTimer>
+#include <QString>
+#include <QtEndian>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// 生成 UTF-16LE 词条：多数为 2~4 个常用汉字，少量夹杂 ASCII 和 BMP 以外的字符
+static std::vector<uchar> makeWords(int count, std::vector<int> &lengths, quint32 seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> lengthDist(2, 4);
+    std::uniform_int_distribution<int> hanDist(0x4E00, 0x9FA5);
+    std::uniform_int_distribution<int> kindDist(0, 99);
+
+    std::vector<uchar> data;
+    lengths.clear();
+    lengths.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const int length = lengthDist(rng);
+        int units = 0;
+        for (int k = 0; k < length; ++k) {
+            const int kind = kindDist(rng);
+            quint16 u[2];
+            int n = 1;
+            if (kind < 95) {
+                u[0] = static_cast<quint16>(hanDist(rng));
+            } else if (kind < 99) {
+                u[0] = static_cast<quint16>('a' + kind % 26);
+            } else {
+                u[0] = 0xD840; // U+20000 起的扩展 B 区
+                u[1] = static_cast<quint16>(0xDC00 + k);
+                n = 2;
+            }
+            for (int j = 0; j < n; ++j) {
+                uchar bytes[2];
+                qToLittleEndian<quint16>(u[j], bytes);
+                data.push_back(bytes[0]);
+                data.push_back(bytes[1]);
+            }
+            units += n;
+        }
+        lengths.push_back(units * 2);
+    }
+    return data;
+}
+
+// 与 Qt 自带转换逐条比较
+static bool verify(const std::vector<uchar> &data, const std::vector<int> &lengths)
+{
+    qsizetype pos = 0;
+    QByteArray out;
+    for (int bytes : lengths) {
+        out.resize(0);
+        SCDText::appendUtf8(out, data.data() + pos, bytes);
+        const QByteArray expected = QString::fromUtf16(reinterpret_cast<const char16_t *>(data.data() + pos),
+                                                       bytes / 2).toUtf8();
+        if (out != expected) {
+            return false;
+        }
+        pos += bytes;
+    }
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    const int count = argc > 1 ? std::atoi(argv[1]) : 2000000;
+    std::vector<int> lengths;
+    const std::vector<uchar> data = makeWords(count, lengths, 20240501);
+
+    std::printf("内核：%s，词条：%d，输入：%.1f MiB\n", SCDText::kernelName(), count, data.size() / 1048576.0);
+    if (!verify(data, lengths)) {
+        std::printf("结果与 QString::toUtf8 不一致\n");
+        return 1;
+    }
+
+    QByteArray out;
+    out.reserve(static_cast<qsizetype>(data.size()) * 2);
+    QElapsedTimer timer;
+
+    // 逐词条解码
+    const int rounds = 5;
+    timer.start();
+    for (int r = 0; r < rounds; ++r) {
+        out.resize(0);
+        qsizetype pos = 0;
+        for (int bytes : lengths) {
+            SCDText::appendUtf8(out, data.data() + pos, bytes);
+            pos += bytes;
+        }
+    }
+    double seconds = timer.nsecsElapsed() / 1e9;
+    std::printf("逐词条 UTF-16LE -> UTF-8：%.2f GB/s，%.1f M 词条/s\n",
+                data.size() * rounds / seconds / 1e9, count * rounds / seconds / 1e6);
+
+    // 整块解码
+    timer.restart();
+    for (int r = 0; r < rounds; ++r) {
+        out.resize(0);
+        SCDText::appendUtf8(out, data.data(), static_cast<qsizetype>(data.size()));
+    }
+    seconds = timer.nsecsElapsed() / 1e9;
+    std::printf("整块 UTF-16LE -> UTF-8：%.2f GB/s\n", data.size() * rounds / seconds / 1e9);
+
+    // UTF-8 -> UTF-16（词库生成方向）
+    std::vector<char16_t> back;
+    back.reserve(data.size());
+    timer.restart();
+    for (int r = 0; r < rounds; ++r) {
+        back.clear();
+        SCDText::appendUtf16(back, reinterpret_cast<const uchar *>(out.constData()), out.size());
+    }
+    seconds = timer.nsecsElapsed() / 1e9;
+    std::printf("整块 UTF-8 -> UTF-16：%.2f GB/s\n", out.size() * rounds / seconds / 1e9);
+
+    // NUL 扫描（文件头定长字段）
+    std::vector<uchar> field(0x800, 0x41);
+    field[0x7FE] = field[0x7FF] = 0;
+    qsizetype sink = 0;
+    const int scans = 1000000;
+    timer.restart();
+    for (int r = 0; r < scans; ++r) {
+        sink += SCDText::findNul16(field.data(), static_cast<qsizetype>(field.size() / 2));
+    }
+    seconds = timer.nsecsElapsed() / 1e9;
+    std::printf("NUL 扫描：%.2f GB/s (%lld)\n", field.size() * double(scans) / seconds / 1e9,
+                static_cast<long long>(sink));
+    return 0;
+}
@@ -0,0 +1,271 @@
+package main
+
+import (
+	"bytes"
+	"encoding/binary"
+	"fmt"
+	"io"
+	"strings"
+	"sync"
+	"time"
+	"unicode/utf16"
+	"unicode/utf8"
+
+	"github.com/axgle/mahonia"
+)
+
+/**
+ * 输入的编码检测与转码，输入文件只打开、只读一遍
+ *
+ * 第一块（sampleBytes）读入后直接用于检测编码，之后原样作为转码的第一块，不再重新打开文件。
+ * UTF-8 输入（去掉 BOM）不经转码交给流水线；其他编码每次读入 decodeBlock 字节，整块转成 UTF-8，
+ * 输出缓冲反复使用。流水线只看到 UTF-8，不再逐行调用 mahonia 的 ConvertString（每行一个新字符串）。
+ *
+ * GB18030/GBK/BIG5 按表转码：
+ *   - ASCII 每次检查 8 个字节，高位都为 0 时整段拷贝
+ *   - 双字节字符（首字节 0x81~0xFE，尾字节 0x40~0xFE）查表，表由 mahonia 的解码器生成，每种编码只生成一次
+ *   - 其余（GB18030 的四字节字符、非法字节）逐个交给 mahonia 的解码器，结果与 ConvertString 相同
+ * 其他编码整块逐字符交给解码器（可能有移位状态，不能跳过 ASCII）。
+ * 块尾不完整的字符留到下一块开头；UTF-16LE/BE 按 unicode/utf16 的规则转码，不成对的代理项换成 U+FFFD。
+ */
+
+const (
+	sampleBytes = 512 * 1024 // 用于检测编码的第一块
+	decodeBlock = 1 << 20    // 转码时每块的字节数
+)
+
+var utf8BOM = []byte{0xEF, 0xBB, 0xBF}
+
+// 可以按表转码的编码（名称经 simplifyCharset 处理）
+var tableCharsets = map[string]bool{"GB18030": true, "GBK": true, "BIG5": true}
+
+// 去掉编码名中的 - 和 _ 并转成大写（chardet 给出 GB-18030，mahonia 也接受这种写法）
+func simplifyCharset(name string) string {
+	return strings.ToUpper(strings.NewReplacer("-", "", "_", "").Replace(name))
+}
+
+/**
+ * 一种编码的转码表。表项是已编码好的 UTF-8：低 3 字节依次为 UTF-8 字节，最高字节为长度，
+ * 转码时整项写入输出、按长度前进；0 表示交给解码器（非法、不完整或超出 BMP 的字符）
+ */
+type charsetTable struct {
+	decoder mahonia.Decoder
+	fast    bool              // 为 false 时不查表，全部交给解码器
+	single  [0x80]uint32      // 0x80~0xFF 单独成字时
+	double  [126 * 191]uint32 // 首字节 0x81~0xFE、尾字节 0x40~0xFE 的双字节字符
+}
+
+// 把字符编成表项，超出 BMP 时返回 0
+func tableEntry(c rune) uint32 {
+	var b [4]byte
+	n := utf8.EncodeRune(b[:], c)
+	if n > 3 {
+		return 0
+	}
+	return uint32(b[0]) | uint32(b[1])<<8 | uint32(b[2])<<16 | uint32(n)<<24
+}
+
+var charsetTables sync.Map // 编码名 -> *charsetTable
+
+// 取编码的转码表，第一次使用时生成；mahonia 不支持的编码返回 nil
+func loadCharsetTable(encoding string) *charsetTable {
+	if t, ok := charsetTables.Load(encoding); ok {
+		return t.(*charsetTable)
+	}
+	decoder := mahonia.NewDecoder(encoding)
+	if decoder == nil {
+		return nil
+	}
+	t := &charsetTable{decoder: decoder, fast: tableCharsets[simplifyCharset(encoding)]}
+	if t.fast {
+		var pair [2]byte
+		for lead := 0x80; lead <= 0xFF; lead++ {
+			pair[0] = byte(lead)
+			if c, size, status := decoder(pair[:1]); status == mahonia.SUCCESS && size == 1 {
+				t.single[lead-0x80] = tableEntry(c)
+			}
+			if lead < 0x81 || lead > 0xFE {
+				continue
+			}
+			for trail := 0x40; trail <= 0xFE; trail++ {
+				pair[1] = byte(trail)
+				if c, size, status := decoder(pair[:]); status == mahonia.SUCCESS && size == 2 {
+					t.double[(lead-0x81)*191+trail-0x40] = tableEntry(c)
+				}
+			}
+		}
+	}
+	actual, _ := charsetTables.LoadOrStore(encoding, t)
+	return actual.(*charsetTable)
+}
+
+// 把 src 转成 UTF-8 追加到 dst，返回 dst 和用掉的字节数；eof 为 false 时块尾不完整的字符不转，留给下一块
+func (t *charsetTable) decode(dst, src []byte, eof bool) ([]byte, int) {
+	// 最坏情况下每个输入字节变成 3 个字节（U+FFFD），另留 4 个字节供整项写入；写入 buf，w 为已写长度
+	if need := len(dst) + 3*len(src) + 4; cap(dst) < need {
+		dst = append(make([]byte, 0, need), dst...)
+	}
+	buf := dst[:cap(dst)]
+	w := len(dst)
+	i := 0
+	for i < len(src) {
+		b := src[i]
+		if t.fast {
+			if b < 0x80 {
+				start := i
+				for i+8 <= len(src) && binary.LittleEndian.Uint64(src[i:])&0x8080808080808080 == 0 {
+					i += 8
+				}
+				for i < len(src) && src[i] < 0x80 {
+					i++
+				}
+				w += copy(buf[w:], src[start:i])
+				continue
+			}
+			if b >= 0x81 && b <= 0xFE && i+1 < len(src) && src[i+1] >= 0x40 && src[i+1] <= 0xFE {
+				if e := t.double[int(b-0x81)*191+int(src[i+1]-0x40)]; e != 0 {
+					binary.LittleEndian.PutUint32(buf[w:], e)
+					w += int(e >> 24)
+					i += 2
+					continue
+				}
+			}
+			if e := t.single[b-0x80]; e != 0 {
+				binary.LittleEndian.PutUint32(buf[w:], e)
+				w += int(e >> 24)
+				i++
+				continue
+			}
+		}
+
+		c, size, status := t.decoder(src[i:])
+		if status == mahonia.NO_ROOM {
+			if !eof {
+				break
+			}
+			// 与 ConvertString 相同：文件末尾不完整的字符整体换成 U+FFFD
+			c, size, status = utf8.RuneError, len(src)-i, mahonia.INVALID_CHAR
+		}
+		if size <= 0 {
+			c, size, status = utf8.RuneError, 1, mahonia.INVALID_CHAR
+		}
+		i += size
+		if status != mahonia.STATE_ONLY {
+			w += utf8.EncodeRune(buf[w:], c)
+		}
+	}
+	return buf[:w], i
+}
+
+// UTF-16 转 UTF-8，参数和返回值同 charsetTable.decode
+func decodeUTF16(dst, src []byte, eof bool, order binary.ByteOrder) ([]byte, int) {
+	i := 0
+	for i+2 <= len(src) {
+		u := rune(order.Uint16(src[i:]))
+		switch {
+		case !utf16.IsSurrogate(u):
+			dst = utf8.AppendRune(dst, u)
+			i += 2
+		case u < 0xDC00 && i+4 <= len(src):
+			if c := utf16.DecodeRune(u, rune(order.Uint16(src[i+2:]))); c != utf8.RuneError {
+				dst = utf8.AppendRune(dst, c)
+				i += 4
+			} else {
+				dst = utf8.AppendRune(dst, utf8.RuneError)
+				i += 2
+			}
+		case u < 0xDC00 && !eof:
+			return dst, i
+		default:
+			dst = utf8.AppendRune(dst, utf8.RuneError)
+			i += 2
+		}
+	}
+	if eof && i < len(src) {
+		dst = utf8.AppendRune(dst, utf8.RuneError)
+		i = len(src)
+	}
+	return dst, i
+}
+
+// 按块转码的 reader，输出 UTF-8
+type decodingReader struct {
+	src    io.Reader
+	decode func(dst, src []byte, eof bool) ([]byte, int)
+	in     []byte // 原始字节，in[:n] 有效，开头是上一块留下的不完整字符
+	n      int
+	out    []byte // 转码结果，out[pos:] 还没有读走
+	pos    int
+	err    error // 读 src 遇到的错误（含 io.EOF），out 读完后返回
+	stats  *runStats
+}
+
+func (d *decodingReader) Read(p []byte) (int, error) {
+	for d.pos == len(d.out) {
+		if d.err != nil && d.n == 0 {
+			return 0, d.err
+		}
+		d.fill()
+	}
+	n := copy(p, d.out[d.pos:])
+	d.pos += n
+	return n, nil
+}
+
+// 读满一块（第一块已在检测时读入）并整块转码，转码时间记入 decode 阶段
+func (d *decodingReader) fill() {
+	if d.err == nil && d.n < len(d.in) {
+		m, err := d.src.Read(d.in[d.n:])
+		d.n += m
+		d.err = err
+	}
+	start := time.Now()
+	var used int
+	d.out, used = d.decode(d.out[:0], d.in[:d.n], d.err != nil)
+	d.pos = 0
+	d.n = copy(d.in, d.in[used:d.n])
+	d.stats.since(stageDecode, start)
+}
+
+/**
+ * 读入 r 的第一块检测编码（检测过程写到 out），返回输出 UTF-8 的 reader 和检测到的编码。
+ * 编码不受支持时返回错误；读 r 出错时返回的错误包装了原错误（取消时可用 errors.Is 判断）
+ */
+func newDecodingReader(r io.Reader, sampleSize int, out io.Writer, stats *runStats) (io.Reader, string, error) {
+	in := make([]byte, decodeBlock)
+	n, err := io.ReadFull(r, in[:sampleBytes])
+	if err == io.ErrUnexpectedEOF {
+		err = io.EOF
+	} else if err != nil && err != io.EOF {
+		return nil, "", fmt.Errorf("读取文件样本失败: %w", err)
+	}
+
+	encoding, derr := detectEncoding(in[:n], sampleSize, out)
+	if derr != nil {
+		return nil, "", derr
+	}
+
+	d := &decodingReader{src: r, in: in, n: n, err: err, stats: stats}
+	switch encoding {
+	case "UTF-8":
+		return io.MultiReader(bytes.NewReader(bytes.TrimPrefix(in[:n], utf8BOM)), r), encoding, nil
+	case "UTF-16LE", "UTF-16BE":
+		order := binary.ByteOrder(binary.LittleEndian)
+		if encoding == "UTF-16BE" {
+			order = binary.BigEndian
+		}
+		if n >= 2 && order.Uint16(in) == 0xFEFF {
+			d.n = copy(in, in[2:n])
+		}
+		d.decode = func(dst, src []byte, eof bool) ([]byte, int) { return decodeUTF16(dst, src, eof, order) }
+	default:
+		t := loadCharsetTable(encoding)
+		if t == nil {
+			return nil, "", fmt.Errorf("不支持的编码: %s", encoding)
+		}
+		d.decode = t.decode
+	}
+	// 最坏情况下每个输入字节变成 3 个字节（U+FFFD），输出缓冲一次分配到位
+	d.out = make([]byte, 0, 3*decodeBlock+4)
+	return d, encoding, nil
+}
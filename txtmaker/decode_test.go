@@ -0,0 +1,150 @@
+package main
+
+import (
+	"bytes"
+	"encoding/binary"
+	"io"
+	"math/rand"
+	"strings"
+	"testing"
+	"testing/iotest"
+	"unicode/utf16"
+
+	"github.com/axgle/mahonia"
+)
+
+// 固定种子生成 n 个片段的多字节编码数据：ASCII、双字节、四字节和随机字节混在一起（含非法序列）
+func syntheticMultibyte(n int, seed int64) []byte {
+	rng := rand.New(rand.NewSource(seed))
+	var b []byte
+	for i := 0; i < n; i++ {
+		switch rng.Intn(8) {
+		case 0:
+			b = append(b, "abc 123\n"[:1+rng.Intn(8)]...)
+		case 1:
+			b = append(b, byte(0x81+rng.Intn(126)), byte(0x30+rng.Intn(10)), byte(0x81+rng.Intn(126)), byte(0x30+rng.Intn(10)))
+		case 2:
+			b = append(b, byte(rng.Intn(256)))
+		default:
+			b = append(b, byte(0x81+rng.Intn(126)), byte(0x40+rng.Intn(191)))
+		}
+	}
+	return b
+}
+
+// 块很小、每次只读到一部分时，按块转码的结果与整段 ConvertString 相同
+func TestCharsetDecodeBlocks(t *testing.T) {
+	data := syntheticMultibyte(20000, 7)
+	for _, encoding := range []string{"GB18030", "BIG5", "ISO-8859-1"} {
+		table := loadCharsetTable(encoding)
+		if table == nil {
+			t.Fatalf("%s: 不支持", encoding)
+		}
+		want := mahonia.NewDecoder(encoding).ConvertString(string(data))
+		for _, block := range []int{5, 64, 4096} {
+			d := &decodingReader{
+				src:    iotest.HalfReader(bytes.NewReader(data)),
+				decode: table.decode,
+				in:     make([]byte, block),
+				stats:  new(runStats),
+			}
+			got, err := io.ReadAll(d)
+			if err != nil {
+				t.Fatal(err)
+			}
+			if string(got) != want {
+				t.Errorf("%s block=%d: 转码结果与 ConvertString 不同", encoding, block)
+			}
+		}
+	}
+}
+
+func TestDecodeUTF16(t *testing.T) {
+	text := "北京 abc\n😀柏临河\n"
+	units := utf16.Encode([]rune(text))
+	for _, order := range []binary.AppendByteOrder{binary.LittleEndian, binary.BigEndian} {
+		data := order.AppendUint16(nil, 0xFEFF)
+		for _, u := range units {
+			data = order.AppendUint16(data, u)
+		}
+		var log bytes.Buffer
+		r, encoding, err := newDecodingReader(iotest.OneByteReader(bytes.NewReader(data)), 10000, &log, new(runStats))
+		if err != nil {
+			t.Fatal(err)
+		}
+		if encoding != "UTF-16LE" && encoding != "UTF-16BE" {
+			t.Fatalf("检测为 %s", encoding)
+		}
+		got, err := io.ReadAll(r)
+		if err != nil {
+			t.Fatal(err)
+		}
+		if string(got) != text {
+			t.Errorf("%s: %q", encoding, got)
+		}
+	}
+
+	// 不成对的代理项和末尾的单个字节换成 U+FFFD
+	data := []byte{0x3D, 0xD8, 'a', 0, 0x00, 0xDC, 'b', 0, 'c'}
+	got, n := decodeUTF16(nil, data, true, binary.LittleEndian)
+	if n != len(data) || string(got) != "�a�b�" {
+		t.Errorf("%q", got)
+	}
+	// 块尾的高代理项和半个码元留给下一块
+	if got, n := decodeUTF16(nil, []byte{'a', 0, 0x3D, 0xD8, 0x00}, false, binary.LittleEndian); n != 2 || string(got) != "a" {
+		t.Errorf("%q %d", got, n)
+	}
+}
+
+// 超过检测样本的 UTF-8 输入：样本截断在字符中间时仍检测为 UTF-8，BOM 去掉，其余原样输出
+func TestDecodingReaderUTF8(t *testing.T) {
+	text := "a" + strings.Repeat("柏临河，", sampleBytes/12+100)
+	data := append(append([]byte(nil), utf8BOM...), text...)
+	if (sampleBytes-len(utf8BOM)-1)%3 == 0 {
+		t.Fatal("样本应截断在字符中间")
+	}
+	var log bytes.Buffer
+	r, encoding, err := newDecodingReader(bytes.NewReader(data), 10000, &log, new(runStats))
+	if err != nil {
+		t.Fatal(err)
+	}
+	got, err := io.ReadAll(r)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if encoding != "UTF-8" || string(got) != text {
+		t.Errorf("编码 %s，输出 %d 字节", encoding, len(got))
+	}
+
+	if enc, _ := detectEncoding([]byte(text)[:sampleBytes], 10000, io.Discard); enc != "UTF-8" {
+		t.Errorf("截断的样本检测为 %s", enc)
+	}
+}
+
+// go test -bench DecodeGB18030 -benchmem
+func BenchmarkDecodeGB18030(b *testing.B) {
+	// 与常见的 GBK 文本相近：每行 20 个 GB2312 汉字区的双字节字符，加少量 ASCII
+	rng := rand.New(rand.NewSource(20240501))
+	var data []byte
+	for len(data) < 8<<20 {
+		for k := 0; k < 20; k++ {
+			data = append(data, byte(0xB0+rng.Intn(0xF7-0xB0+1)), byte(0xA1+rng.Intn(0xFE-0xA1+1)))
+		}
+		data = append(data, " abc,\n"...)
+	}
+	table := loadCharsetTable("GB18030")
+	b.SetBytes(int64(len(data)))
+	b.ReportAllocs()
+	for i := 0; i < b.N; i++ {
+		d := &decodingReader{
+			src:    bytes.NewReader(data),
+			decode: table.decode,
+			in:     make([]byte, decodeBlock),
+			out:    make([]byte, 0, 3*decodeBlock+4),
+			stats:  new(runStats),
+		}
+		if _, err := io.Copy(io.Discard, d); err != nil {
+			b.Fatal(err)
+		}
+	}
+}
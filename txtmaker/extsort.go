@@ -0,0 +1,274 @@
+package main
+
+import (
+	"bufio"
+	"container/heap"
+	"fmt"
+	"io"
+	"os"
+	"path/filepath"
+	"sort"
+	"time"
+)
+
+const (
+	// 同时合并的顺串数上限，超过时先分组合并为中间顺串
+	maxMergeFanIn = 64
+	// 合并时每个顺串的读缓冲
+	mergeReadBuffer = 256 * 1024
+	// 每行在内存中的估算额外开销（字符串头、切片元素和分配对齐）
+	lineOverhead = 40
+)
+
+/**
+ * 按拼音排序并去重后写出，内存占用不超过 memBudget（字节）
+ *
+ * 转拼音的结果先攒在内存中，超过预算的一半时排序、去重，作为一个顺串写入 tmpDir，
+ * 写顺串在后台进行，同时继续接收下一批；最后多路归并所有顺串，归并时去掉相邻的重复行。
+ * 顺串过多时分轮归并，每轮最多同时打开 maxMergeFanIn 个。全部词条能放进预算时不写临时文件。
+ *
+ * 输出行形如 'a'b 词：音节之间用 ' 分隔，而 ' (0x27) 小于任何字母、空格 (0x20) 又小于 '，
+ * 所以按字节比较整行，恰好等价于先逐个音节比较（音节序列是前缀的排在前面），再比较词。
+ */
+func runSortedPipeline(r io.Reader, w io.Writer, jobs int, memBudget int64, tmpDir string,
+	stats *runStats) (written int, err error) {
+	if jobs < 1 {
+		jobs = 1
+	}
+	runDir, err := os.MkdirTemp(tmpDir, "txtmaker-sort-")
+	if err != nil {
+		return 0, err
+	}
+	defer os.RemoveAll(runDir)
+
+	pl := startPipeline(r, jobs, stats)
+
+	// 后台写顺串，同一时间最多一个
+	var runs []string
+	spillDone := make(chan error, 1)
+	spilling := false
+	waitSpill := func() {
+		if spilling {
+			if e := <-spillDone; e != nil && err == nil {
+				err = e
+			}
+			spilling = false
+		}
+	}
+
+	var lines []string
+	var size int64
+	for b := range pl.converted {
+		if err == nil {
+			for _, line := range b.items {
+				lines = append(lines, line)
+				size += int64(len(line)) + lineOverhead
+				if size < memBudget/2 {
+					continue
+				}
+				waitSpill()
+				path := filepath.Join(runDir, fmt.Sprintf("run%06d", len(runs)))
+				runs = append(runs, path)
+				spilling = true
+				go func(lines []string) { spillDone <- writeRun(path, lines, stats) }(lines)
+				lines, size = nil, 0
+			}
+		}
+		pl.release()
+	}
+	waitSpill()
+	if err == nil {
+		err = pl.readErr
+	}
+	if err != nil {
+		return 0, err
+	}
+
+	bw := bufio.NewWriterSize(w, 1<<20)
+	defer func() { stats.phrases.Add(int64(written)) }()
+
+	// 没有写过顺串时直接在内存中排序
+	if len(runs) == 0 {
+		start := time.Now()
+		sort.Strings(lines)
+		stats.since(stageSort, start)
+		start = time.Now()
+		written, err = writeUnique(bw, lines)
+		if err == nil {
+			err = bw.Flush()
+		}
+		stats.since(stageWrite, start)
+		return written, err
+	}
+
+	if len(lines) > 0 {
+		path := filepath.Join(runDir, fmt.Sprintf("run%06d", len(runs)))
+		runs = append(runs, path)
+		if err := writeRun(path, lines, stats); err != nil {
+			return 0, err
+		}
+		lines = nil
+	}
+
+	// 顺串过多时先分组合并（写顺串和中间轮归并计入排序，最后一轮归并计入写出）
+	for round := 0; len(runs) > maxMergeFanIn; round++ {
+		var next []string
+		for i := 0; i < len(runs); i += maxMergeFanIn {
+			group := runs[i:min(i+maxMergeFanIn, len(runs))]
+			path := filepath.Join(runDir, fmt.Sprintf("merge%02d_%06d", round, len(next)))
+			start := time.Now()
+			err := mergeRunsToFile(group, path)
+			stats.since(stageSort, start)
+			if err != nil {
+				return 0, err
+			}
+			for _, p := range group {
+				os.Remove(p)
+			}
+			next = append(next, path)
+		}
+		runs = next
+	}
+
+	start := time.Now()
+	written, err = mergeRuns(runs, bw)
+	if err == nil {
+		err = bw.Flush()
+	}
+	stats.since(stageWrite, start)
+	return written, err
+}
+
+// 写出已排序行中不重复的行
+func writeUnique(w *bufio.Writer, lines []string) (int, error) {
+	written := 0
+	for i, line := range lines {
+		if i > 0 && line == lines[i-1] {
+			continue
+		}
+		if _, err := w.WriteString(line); err != nil {
+			return written, err
+		}
+		if err := w.WriteByte('\n'); err != nil {
+			return written, err
+		}
+		written++
+	}
+	return written, nil
+}
+
+// 排序、去重后写出一个顺串
+func writeRun(path string, lines []string, stats *runStats) error {
+	start := time.Now()
+	defer stats.since(stageSort, start)
+	sort.Strings(lines)
+	f, err := os.Create(path)
+	if err != nil {
+		return err
+	}
+	bw := bufio.NewWriterSize(f, 1<<20)
+	if _, err := writeUnique(bw, lines); err != nil {
+		f.Close()
+		return err
+	}
+	if err := bw.Flush(); err != nil {
+		f.Close()
+		return err
+	}
+	return f.Close()
+}
+
+func mergeRunsToFile(runs []string, path string) error {
+	f, err := os.Create(path)
+	if err != nil {
+		return err
+	}
+	bw := bufio.NewWriterSize(f, 1<<20)
+	if _, err := mergeRuns(runs, bw); err != nil {
+		f.Close()
+		return err
+	}
+	if err := bw.Flush(); err != nil {
+		f.Close()
+		return err
+	}
+	return f.Close()
+}
+
+// 归并中的一个顺串：当前行（不含换行符）和读取器
+type runCursor struct {
+	line   string
+	reader *bufio.Reader
+}
+
+type runHeap []*runCursor
+
+func (h runHeap) Len() int           { return len(h) }
+func (h runHeap) Less(i, j int) bool { return h[i].line < h[j].line }
+func (h runHeap) Swap(i, j int)      { h[i], h[j] = h[j], h[i] }
+func (h *runHeap) Push(x any)        { *h = append(*h, x.(*runCursor)) }
+func (h *runHeap) Pop() any {
+	old := *h
+	c := old[len(old)-1]
+	*h = old[:len(old)-1]
+	return c
+}
+
+// 读取顺串的下一行，读完时返回 false
+func (c *runCursor) advance() (bool, error) {
+	line, err := c.reader.ReadString('\n')
+	if err == io.EOF && line == "" {
+		return false, nil
+	}
+	if err != nil && err != io.EOF {
+		return false, err
+	}
+	c.line = line[:len(line)-1]
+	return true, nil
+}
+
+// 多路归并已排序的顺串，相同的行只写出一次
+func mergeRuns(runs []string, w *bufio.Writer) (written int, err error) {
+	h := make(runHeap, 0, len(runs))
+	for _, path := range runs {
+		f, err := os.Open(path)
+		if err != nil {
+			return 0, err
+		}
+		defer f.Close()
+		c := &runCursor{reader: bufio.NewReaderSize(f, mergeReadBuffer)}
+		ok, err := c.advance()
+		if err != nil {
+			return 0, err
+		}
+		if ok {
+			h = append(h, c)
+		}
+	}
+	heap.Init(&h)
+
+	last, first := "", true
+	for h.Len() > 0 {
+		c := h[0]
+		if first || c.line != last {
+			if _, err := w.WriteString(c.line); err != nil {
+				return written, err
+			}
+			if err := w.WriteByte('\n'); err != nil {
+				return written, err
+			}
+			last, first = c.line, false
+			written++
+		}
+		ok, err := c.advance()
+		if err != nil {
+			return written, err
+		}
+		if ok {
+			heap.Fix(&h, 0)
+		} else {
+			heap.Pop(&h)
+		}
+	}
+	return written, nil
+}
@@ -0,0 +1,50 @@
+package main
+
+import (
+	"bytes"
+	"fmt"
+	"sort"
+	"strings"
+	"testing"
+)
+
+func TestSortedPipeline(t *testing.T) {
+	var input strings.Builder
+	for i := 0; i < 20000; i++ {
+		fmt.Fprintf(&input, "%c%c，%c%c%c\n", rune(0x4e00+i%700), rune(0x4e00+i%13), rune(0x4e00+i%977), rune(0x4e01+i%5), rune(0x4e00+i%31))
+	}
+
+	// 期望：全部转换结果去重后按字节排序
+	seen := map[string]struct{}{}
+	var want []string
+	for _, line := range strings.Split(input.String(), "\n") {
+		for _, p := range extractChinesePhrases(line) {
+			s := convertToPinyin(p)
+			if _, ok := seen[s]; !ok {
+				seen[s] = struct{}{}
+				want = append(want, s)
+			}
+		}
+	}
+	sort.Strings(want)
+	wantText := strings.Join(want, "\n") + "\n"
+
+	// 预算从足够大（不写临时文件）到很小（大量顺串、多轮归并）
+	for _, budget := range []int64{1 << 30, 256 << 10, 16 << 10} {
+		var out bytes.Buffer
+		n, err := runSortedPipeline(strings.NewReader(input.String()), &out, 4, budget, t.TempDir(), new(runStats))
+		if err != nil {
+			t.Fatal(err)
+		}
+		if out.String() != wantText || n != len(want) {
+			t.Errorf("budget=%d: 输出与期望不同（%d 行，期望 %d 行）", budget, n, len(want))
+		}
+	}
+
+	// 音节序列是前缀的排在前面
+	lines := []string{"'ai'guo 爱国", "'a'ba 阿爸", "'a 啊", "'a'ba 阿爹"}
+	sort.Strings(lines)
+	if strings.Join(lines, "|") != "'a 啊|'a'ba 阿爸|'a'ba 阿爹|'ai'guo 爱国" {
+		t.Errorf("排序结果不是音节顺序: %v", lines)
+	}
+}
@@ -0,0 +1,226 @@
+package main
+
+import (
+	"bufio"
+	"bytes"
+	"encoding/binary"
+	"errors"
+	"io"
+	"os"
+	"sort"
+	"strings"
+)
+
+// 覆盖规则编译后的最长匹配字典树
+//
+// 节点按层序存放在几个平行数组中：节点 n 的子节点为 first[n] .. first[n]+count[n]-1，
+// 按 label 升序排列，查找子节点用二分。匹配时从短语的每个位置沿树向下走，
+// 记录经过的最后一个规则结尾，代价只与短语长度和最长规则长度有关，与规则数量无关。
+type overrideTrie struct {
+	labels []rune   // 进入节点 n 的字符（根节点不用）
+	first  []uint32 // 第一个子节点
+	count  []uint32 // 子节点数
+	value  []int32  // 规则下标，-1 表示不是规则结尾
+	rules  [][]string
+}
+
+// 缓存文件：魔数、源文件大小和修改时间，之后为各数组
+var overrideCacheMagic = [8]byte{'S', 'C', 'D', 'O', 'V', 'R', '0', '1'}
+
+// 由覆盖规则构建字典树
+func compileOverrides(dict map[string]string) *overrideTrie {
+	// 先建普通的指针树，再按层序展开为数组
+	type buildNode struct {
+		children map[rune]*buildNode
+		value    int32
+	}
+	newNode := func() *buildNode { return &buildNode{children: map[rune]*buildNode{}, value: -1} }
+
+	// 按 key 排序，保证同一份规则编译出的结果相同
+	keys := make([]string, 0, len(dict))
+	for k := range dict {
+		if k != "" {
+			keys = append(keys, k)
+		}
+	}
+	sort.Strings(keys)
+
+	t := &overrideTrie{}
+	root := newNode()
+	for _, k := range keys {
+		n := root
+		for _, r := range k {
+			child, ok := n.children[r]
+			if !ok {
+				child = newNode()
+				n.children[r] = child
+			}
+			n = child
+		}
+		n.value = int32(len(t.rules))
+		t.rules = append(t.rules, strings.Fields(dict[k]))
+	}
+
+	queue := []*buildNode{root}
+	t.labels = append(t.labels, 0)
+	for i := 0; i < len(queue); i++ {
+		n := queue[i]
+		runes := make([]rune, 0, len(n.children))
+		for r := range n.children {
+			runes = append(runes, r)
+		}
+		sort.Slice(runes, func(a, b int) bool { return runes[a] < runes[b] })
+
+		t.first = append(t.first, uint32(len(queue)))
+		t.count = append(t.count, uint32(len(runes)))
+		t.value = append(t.value, n.value)
+		for _, r := range runes {
+			queue = append(queue, n.children[r])
+			t.labels = append(t.labels, r)
+		}
+	}
+	return t
+}
+
+// 查找节点 n 下字符为 r 的子节点，不存在时返回 -1
+func (t *overrideTrie) child(n int, r rune) int {
+	lo, hi := int(t.first[n]), int(t.first[n]+t.count[n])
+	for lo < hi {
+		mid := int(uint(lo+hi) >> 1)
+		if t.labels[mid] < r {
+			lo = mid + 1
+		} else {
+			hi = mid
+		}
+	}
+	if lo < int(t.first[n]+t.count[n]) && t.labels[lo] == r {
+		return lo
+	}
+	return -1
+}
+
+// 从 runes[i] 开始做最长匹配，返回匹配的字符数和对应的拼音；没有匹配时长度为 0
+func (t *overrideTrie) longestMatch(runes []rune, i int) (int, []string) {
+	if t == nil || len(t.first) == 0 {
+		return 0, nil
+	}
+	matchLen, rule := 0, int32(-1)
+	n := 0
+	for j := i; j < len(runes); j++ {
+		n = t.child(n, runes[j])
+		if n < 0 {
+			break
+		}
+		if t.value[n] >= 0 {
+			matchLen, rule = j-i+1, t.value[n]
+		}
+	}
+	if matchLen == 0 {
+		return 0, nil
+	}
+	return matchLen, t.rules[rule]
+}
+
+// 写出缓存文件（先写临时文件再改名，避免留下半个文件）
+func (t *overrideTrie) save(path string, srcSize, srcModTime int64) error {
+	var buf bytes.Buffer
+	buf.Write(overrideCacheMagic[:])
+	le := binary.LittleEndian
+	_ = binary.Write(&buf, le, srcSize)
+	_ = binary.Write(&buf, le, srcModTime)
+	_ = binary.Write(&buf, le, uint32(len(t.first)))
+	_ = binary.Write(&buf, le, t.labels)
+	_ = binary.Write(&buf, le, t.first)
+	_ = binary.Write(&buf, le, t.count)
+	_ = binary.Write(&buf, le, t.value)
+	_ = binary.Write(&buf, le, uint32(len(t.rules)))
+	for _, pys := range t.rules {
+		s := strings.Join(pys, " ")
+		_ = binary.Write(&buf, le, uint32(len(s)))
+		buf.WriteString(s)
+	}
+
+	tmp := path + ".tmp"
+	if err := os.WriteFile(tmp, buf.Bytes(), 0644); err != nil {
+		return err
+	}
+	return os.Rename(tmp, path)
+}
+
+// 读取缓存文件，源文件大小或修改时间不一致时返回错误
+func loadOverrideCache(path string, srcSize, srcModTime int64) (*overrideTrie, error) {
+	data, err := os.ReadFile(path)
+	if err != nil {
+		return nil, err
+	}
+	r := bytes.NewReader(data)
+	le := binary.LittleEndian
+
+	var magic [8]byte
+	var size, modTime int64
+	var nodeCount uint32
+	if _, err := io.ReadFull(r, magic[:]); err != nil || magic != overrideCacheMagic {
+		return nil, errors.New("缓存格式不符")
+	}
+	if binary.Read(r, le, &size) != nil || binary.Read(r, le, &modTime) != nil ||
+		size != srcSize || modTime != srcModTime {
+		return nil, errors.New("缓存已过期")
+	}
+	if err := binary.Read(r, le, &nodeCount); err != nil || int64(nodeCount)*16 > int64(r.Len()) {
+		return nil, errors.New("缓存已损坏")
+	}
+
+	t := &overrideTrie{
+		labels: make([]rune, nodeCount),
+		first:  make([]uint32, nodeCount),
+		count:  make([]uint32, nodeCount),
+		value:  make([]int32, nodeCount),
+	}
+	for _, v := range []any{t.labels, t.first, t.count, t.value} {
+		if err := binary.Read(r, le, v); err != nil {
+			return nil, errors.New("缓存已损坏")
+		}
+	}
+
+	var ruleCount uint32
+	if err := binary.Read(r, le, &ruleCount); err != nil || int64(ruleCount)*4 > int64(r.Len()) {
+		return nil, errors.New("缓存已损坏")
+	}
+	t.rules = make([][]string, ruleCount)
+	for i := range t.rules {
+		var n uint32
+		if err := binary.Read(r, le, &n); err != nil || int64(n) > int64(r.Len()) {
+			return nil, errors.New("缓存已损坏")
+		}
+		s := make([]byte, n)
+		_, _ = io.ReadFull(r, s)
+		t.rules[i] = strings.Fields(string(s))
+	}
+
+	// 校验下标，避免损坏的缓存在匹配时越界
+	for n := range t.first {
+		if uint64(t.first[n])+uint64(t.count[n]) > uint64(nodeCount) || t.value[n] >= int32(ruleCount) {
+			return nil, errors.New("缓存已损坏")
+		}
+	}
+	return t, nil
+}
+
+// 解析覆盖规则文件（每行 词=拼音，# 开头为注释）
+func parseOverrides(r io.Reader) map[string]string {
+	dict := map[string]string{}
+	scanner := bufio.NewScanner(r)
+	for scanner.Scan() {
+		line := strings.TrimSpace(scanner.Text())
+		if line == "" || strings.HasPrefix(line, "#") {
+			continue
+		}
+		parts := strings.SplitN(line, "=", 2)
+		if len(parts) == 2 {
+			key := strings.TrimSpace(parts[0])
+			val := strings.TrimSpace(parts[1])
+			dict[key] = val
+		}
+	}
+	return dict
+}
@@ -0,0 +1,56 @@
+package main
+
+import (
+	"path/filepath"
+	"strings"
+	"testing"
+)
+
+// 与旧实现相同的逐规则扫描，用作对照
+func naiveLongestMatch(dict map[string]string, runes []rune, i int) (int, []string) {
+	best := 0
+	var pys []string
+	for k, v := range dict {
+		kr := []rune(k)
+		if len(kr) > best && i+len(kr) <= len(runes) && string(runes[i:i+len(kr)]) == k {
+			best, pys = len(kr), strings.Fields(v)
+		}
+	}
+	return best, pys
+}
+
+func TestOverrideTrie(t *testing.T) {
+	rules := "# 注释\n会计=kuai ji\n会计师=kuai ji shi\n柏临河=bo lin he\n柏=bai\n长=zhang\n长大=zhang da\n=bad\n"
+	dict := parseOverrides(strings.NewReader(rules))
+	trie := compileOverrides(dict)
+
+	cacheFile := filepath.Join(t.TempDir(), "override.cache")
+	if err := trie.save(cacheFile, 1, 2); err != nil {
+		t.Fatal(err)
+	}
+	if _, err := loadOverrideCache(cacheFile, 1, 3); err == nil {
+		t.Fatal("修改时间不同时不应使用缓存")
+	}
+	cached, err := loadOverrideCache(cacheFile, 1, 2)
+	if err != nil {
+		t.Fatal(err)
+	}
+
+	for _, phrase := range []string{"会计师事务所", "会计学", "柏临河畔的柏树", "长大成人", "无规则", "会"} {
+		runes := []rune(phrase)
+		for i := range runes {
+			wantLen, wantPys := naiveLongestMatch(dict, runes, i)
+			for _, tr := range []*overrideTrie{trie, cached} {
+				gotLen, gotPys := tr.longestMatch(runes, i)
+				if gotLen != wantLen || strings.Join(gotPys, " ") != strings.Join(wantPys, " ") {
+					t.Errorf("%s[%d]: got %d %v, want %d %v", phrase, i, gotLen, gotPys, wantLen, wantPys)
+				}
+			}
+		}
+	}
+
+	var empty *overrideTrie
+	if n, _ := empty.longestMatch([]rune("会计"), 0); n != 0 {
+		t.Errorf("没有覆盖规则时不应匹配")
+	}
+}
@@ -0,0 +1,247 @@
+package main
+
+import (
+	"bufio"
+	"hash/maphash"
+	"io"
+	"sync"
+	"time"
+)
+
+// 每批处理的行数
+const batchLines = 4096
+
+// 一批数据：seq 为批次在输入中的序号，用于恢复原始顺序
+type batch struct {
+	seq   int
+	items []string
+}
+
+// 去重分区收到的一部分词条，keep 中返回是否为首次出现，处理完后通知 done
+type dedupPart struct {
+	lines []string
+	keep  []bool
+	done  chan struct{}
+}
+
+// 等待去重结果的一批词条
+type dedupBatch struct {
+	lines []string
+	index [][]int // 每个分区负责的词条下标
+	parts []*dedupPart
+}
+
+// 流水线的前三个阶段（读取、提取、转拼音），由下游决定如何去重和写出
+type pipeline struct {
+	converted <-chan batch  // 转拼音的结果，按完成顺序（不一定是输入顺序）
+	tokens    chan struct{} // 在途批次的令牌：读取前取得，处理完一批后由下游调用 release 归还
+	readErr   error         // 读取错误，converted 关闭后有效
+	stats     *runStats
+}
+
+func (p *pipeline) release() { <-p.tokens }
+
+// 启动前三个阶段：读取、提取、转拼音；r 输出 UTF-8（见 newDecodingReader）
+func startPipeline(r io.Reader, jobs int, stats *runStats) *pipeline {
+	pl := &pipeline{tokens: make(chan struct{}, jobs*4), stats: stats}
+	tokens := pl.tokens
+
+	// 1. 读取
+	raw := make(chan batch, jobs)
+	go func() {
+		defer close(raw)
+		scanner := bufio.NewScanner(r)
+		scanner.Buffer(make([]byte, 0, 64*1024), 16*1024*1024)
+		seq := 0
+		items := make([]string, 0, batchLines)
+		// 读取计时不含等待下游的时间，也不含 r 中转码的时间（已记入 decode）
+		start := time.Now()
+		decoded := stats.stages[stageDecode].Load()
+		readDone := func() {
+			now := stats.stages[stageDecode].Load()
+			stats.stages[stageRead].Add(int64(time.Since(start)) - (now - decoded))
+			decoded = now
+		}
+		for scanner.Scan() {
+			items = append(items, scanner.Text())
+			if len(items) == batchLines {
+				readDone()
+				stats.lines.Add(batchLines)
+				tokens <- struct{}{}
+				raw <- batch{seq, items}
+				seq++
+				items = make([]string, 0, batchLines)
+				start = time.Now()
+			}
+		}
+		readDone()
+		stats.lines.Add(int64(len(items)))
+		if len(items) > 0 {
+			tokens <- struct{}{}
+			raw <- batch{seq, items}
+		}
+		pl.readErr = scanner.Err()
+	}()
+
+	// 2. 提取中文词条
+	phrases := make(chan batch, jobs)
+	var extractWg sync.WaitGroup
+	for i := 0; i < jobs; i++ {
+		extractWg.Add(1)
+		go func() {
+			defer extractWg.Done()
+			for b := range raw {
+				start := time.Now()
+				var out []string
+				for _, line := range b.items {
+					out = append(out, extractChinesePhrases(line)...)
+				}
+				stats.since(stageExtract, start)
+				phrases <- batch{b.seq, out}
+			}
+		}()
+	}
+	go func() {
+		extractWg.Wait()
+		close(phrases)
+	}()
+
+	// 3. 转拼音
+	converted := make(chan batch, jobs)
+	var convertWg sync.WaitGroup
+	for i := 0; i < jobs; i++ {
+		convertWg.Add(1)
+		go func() {
+			defer convertWg.Done()
+			for b := range phrases {
+				start := time.Now()
+				out := make([]string, len(b.items))
+				for j, p := range b.items {
+					out[j] = convertToPinyin(p)
+				}
+				stats.since(stagePinyin, start)
+				stats.converted.Add(int64(len(out)))
+				converted <- batch{b.seq, out}
+			}
+		}()
+	}
+	go func() {
+		convertWg.Wait()
+		close(converted)
+	}()
+
+	pl.converted = converted
+	return pl
+}
+
+/**
+ * 流水线处理：读取 -> 提取中文 -> 转拼音 -> 去重 -> 按输入顺序写出
+ *
+ * 读取为单个 goroutine，按批发出行（r 已转为 UTF-8）；提取和转拼音各有 jobs 个 worker，
+ * 从共享通道领取批次，慢批次不会拖住其他 worker。转换结果按批次序号重新排序后，
+ * 按哈希拆给 jobs 个去重分区，每个分区独占自己的集合、按批次顺序处理，
+ * 因此“首次出现”与单线程处理时完全相同，输出顺序是确定的。
+ * 同时在途的批次数有上限，内存只随去重集合增长。
+ */
+func runPipeline(r io.Reader, w io.Writer, jobs int, stats *runStats) (written int, err error) {
+	if jobs < 1 {
+		jobs = 1
+	}
+	pl := startPipeline(r, jobs, stats)
+
+	// 4. 按批次序号排序后拆给去重分区
+	seed := maphash.MakeSeed()
+	partIn := make([]chan *dedupPart, jobs)
+	for p := range partIn {
+		partIn[p] = make(chan *dedupPart, jobs)
+		go func(in chan *dedupPart) {
+			seen := map[string]struct{}{}
+			for part := range in {
+				start := time.Now()
+				for j, line := range part.lines {
+					if _, ok := seen[line]; !ok {
+						seen[line] = struct{}{}
+						part.keep[j] = true
+					}
+				}
+				stats.since(stageDedup, start)
+				part.done <- struct{}{}
+			}
+		}(partIn[p])
+	}
+
+	ordered := make(chan *dedupBatch, jobs)
+	go func() {
+		defer close(ordered)
+		defer func() {
+			for _, in := range partIn {
+				close(in)
+			}
+		}()
+		pending := map[int][]string{}
+		next := 0
+		for b := range pl.converted {
+			pending[b.seq] = b.items
+			for {
+				lines, ok := pending[next]
+				if !ok {
+					break
+				}
+				delete(pending, next)
+				next++
+
+				db := &dedupBatch{lines: lines, index: make([][]int, jobs), parts: make([]*dedupPart, jobs)}
+				for j, line := range lines {
+					p := int(maphash.String(seed, line) % uint64(jobs))
+					db.index[p] = append(db.index[p], j)
+				}
+				for p := 0; p < jobs; p++ {
+					part := &dedupPart{
+						lines: make([]string, len(db.index[p])),
+						keep:  make([]bool, len(db.index[p])),
+						done:  make(chan struct{}, 1),
+					}
+					for k, j := range db.index[p] {
+						part.lines[k] = lines[j]
+					}
+					db.parts[p] = part
+					partIn[p] <- part
+				}
+				ordered <- db
+			}
+		}
+	}()
+
+	// 5. 汇总各分区结果，按原始顺序写出
+	bw := bufio.NewWriterSize(w, 1<<20)
+	for db := range ordered {
+		keep := make([]bool, len(db.lines))
+		for p, part := range db.parts {
+			<-part.done
+			for k, j := range db.index[p] {
+				keep[j] = part.keep[k]
+			}
+		}
+		start := time.Now()
+		for j, line := range db.lines {
+			if keep[j] && err == nil {
+				if _, err = bw.WriteString(line + "\n"); err == nil {
+					written++
+				}
+			}
+		}
+		stats.since(stageWrite, start)
+		pl.release()
+	}
+
+	if err == nil {
+		start := time.Now()
+		err = bw.Flush()
+		stats.since(stageWrite, start)
+	}
+	stats.phrases.Add(int64(written))
+	if err == nil {
+		err = pl.readErr
+	}
+	return written, err
+}
@@ -0,0 +1,88 @@
+package main
+
+import (
+	"bytes"
+	"fmt"
+	"io"
+	"math/rand"
+	"runtime"
+	"strings"
+	"testing"
+)
+
+// 与旧实现相同的单线程处理，用作对照
+func sequentialConvert(text string) string {
+	var out strings.Builder
+	seen := map[string]struct{}{}
+	for _, line := range strings.Split(text, "\n") {
+		for _, p := range extractChinesePhrases(line) {
+			s := convertToPinyin(p)
+			if _, ok := seen[s]; !ok {
+				seen[s] = struct{}{}
+				out.WriteString(s + "\n")
+			}
+		}
+	}
+	return out.String()
+}
+
+func TestPipelineOrder(t *testing.T) {
+	// 足够多的行，跨越多个批次，并且有大量跨批次的重复
+	words := []string{"会计", "柏临河", "长大", "银行", "重庆", "音乐", "快乐", "行长"}
+	var input strings.Builder
+	for i := 0; i < batchLines*5+123; i++ {
+		fmt.Fprintf(&input, "%s，%s abc %s\n", words[i%len(words)], words[(i*7+3)%len(words)], words[i%3]+words[i%5])
+	}
+	want := sequentialConvert(input.String())
+
+	for _, jobs := range []int{1, 2, 8} {
+		var out bytes.Buffer
+		n, err := runPipeline(strings.NewReader(input.String()), &out, jobs, new(runStats))
+		if err != nil {
+			t.Fatal(err)
+		}
+		if out.String() != want {
+			t.Errorf("jobs=%d: 输出顺序或内容与单线程处理不同", jobs)
+		}
+		if n != strings.Count(want, "\n") {
+			t.Errorf("jobs=%d: 词条数 %d", jobs, n)
+		}
+	}
+}
+
+// 固定种子生成 n 行中文短文本（每行 8 个 2~4 字的词），与 scd_bench --txtmaker 的输入形式相同
+func syntheticText(n int, seed int64) string {
+	rng := rand.New(rand.NewSource(seed))
+	var sb strings.Builder
+	for i := 0; i < n; i++ {
+		for k := 0; k < 8; k++ {
+			for c := 2 + rng.Intn(3); c > 0; c-- {
+				sb.WriteRune(rune(0x4E00 + rng.Intn(0x9FA5-0x4E00+1)))
+			}
+			if k < 7 {
+				sb.WriteString("，")
+			}
+		}
+		sb.WriteString("。\n")
+	}
+	return sb.String()
+}
+
+// go test -bench RunPipeline -benchmem
+func BenchmarkRunPipeline(b *testing.B) {
+	input := syntheticText(20000, 20240501)
+	jobsList := []int{1}
+	if n := runtime.NumCPU(); n > 1 {
+		jobsList = append(jobsList, n)
+	}
+	for _, jobs := range jobsList {
+		b.Run(fmt.Sprintf("jobs=%d", jobs), func(b *testing.B) {
+			b.SetBytes(int64(len(input)))
+			for i := 0; i < b.N; i++ {
+				if _, err := runPipeline(strings.NewReader(input), io.Discard, jobs, new(runStats)); err != nil {
+					b.Fatal(err)
+				}
+			}
+		})
+	}
+}
@@ -0,0 +1,104 @@
+package main
+
+import (
+	"bytes"
+	"errors"
+	"io"
+	"strconv"
+	"sync/atomic"
+	"time"
+)
+
+/**
+ * 转换进度与取消
+ *
+ * 流水线的读取阶段经过 progressReader：每次读入累加字节数，cancel 关闭后返回 errCanceled，
+ * 读取 goroutine 随之结束，下游各阶段排空后 processFile 删除临时文件并返回 errCanceled。
+ * 每行不做任何额外工作，计数按读块（bufio.Scanner 的读块，或转码时的 1 MB 块）进行。
+ *
+ * 进度行与 scdviewer --progress 结构相同（SCDProgress），-progress 时每 100 毫秒输出到标准错误：
+ *   {"progress":{"phase":"convert","done":1024,"total":4096,"entries":100,"etaMs":300}}
+ * done / total 为输入文件的字节数，entries 为已转拼音的词条数（去重前）。
+ */
+
+var errCanceled = errors.New("已取消")
+
+// 进度上报的间隔（测试中调小）
+var progressInterval = 100 * time.Millisecond
+
+type progressReader struct {
+	r      io.Reader
+	n      atomic.Int64
+	cancel <-chan struct{} // nil 时永不取消
+}
+
+func (p *progressReader) Read(b []byte) (int, error) {
+	select {
+	case <-p.cancel:
+		return 0, errCanceled
+	default:
+	}
+	n, err := p.r.Read(b)
+	p.n.Add(int64(n))
+	return n, err
+}
+
+// 一次进度：阶段名、已读字节、总字节、词条数、预计剩余毫秒（无法估计时为 -1）
+type progressInfo struct {
+	phase   string
+	done    int64
+	total   int64
+	entries int64
+	etaMs   int64
+}
+
+// 按开始至今的平均速度估计剩余时间
+func estimate(done, total int64, elapsed time.Duration) int64 {
+	if done <= 0 || total <= 0 {
+		return -1
+	}
+	return int64(float64(elapsed.Milliseconds()) / float64(done) * float64(max(total-done, 0)))
+}
+
+func (p progressInfo) json() []byte {
+	var b bytes.Buffer
+	b.WriteString(`{"progress":{"phase":`)
+	b.WriteString(strconv.Quote(p.phase))
+	b.WriteString(`,"done":`)
+	b.WriteString(strconv.FormatInt(p.done, 10))
+	b.WriteString(`,"total":`)
+	b.WriteString(strconv.FormatInt(p.total, 10))
+	b.WriteString(`,"entries":`)
+	b.WriteString(strconv.FormatInt(p.entries, 10))
+	b.WriteString(`,"etaMs":`)
+	b.WriteString(strconv.FormatInt(p.etaMs, 10))
+	b.WriteString("}}")
+	return b.Bytes()
+}
+
+// 每隔 progressInterval 调用一次 report，直到 stop 关闭；返回的通道在最后一次上报后关闭
+func reportProgress(pr *progressReader, total int64, sorted bool, stats *runStats,
+	report func(progressInfo), stop <-chan struct{}) <-chan struct{} {
+	finished := make(chan struct{})
+	begin := time.Now()
+	go func() {
+		defer close(finished)
+		ticker := time.NewTicker(progressInterval)
+		defer ticker.Stop()
+		for {
+			select {
+			case <-stop:
+				return
+			case <-ticker.C:
+			}
+			info := progressInfo{phase: "convert", done: pr.n.Load(), total: total, entries: stats.converted.Load()}
+			info.etaMs = estimate(info.done, total, time.Since(begin))
+			// 输入读完后排序模式还要合并顺串，剩余时间未知
+			if sorted && info.done >= total {
+				info.phase, info.etaMs = "sort", -1
+			}
+			report(info)
+		}
+	}()
+	return finished
+}
@@ -0,0 +1,33 @@
+package main
+
+import (
+	"errors"
+	"io"
+	"strings"
+	"testing"
+	"time"
+)
+
+func TestProgressReader(t *testing.T) {
+	cancel := make(chan struct{})
+	pr := &progressReader{r: strings.NewReader(strings.Repeat("x", 1000)), cancel: cancel}
+	buf := make([]byte, 300)
+	if n, err := pr.Read(buf); n != 300 || err != nil || pr.n.Load() != 300 {
+		t.Fatalf("读入 %d 字节，累计 %d，错误 %v", n, pr.n.Load(), err)
+	}
+	close(cancel)
+	if _, err := io.ReadAll(pr); !errors.Is(err, errCanceled) {
+		t.Errorf("取消后应返回 errCanceled，实际 %v", err)
+	}
+}
+
+func TestProgressJSON(t *testing.T) {
+	p := progressInfo{phase: "convert", done: 25, total: 100, entries: 7, etaMs: estimate(25, 100, 300*time.Millisecond)}
+	want := `{"progress":{"phase":"convert","done":25,"total":100,"entries":7,"etaMs":900}}`
+	if got := string(p.json()); got != want {
+		t.Errorf("得到 %s，应为 %s", got, want)
+	}
+	if estimate(0, 100, time.Second) != -1 || estimate(10, 0, time.Second) != -1 {
+		t.Errorf("无法估计时应返回 -1")
+	}
+}
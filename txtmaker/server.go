@@ -0,0 +1,168 @@
+package main
+
+import (
+	"bufio"
+	"encoding/binary"
+	"errors"
+	"fmt"
+	"io"
+	"net"
+	"os"
+	"runtime"
+	"sync"
+	"time"
+)
+
+/**
+ * 常驻任务服务：txtmaker -serve <套接字路径>
+ *
+ * 图形界面启动一次，之后的转换都通过 Unix 域套接字发给同一个进程，拼音库和覆盖规则只在启动时加载
+ * （override.txt 改动后下一个任务开始前重新加载）。每个连接一个任务，多个连接同时处理。
+ * 开始监听后在标准输出打印一行 ready；标准输入关闭（父进程退出）时删除套接字并退出。
+ *
+ * 帧格式（小端）：uint32 长度（不含自身），之后是长度个字节的内容。
+ *   请求：uint8 操作（1 = 转换）、uint8 标志（bit0 排序，bit1 上报进度）、uint16 保留、uint32 内存预算 MB、
+ *         uint32 并发数（0 为核心数）、UTF-8 输入文件路径（帧内剩余部分）
+ *   响应：若干帧，每帧 uint8 类型 + 内容：1 输出文本、2 错误文本、3 统计 JSON（与 -stats=json 相同）、
+ *         4 结束（int32 退出码，之后服务端关闭连接）、5 进度 JSON（与 -progress 相同，每 100 毫秒一帧）
+ * 请求之后客户端不再发送数据；再发送任何字节或关闭连接即取消任务，服务端删除临时文件后回复结束帧。
+ */
+
+const (
+	opConvert byte = 1
+
+	flagSort     byte = 1 << 0
+	flagProgress byte = 1 << 1
+
+	frameOutput   byte = 1
+	frameError    byte = 2
+	frameStats    byte = 3
+	frameDone     byte = 4
+	frameProgress byte = 5
+
+	requestHeaderSize = 12
+	maxRequestSize    = 64 * 1024
+)
+
+// 监听 socketPath 并处理请求，直到标准输入关闭
+func runServer(socketPath string) error {
+	// 上次异常退出可能留下套接字文件
+	os.Remove(socketPath)
+	ln, err := net.Listen("unix", socketPath)
+	if err != nil {
+		return err
+	}
+	defer os.Remove(socketPath)
+
+	go func() {
+		io.Copy(io.Discard, os.Stdin)
+		ln.Close()
+	}()
+	fmt.Println("ready")
+	return serve(ln)
+}
+
+// 接受连接，每个连接一个 goroutine，直到 ln 关闭
+func serve(ln net.Listener) error {
+	for {
+		conn, err := ln.Accept()
+		if err != nil {
+			if errors.Is(err, net.ErrClosed) {
+				return nil
+			}
+			return err
+		}
+		go serveConn(conn)
+	}
+}
+
+// 一个连接上的响应帧，输出文本和结束帧可能来自不同 goroutine
+type frameWriter struct {
+	mu sync.Mutex
+	w  *bufio.Writer
+}
+
+func (f *frameWriter) frame(kind byte, payload []byte) error {
+	f.mu.Lock()
+	defer f.mu.Unlock()
+	var head [5]byte
+	binary.LittleEndian.PutUint32(head[:4], uint32(len(payload)+1))
+	head[4] = kind
+	f.w.Write(head[:])
+	f.w.Write(payload)
+	return f.w.Flush()
+}
+
+// 作为 processFile 的 out：每次写入发一个输出帧
+func (f *frameWriter) Write(p []byte) (int, error) {
+	if err := f.frame(frameOutput, p); err != nil {
+		return 0, err
+	}
+	return len(p), nil
+}
+
+func serveConn(conn net.Conn) {
+	defer conn.Close()
+	fw := &frameWriter{w: bufio.NewWriter(conn)}
+	done := func(code int32) {
+		var b [4]byte
+		binary.LittleEndian.PutUint32(b[:], uint32(code))
+		fw.frame(frameDone, b[:])
+	}
+
+	var size [4]byte
+	if _, err := io.ReadFull(conn, size[:]); err != nil {
+		return
+	}
+	n := binary.LittleEndian.Uint32(size[:])
+	if n < requestHeaderSize || n > maxRequestSize {
+		fw.frame(frameError, []byte("非法的请求"))
+		done(1)
+		return
+	}
+	req := make([]byte, n)
+	if _, err := io.ReadFull(conn, req); err != nil {
+		return
+	}
+	if req[0] != opConvert {
+		fw.frame(frameError, []byte(fmt.Sprintf("不支持的操作: %d", req[0])))
+		done(1)
+		return
+	}
+
+	job := convertJob{
+		inputPath: string(req[requestHeaderSize:]),
+		jobs:      int(binary.LittleEndian.Uint32(req[8:12])),
+	}
+	if job.jobs <= 0 {
+		job.jobs = runtime.NumCPU()
+	}
+	if req[1]&flagSort != 0 {
+		job.sortMB = max(int(binary.LittleEndian.Uint32(req[4:8])), 16)
+	}
+	if req[1]&flagProgress != 0 {
+		job.progress = func(p progressInfo) {
+			fw.frame(frameProgress, p.json())
+		}
+	}
+
+	// 请求之后连接上再有数据或对端关闭即为取消；任务结束时本函数关闭连接，这里的读取随之返回
+	cancel := make(chan struct{})
+	go func() {
+		var b [1]byte
+		conn.Read(b[:])
+		close(cancel)
+	}()
+	job.cancel = cancel
+
+	loadOverrides()
+	begin := time.Now()
+	var stats runStats
+	if _, err := processFile(job, fw, &stats); err != nil {
+		fw.frame(frameError, []byte(err.Error()+"\n"))
+		done(1)
+		return
+	}
+	fw.frame(frameStats, stats.json("txtmaker", time.Since(begin)))
+	done(0)
+}
@@ -0,0 +1,154 @@
+package main
+
+import (
+	"bytes"
+	"encoding/binary"
+	"fmt"
+	"io"
+	"net"
+	"os"
+	"path/filepath"
+	"strings"
+	"testing"
+	"time"
+)
+
+// 发送一个请求（cancel 时紧接着发一个字节取消任务），返回各类型响应帧的内容（同类型的帧拼接起来）和退出码；
+// 不调用 t.Fatal，可以在其他 goroutine 中使用
+func request(socketPath string, op, flags byte, path string, cancel bool) (map[byte]string, int32, error) {
+	conn, err := net.Dial("unix", socketPath)
+	if err != nil {
+		return nil, 0, err
+	}
+	defer conn.Close()
+
+	req := make([]byte, 4+requestHeaderSize, 4+requestHeaderSize+len(path))
+	binary.LittleEndian.PutUint32(req[0:4], uint32(requestHeaderSize+len(path)))
+	req[4], req[5] = op, flags
+	binary.LittleEndian.PutUint32(req[8:12], 64)
+	binary.LittleEndian.PutUint32(req[12:16], 2)
+	req = append(req, path...)
+	if cancel {
+		req = append(req, 0)
+	}
+	if _, err := conn.Write(req); err != nil {
+		return nil, 0, err
+	}
+
+	frames := map[byte]string{}
+	for {
+		var size [4]byte
+		if _, err := io.ReadFull(conn, size[:]); err != nil {
+			return nil, 0, fmt.Errorf("没有收到结束帧: %w", err)
+		}
+		body := make([]byte, binary.LittleEndian.Uint32(size[:]))
+		if _, err := io.ReadFull(conn, body); err != nil {
+			return nil, 0, err
+		}
+		if body[0] == frameDone {
+			return frames, int32(binary.LittleEndian.Uint32(body[1:])), nil
+		}
+		frames[body[0]] += string(body[1:])
+	}
+}
+
+func TestServer(t *testing.T) {
+	dir := t.TempDir()
+	socketPath := filepath.Join(dir, "txtmaker.sock")
+	ln, err := net.Listen("unix", socketPath)
+	if err != nil {
+		t.Skip("不支持 Unix 域套接字:", err)
+	}
+	defer ln.Close()
+	go serve(ln)
+
+	input := strings.Repeat("银行行长，重庆音乐\n快乐 银行\n", 3000)
+	inputPath := filepath.Join(dir, "in.txt")
+	if err := os.WriteFile(inputPath, []byte(input), 0644); err != nil {
+		t.Fatal(err)
+	}
+	var want bytes.Buffer
+	if _, err := runPipeline(strings.NewReader(input), &want, 2, new(runStats)); err != nil {
+		t.Fatal(err)
+	}
+
+	// 同时处理多个任务；请求出错时通过 results 交回测试 goroutine 报告
+	results := make(chan error, 4)
+	for i := 0; i < 4; i++ {
+		go func() {
+			frames, code, err := request(socketPath, opConvert, 0, inputPath, false)
+			if err != nil {
+				results <- err
+				return
+			}
+			if code != 0 || !strings.Contains(frames[frameOutput], "转换完成") {
+				t.Errorf("退出码 %d，输出 %q，错误 %q", code, frames[frameOutput], frames[frameError])
+			}
+			if !strings.HasPrefix(frames[frameStats], `{"tool":"txtmaker"`) {
+				t.Errorf("统计帧 %q", frames[frameStats])
+			}
+			results <- nil
+		}()
+	}
+	for i := 0; i < 4; i++ {
+		if err := <-results; err != nil {
+			t.Error(err)
+		}
+	}
+	got, err := os.ReadFile(filepath.Join(dir, "in_sg.txt"))
+	if err != nil || string(got) != want.String() {
+		t.Errorf("输出文件与 runPipeline 不同")
+	}
+
+	if frames, code, err := request(socketPath, opConvert, 0, filepath.Join(dir, "missing.txt"), false); err != nil {
+		t.Error(err)
+	} else if code == 0 || frames[frameError] == "" {
+		t.Errorf("文件不存在时应返回错误")
+	}
+	if _, code, err := request(socketPath, 9, 0, inputPath, false); err != nil {
+		t.Error(err)
+	} else if code == 0 {
+		t.Errorf("未知操作应返回错误")
+	}
+}
+
+func TestServerProgressCancel(t *testing.T) {
+	dir := t.TempDir()
+	socketPath := filepath.Join(dir, "txtmaker.sock")
+	ln, err := net.Listen("unix", socketPath)
+	if err != nil {
+		t.Skip("不支持 Unix 域套接字:", err)
+	}
+	defer ln.Close()
+	go serve(ln)
+
+	defer func(interval time.Duration) { progressInterval = interval }(progressInterval)
+	progressInterval = time.Millisecond
+
+	inputPath := filepath.Join(dir, "in.txt")
+	input := strings.Repeat("银行行长，重庆音乐\n快乐 银行\n", 100000)
+	if err := os.WriteFile(inputPath, []byte(input), 0644); err != nil {
+		t.Fatal(err)
+	}
+
+	frames, code, err := request(socketPath, opConvert, flagProgress, inputPath, false)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if code != 0 || !strings.HasPrefix(frames[frameProgress], `{"progress":{"phase":"convert"`) {
+		t.Errorf("退出码 %d，进度帧 %.80q", code, frames[frameProgress])
+	}
+
+	// 取消后不留下输出文件和临时文件
+	os.Remove(filepath.Join(dir, "in_sg.txt"))
+	frames, code, err = request(socketPath, opConvert, flagSort|flagProgress, inputPath, true)
+	if err != nil {
+		t.Fatal(err)
+	}
+	if code == 0 || !strings.Contains(frames[frameError], errCanceled.Error()) {
+		t.Errorf("取消后退出码 %d，错误 %q", code, frames[frameError])
+	}
+	if left, _ := filepath.Glob(filepath.Join(dir, "in_sg*")); len(left) != 0 {
+		t.Errorf("取消后留下了文件: %v", left)
+	}
+}
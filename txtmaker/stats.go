@@ -0,0 +1,89 @@
+package main
+
+import (
+	"bytes"
+	"strconv"
+	"sync/atomic"
+	"time"
+)
+
+// 统计的阶段，顺序即输出顺序
+type stage int
+
+const (
+	stageDetect stage = iota
+	stageRead
+	stageDecode
+	stageExtract
+	stagePinyin
+	stageDedup
+	stageSort
+	stageWrite
+	stageCount
+)
+
+var stageNames = [stageCount]string{"detect", "read", "decode", "extract", "pinyin", "dedup", "sort", "write"}
+
+/**
+ * 各阶段耗时和计数，-stats=json 时以一行 JSON 输出到标准错误，结构与 scdviewer --stats=json 相同：
+ *   {"tool":"txtmaker","totalMs":12.3,"stages":[{"name":"read","ms":1.2},...],"counters":{"lines":100,...}}
+ * 解码在读取 goroutine 中按块进行，read 不含 decode 的时间。
+ * 提取、转拼音、去重由多个 worker 并行，记录的是各 worker 的累计耗时，总和可以超过 totalMs。
+ * 按批次计时，不在每行上调用 time.Now。每个任务一份（常驻服务中多个任务可同时进行）。
+ */
+type runStats struct {
+	stages    [stageCount]atomic.Int64 // 纳秒
+	lines     atomic.Int64
+	converted atomic.Int64 // 转拼音的词条数（去重前）
+	phrases   atomic.Int64 // 写出的词条数
+	bytesIn   atomic.Int64
+	bytesOut  atomic.Int64
+}
+
+// 把 start 至今的时间计入阶段 s
+func (s *runStats) since(st stage, start time.Time) {
+	s.stages[st].Add(int64(time.Since(start)))
+}
+
+// 单行 JSON；没有耗时的阶段（如不排序时的 sort）不输出
+func (s *runStats) json(tool string, total time.Duration) []byte {
+	var b bytes.Buffer
+	b.WriteString(`{"tool":`)
+	b.WriteString(strconv.Quote(tool))
+	b.WriteString(`,"totalMs":`)
+	b.WriteString(strconv.FormatFloat(float64(total)/1e6, 'f', 3, 64))
+	b.WriteString(`,"stages":[`)
+	n := 0
+	for i := range s.stages {
+		ns := s.stages[i].Load()
+		if ns == 0 {
+			continue
+		}
+		if n > 0 {
+			b.WriteByte(',')
+		}
+		n++
+		b.WriteString(`{"name":"` + stageNames[i] + `","ms":`)
+		b.WriteString(strconv.FormatFloat(float64(ns)/1e6, 'f', 3, 64))
+		b.WriteByte('}')
+	}
+	counters := []struct {
+		name  string
+		value int64
+	}{
+		{"lines", s.lines.Load()},
+		{"phrases", s.phrases.Load()},
+		{"duplicates", s.converted.Load() - s.phrases.Load()},
+		{"bytesIn", s.bytesIn.Load()},
+		{"bytesOut", s.bytesOut.Load()},
+	}
+	b.WriteString(`],"counters":{`)
+	for i, c := range counters {
+		if i > 0 {
+			b.WriteByte(',')
+		}
+		b.WriteString(`"` + c.name + `":` + strconv.FormatInt(c.value, 10))
+	}
+	b.WriteString("}}")
+	return b.Bytes()
+}
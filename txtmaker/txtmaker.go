@@ -1,18 +1,24 @@
 package main
 
 import (
-	"bufio"
 	"bytes"
+	"errors"
+	"flag"
 	"fmt"
 	"io"
 	"os"
+	"os/signal"
 	"path/filepath"
 	"regexp"
-	"sort"
+	"runtime"
+	"runtime/debug"
 	"strings"
+	"sync"
+	"sync/atomic"
+	"syscall"
+	"time"
 	"unicode/utf8"
 	
-	"github.com/axgle/mahonia"
 	"github.com/mozillazg/go-pinyin"
 	"github.com/saintfish/chardet"
 )
@@ -20,12 +26,25 @@ import (
 var (
 	// 匹配所有中文
 	chineseRegex = regexp.MustCompile(`[\p{Han}]+`)
-	// 存储覆盖规则
-	overrideDict = map[string]string{}
+	// 编译后的覆盖规则；常驻服务中规则文件变化时整体替换
+	overrides atomic.Pointer[overrideTrie]
+	// 当前规则对应的 override.txt 大小和修改时间，loadOverrides 据此判断是否需要重新加载
+	overridesMu    sync.Mutex
+	overridesStamp [2]int64
+	// go-pinyin 的参数，所有短语共用
+	pinyinArgs = func() pinyin.Args {
+		a := pinyin.NewArgs()
+		a.Style = pinyin.Normal
+		a.Heteronym = false
+		return a
+	}()
 )
 
-// 加载覆盖拼音规则
+// 加载覆盖拼音规则；规则文件与上次加载时相同则什么也不做
 func loadOverrides() {
+	overridesMu.Lock()
+	defer overridesMu.Unlock()
+
 	home, _ := os.UserHomeDir()
 	configDir := filepath.Join(home, ".config", "scdtool")
 	overrideFile := filepath.Join(configDir, "override.txt")
@@ -39,66 +58,71 @@ func loadOverrides() {
 		_ = os.WriteFile(overrideFile, []byte(example), 0644)
 	}
 
-	f, err := os.Open(overrideFile)
+	st, err := os.Stat(overrideFile)
 	if err != nil {
 		return
 	}
-	defer f.Close()
+	stamp := [2]int64{st.Size(), st.ModTime().UnixNano()}
+	if overrides.Load() != nil && stamp == overridesStamp {
+		return
+	}
 
-	scanner := bufio.NewScanner(f)
-	for scanner.Scan() {
-		line := strings.TrimSpace(scanner.Text())
-		if line == "" || strings.HasPrefix(line, "#") {
-			continue
-		}
-		parts := strings.SplitN(line, "=", 2)
-		if len(parts) == 2 {
-			key := strings.TrimSpace(parts[0])
-			val := strings.TrimSpace(parts[1])
-			overrideDict[key] = val
-		}
+	// 规则文件未变化时直接读取编译好的缓存
+	cacheFile := filepath.Join(configDir, "override.cache")
+	if t, err := loadOverrideCache(cacheFile, st.Size(), st.ModTime().UnixNano()); err == nil {
+		overrides.Store(t)
+		overridesStamp = stamp
+		return
 	}
-}
 
-// 检测文件编码 (优化版)
-func detectEncoding(filePath string, sampleSize int) string {
-	f, err := os.Open(filePath)
+	f, err := os.Open(overrideFile)
 	if err != nil {
-		fmt.Printf("无法打开文件: %v\n", err)
-		os.Exit(1)
+		return
 	}
 	defer f.Close()
 
-	// 读取样本数据，但这次我们不限制只读 sampleSize
-	// 因为 utf8.ValidString 需要完整的数据才能最准确
-	// 我们限制一个合理的上限，例如 512KB
-	const readLimit = 512 * 1024
-	r := io.LimitReader(f, readLimit)
-	buf, err := io.ReadAll(r)
-	if err != nil {
-		fmt.Printf("读取文件样本失败: %v\n", err)
-		os.Exit(1)
-	}
+	t := compileOverrides(parseOverrides(f))
+	_ = t.save(cacheFile, st.Size(), st.ModTime().UnixNano())
+	overrides.Store(t)
+	overridesStamp = stamp
+}
 
+// 检测编码 (优化版)，buf 为文件开头的一块（newDecodingReader 读入），检测过程写到 out
+func detectEncoding(buf []byte, sampleSize int, out io.Writer) (string, error) {
 	// 1. 优先检测BOM (Byte Order Mark)
 	// 这是最准确的编码判断依据
-	if bytes.HasPrefix(buf, []byte{0xEF, 0xBB, 0xBF}) {
-		fmt.Println("检测到UTF-8 BOM")
-		return "UTF-8"
+	if bytes.HasPrefix(buf, utf8BOM) {
+		fmt.Fprintln(out, "检测到UTF-8 BOM")
+		return "UTF-8", nil
 	}
-	// 可以根据需要添加UTF-16等其他BOM的检测
-	// if bytes.HasPrefix(buf, []byte{0xFF, 0xFE}) { return "UTF-16LE" }
-	// if bytes.HasPrefix(buf, []byte{0xFE, 0xFF}) { return "UTF-16BE" }
-	
+	if bytes.HasPrefix(buf, []byte{0xFF, 0xFE}) {
+		fmt.Fprintln(out, "检测到UTF-16LE BOM")
+		return "UTF-16LE", nil
+	}
+	if bytes.HasPrefix(buf, []byte{0xFE, 0xFF}) {
+		fmt.Fprintln(out, "检测到UTF-16BE BOM")
+		return "UTF-16BE", nil
+	}
+
 	// 2. 快速验证是否为合法的UTF-8
 	// 对于纯ASCII或标准的UTF-8文件，这个检查非常快且100%准确
-	if utf8.Valid(buf) {
-		fmt.Println("检测为合法的无BOM UTF-8")
-		return "UTF-8"
+	// 样本可能截断在字符中间，末尾不完整的字符不参与验证
+	valid := buf
+	for k := 1; k <= 3 && k <= len(valid); k++ {
+		if c := valid[len(valid)-k]; utf8.RuneStart(c) {
+			if !utf8.FullRune(valid[len(valid)-k:]) {
+				valid = valid[:len(valid)-k]
+			}
+			break
+		}
+	}
+	if utf8.Valid(valid) {
+		fmt.Fprintln(out, "检测为合法的无BOM UTF-8")
+		return "UTF-8", nil
 	}
 
 	// 3. 如果不是UTF-8，再使用 chardet 进行统计学猜测
-	fmt.Println("非UTF-8编码，尝试使用 chardet 进行检测...")
+	fmt.Fprintln(out, "非UTF-8编码，尝试使用 chardet 进行检测...")
 	detector := chardet.NewTextDetector()
 	// 使用部分样本进行检测，避免样本过大影响性能
 	detectSample := buf
@@ -107,25 +131,24 @@ func detectEncoding(filePath string, sampleSize int) string {
 	}
 	result, err := detector.DetectBest(detectSample)
 	if err != nil {
-		fmt.Printf("检测编码失败: %v\n", err)
-		os.Exit(1) // or return a default encoding
+		return "", fmt.Errorf("检测编码失败: %v", err)
 	}
 
 	encoding := strings.ToUpper(result.Charset)
-	fmt.Printf("Chardet检测到输入文件编码：%s\n", encoding)
+	fmt.Fprintf(out, "Chardet检测到输入文件编码：%s\n", encoding)
 
 	// 针对中文环境的常见编码进行修正
 	switch encoding {
-	case "GB2312", "GBK", "HZ-GB-2312": // GBK系列统一使用GB18030解码
-		return "GB18030"
+	case "GB2312", "GBK", "GB-18030", "HZ-GB-2312": // GBK系列统一使用GB18030解码
+		return "GB18030", nil
 	case "EUC-KR", "SHIFT_JIS": // 对于韩文和日文的误判，强制认为是GB18030
-		fmt.Println("检测结果为日韩编码，在中文环境下，强制使用 GB18030 解码")
-		return "GB18030"
+		fmt.Fprintln(out, "检测结果为日韩编码，在中文环境下，强制使用 GB18030 解码")
+		return "GB18030", nil
 	case "BIG5": // 如果需要支持繁体中文
-		return "BIG5"
+		return "BIG5", nil
 	default:
 		// 对于其他未知的编码，可以返回一个默认值或 chardet 的结果
-		return encoding
+		return encoding, nil
 	}
 }
 
@@ -143,57 +166,24 @@ func extractChinesePhrases(text string) []string {
 
 // 转换为拼音
 func convertToPinyin(phrase string) string {
-	// 1. 准备和排序覆盖规则的 key，按长度倒序，确保优先匹配长词
-	keys := make([]string, 0, len(overrideDict))
-	for k := range overrideDict {
-		keys = append(keys, k)
-	}
-	sort.Slice(keys, func(i, j int) bool {
-		return len([]rune(keys[i])) > len([]rune(keys[j]))
-	})
-
-	// 准备 go-pinyin 的参数
-	a := pinyin.NewArgs()
-	a.Style = pinyin.Normal
-	a.Heteronym = false
-
-	// --- 全新的扫描匹配逻辑 ---
 	var resultPinyins []string
 	phraseRunes := []rune(phrase)
+	rules := overrides.Load()
 	// i 是当前在 phrase 中的扫描位置（按 rune 索引）
 	for i := 0; i < len(phraseRunes); {
-		// 检查从当前位置 i 开始，是否能匹配任何一个覆盖规则
-		matched := false
-		for _, key := range keys {
-			keyRunes := []rune(key)
-			// 如果剩余词条的长度足够匹配当前 key
-			if i+len(keyRunes) <= len(phraseRunes) {
-				// 提取子串进行比较
-				subPhrase := string(phraseRunes[i : i+len(keyRunes)])
-				if subPhrase == key {
-					// 匹配成功！
-					pys := strings.Fields(overrideDict[key])
-					resultPinyins = append(resultPinyins, pys...)
-					// 将扫描位置向后移动匹配到的 key 的长度
-					i += len(keyRunes)
-					matched = true
-					// 已经找到了最长的匹配（因为 keys 是排序过的），跳出内层循环
-					break
-				}
-			}
+		// 优先使用从当前位置开始最长的覆盖规则
+		if n, pys := rules.longestMatch(phraseRunes, i); n > 0 {
+			resultPinyins = append(resultPinyins, pys...)
+			i += n
+			continue
 		}
 
-		// 如果在当前位置 i，所有覆盖规则都未匹配成功
-		if !matched {
-			// 只处理当前单个字符
-			char := string(phraseRunes[i])
-			pys := pinyin.Pinyin(char, a)
-			if len(pys) > 0 && len(pys[0]) > 0 {
-				resultPinyins = append(resultPinyins, pys[0][0])
-			}
-			// 将扫描位置向后移动 1
-			i++
+		// 没有覆盖规则时只处理当前单个字符
+		pys := pinyin.Pinyin(string(phraseRunes[i]), pinyinArgs)
+		if len(pys) > 0 && len(pys[0]) > 0 {
+			resultPinyins = append(resultPinyins, pys[0][0])
 		}
+		i++
 	}
 
 	// 格式化最终输出
@@ -203,80 +193,166 @@ func convertToPinyin(phrase string) string {
 	return strings.Join(resultPinyins, "") + " " + phrase
 }
 
-// 处理文件
-func processFile(inputPath string) {
-	base := strings.TrimSuffix(inputPath, filepath.Ext(inputPath))
+// 一次转换任务：命令行运行时只有一个，常驻服务中每个请求一个
+type convertJob struct {
+	inputPath string
+	jobs      int // 流水线各阶段的并发数
+	sortMB    int // > 0 时按拼音排序，内存预算为 sortMB 兆字节
+
+	cancel   <-chan struct{}    // 关闭时取消任务，nil 表示不可取消
+	progress func(progressInfo) // 不为 nil 时转换期间每 100 毫秒调用一次（在另一个 goroutine 中）
+}
+
+/**
+ * 处理文件，检测和结果信息写到 out，各阶段耗时和计数记入 stats；返回写出的词条数。
+ * 失败时返回的错误已带说明，不退出进程（常驻服务中还有其他任务）；取消时返回 errCanceled，不留下输出文件。
+ */
+func processFile(job convertJob, out io.Writer, stats *runStats) (int, error) {
+	begin := time.Now()
+	base := strings.TrimSuffix(job.inputPath, filepath.Ext(job.inputPath))
 	outputPath := base + "_sg.txt"
 
-	encoding := detectEncoding(inputPath, 10000)
-	decoder := mahonia.NewDecoder(encoding)
-	if decoder == nil {
-		fmt.Printf("不支持的编码: %s\n", encoding)
-		os.Exit(1)
+	if _, err := os.Stat(job.inputPath); os.IsNotExist(err) {
+		return 0, fmt.Errorf("错误：文件不存在：%s", job.inputPath)
 	}
-
-	file, err := os.Open(inputPath)
+	file, err := os.Open(job.inputPath)
 	if err != nil {
-		fmt.Printf("读取文件失败: %v\n", err)
-		os.Exit(1)
+		return 0, fmt.Errorf("读取文件失败: %v", err)
 	}
 	defer file.Close()
 
-	resultLines := []string{}
-	uniqueLines := map[string]struct{}{}
-
-	scanner := bufio.NewScanner(file)
-	lineNo := 0
-	for scanner.Scan() {
-		lineNo++
-		line := strings.TrimSpace(decoder.ConvertString(scanner.Text()))
-		if line == "" {
-			continue
-		}
-		phrases := extractChinesePhrases(line)
-		for _, p := range phrases {
-			out := convertToPinyin(p)
-			// fmt.Printf("第 %d 行中文词条: %s -> %s\n", lineNo, p, out) // 调试信息
-			if _, exists := uniqueLines[out]; !exists {
-				uniqueLines[out] = struct{}{}
-				resultLines = append(resultLines, out)
-			}
+	// 只打开一次：检测编码用的第一块也是转码的第一块，进度按原始字节计
+	input := &progressReader{r: file, cancel: job.cancel}
+	decoded, _, err := newDecodingReader(input, 10000, out, stats)
+	if err != nil {
+		if errors.Is(err, errCanceled) {
+			return 0, errCanceled
 		}
+		return 0, err
 	}
+	stats.since(stageDetect, begin)
 
-	if err := scanner.Err(); err != nil {
-		fmt.Printf("读取文件失败: %v\n", err)
-		os.Exit(1)
+	// 先写临时文件，全部成功后再改名，失败时不留下半个输出文件；
+	// 临时文件名各不相同，常驻服务中同一输入的多个任务互不干扰
+	outFile, err := os.CreateTemp(filepath.Dir(outputPath), filepath.Base(outputPath)+".*.tmp")
+	if err != nil {
+		return 0, fmt.Errorf("写入文件失败: %v", err)
 	}
+	tmpPath := outFile.Name()
 
-	outFile, err := os.Create(outputPath)
-	if err != nil {
-		fmt.Printf("写入文件失败: %v\n", err)
-		os.Exit(1)
+	if job.progress != nil {
+		var total int64
+		if info, err := file.Stat(); err == nil {
+			total = info.Size()
+		}
+		stop := make(chan struct{})
+		finished := reportProgress(input, total, job.sortMB > 0, stats, job.progress, stop)
+		defer func() {
+			close(stop)
+			<-finished
+		}()
 	}
-	defer outFile.Close()
 
-	writer := bufio.NewWriter(outFile)
-	for _, line := range resultLines {
-		writer.WriteString(line + "\n")
+	var count int
+	if job.sortMB > 0 {
+		budget := int64(job.sortMB) << 20
+		count, err = runSortedPipeline(decoded, outFile, job.jobs, budget, filepath.Dir(outputPath), stats)
+	} else {
+		count, err = runPipeline(decoded, outFile, job.jobs, stats)
+	}
+	if closeErr := outFile.Close(); err == nil {
+		err = closeErr
+	}
+	if err == nil {
+		// CreateTemp 建的文件只有属主可读写，改回普通输出文件的权限
+		err = os.Chmod(tmpPath, 0644)
+	}
+	if err == nil {
+		err = os.Rename(tmpPath, outputPath)
 	}
-	writer.Flush()
+	if err != nil {
+		os.Remove(tmpPath)
+		if errors.Is(err, errCanceled) {
+			return 0, errCanceled
+		}
+		return 0, fmt.Errorf("处理文件失败: %v", err)
+	}
+
+	fmt.Fprintf(out, "转换完成，输出文件：%s\n", outputPath)
+	fmt.Fprintf(out, "处理词条数量：%d\n", count)
 
-	fmt.Printf("转换完成，输出文件：%s\n", outputPath)
-	fmt.Printf("处理词条数量：%d\n", len(resultLines))
+	if info, err := os.Stat(job.inputPath); err == nil {
+		stats.bytesIn.Store(info.Size())
+	}
+	if info, err := os.Stat(outputPath); err == nil {
+		stats.bytesOut.Store(info.Size())
+	}
+	return count, nil
 }
 
 func main() {
+	jobs := flag.Int("j", runtime.NumCPU(), "并发数（读取之后各阶段的 worker 数和去重分区数）")
+	sortOutput := flag.Bool("sort", false, "按拼音排序输出（外部排序，内存占用不超过 -mem）")
+	memMB := flag.Int("mem", 512, "排序时的内存预算（MB）")
+	statsFormat := flag.String("stats", "", "完成后在标准错误输出各阶段耗时和计数（格式目前只有 json）")
+	printProgress := flag.Bool("progress", false, "转换期间每 100 毫秒在标准错误输出一行进度 JSON")
+	serve := flag.String("serve", "", "作为常驻任务服务运行，在该 Unix 域套接字上接收转换请求（标准输入关闭时退出）")
+	flag.Usage = func() {
+		fmt.Println("用法：txtmaker [-j 并发数] [-sort [-mem MB]] [-stats=json] [-progress] 输入文件.txt")
+		fmt.Println("      txtmaker -serve 套接字路径")
+		flag.PrintDefaults()
+	}
+	flag.Parse()
+
 	loadOverrides()
 
-	if len(os.Args) != 2 {
-		fmt.Println("用法：txtmaker 输入文件.txt")
+	if *serve != "" {
+		if err := runServer(*serve); err != nil {
+			fmt.Printf("任务服务启动失败: %v\n", err)
+			os.Exit(1)
+		}
+		return
+	}
+
+	if flag.NArg() != 1 {
+		flag.Usage()
 		os.Exit(1)
 	}
-	inputFile := os.Args[1]
-	if _, err := os.Stat(inputFile); os.IsNotExist(err) {
-		fmt.Printf("错误：文件不存在：%s\n", inputFile)
+	if *statsFormat != "" && *statsFormat != "json" {
+		fmt.Printf("不支持的统计格式: %s\n", *statsFormat)
 		os.Exit(1)
 	}
-	processFile(inputFile)
+	job := convertJob{inputPath: flag.Arg(0), jobs: *jobs}
+	if *sortOutput {
+		job.sortMB = max(*memMB, 16)
+		// 让 GC 按预算回收，峰值内存不随输入增长
+		debug.SetMemoryLimit(int64(job.sortMB)<<20 + 64<<20)
+	}
+
+	if *printProgress {
+		job.progress = func(p progressInfo) {
+			os.Stderr.Write(append(p.json(), '\n'))
+		}
+	}
+
+	// 第一次 Ctrl+C / SIGTERM 取消任务并删除临时文件，之后恢复默认处理
+	signals := make(chan os.Signal, 1)
+	signal.Notify(signals, os.Interrupt, syscall.SIGTERM)
+	cancel := make(chan struct{})
+	go func() {
+		<-signals
+		signal.Stop(signals)
+		close(cancel)
+	}()
+	job.cancel = cancel
+
+	begin := time.Now()
+	var stats runStats
+	if _, err := processFile(job, os.Stdout, &stats); err != nil {
+		fmt.Println(err)
+		os.Exit(1)
+	}
+	if *statsFormat == "json" {
+		fmt.Fprintf(os.Stderr, "%s\n", stats.json("txtmaker", time.Since(begin)))
+	}
 }